@@ -1,25 +1,28 @@
 #ifndef MARKETDATAEVENT_H
 #define MARKETDATAEVENT_H
 
+#include <string>
 #include <vector>
 #include <cstdint>
 #include <chrono>
 #include "Order.h"
+#include "include/InlineVector.h"
+#include "include/InstrumentRegistry.h"
 
 struct OrderLevel {
-    double price;
+    Price price;
     int size;
     uint64_t order_id;
     std::chrono::system_clock::time_point timestamp;
 
     // Constructor
-    OrderLevel(double p, int s, uint64_t id, std::chrono::system_clock::time_point ts)
+    OrderLevel(Price p, int s, uint64_t id, std::chrono::system_clock::time_point ts)
         : price(p), size(s), order_id(id), timestamp(ts) {}
 };
 
 struct Trade {
     Side aggressor_side;
-    double price;
+    Price price;
     int size;
     uint64_t trade_id;
     std::chrono::system_clock::time_point timestamp;
@@ -27,23 +30,35 @@ struct Trade {
 
 struct PartialFillEvent {
     uint64_t order_id;
-    double price;
+    Price price;
     int filled_size;
     int remaining_size;
     std::chrono::system_clock::time_point timestamp;
 };
 
+// Inline capacities cover what the simulator publishes per event (5 levels a
+// side, at most one trade and its maker fills); replayed or external events
+// that exceed them spill to the heap.
+constexpr std::size_t kInlineBookLevels = 8;
+constexpr std::size_t kInlineTrades = 4;
+constexpr std::size_t kInlineFills = 8;
+
+using LevelList = InlineVector<OrderLevel, kInlineBookLevels>;
+using TradeList = InlineVector<Trade, kInlineTrades>;
+using PartialFillList = InlineVector<PartialFillEvent, kInlineFills>;
+using FillList = InlineVector<FillEvent, kInlineFills>;
+
 struct MarketDataEvent {
-    std::string instrument;
-    double best_bid_price;
-    double best_ask_price;
+    InstrumentId instrument_id = kNoInstrument;  // name via InstrumentRegistry::global()
+    Price best_bid_price;
+    Price best_ask_price;
     int best_bid_size;
     int best_ask_size;
-    std::vector<OrderLevel> bid_levels;
-    std::vector<OrderLevel> ask_levels;
-    std::vector<Trade> trades;
-    std::vector<PartialFillEvent> partial_fills;
-    std::vector<FillEvent> mm_fills;
+    LevelList bid_levels;
+    LevelList ask_levels;
+    TradeList trades;
+    PartialFillList partial_fills;
+    FillList mm_fills;
     std::chrono::system_clock::time_point timestamp;
     int64_t sequence_number;
 };
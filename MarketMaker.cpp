@@ -6,6 +6,12 @@
 #include <algorithm>
 #include <cmath>
 
+namespace {
+// Packed ID tags; the top 16 bits say who issued an id
+constexpr uint64_t kOrderTagMask = 0xFFFFULL << 48;
+constexpr uint64_t kMmOrderTag = 1ULL << 48;
+} // namespace
+
 MarketMaker::MarketMaker()
     : strategy_(std::make_unique<HeuristicStrategy>()) {
     last_quote_time = std::chrono::system_clock::now();
@@ -16,8 +22,9 @@ MarketMaker::MarketMaker(const RiskConfig& cfg)
     last_quote_time = std::chrono::system_clock::now();
 }
 
-MarketMaker::MarketMaker(const RiskConfig& cfg, std::unique_ptr<Strategy> strategy)
-    : risk_manager_(cfg), strategy_(std::move(strategy)) {
+MarketMaker::MarketMaker(const RiskConfig& cfg, std::unique_ptr<Strategy> strategy,
+                         const RequoteConfig& requote_cfg)
+    : risk_manager_(cfg), strategy_(std::move(strategy)), requote_cfg_(requote_cfg) {
     last_quote_time = std::chrono::system_clock::now();
 }
 
@@ -28,21 +35,24 @@ void MarketMaker::on_market_data(const MarketDataEvent& md, MarketSimulator& sim
                   << " events\n";
     }
     last_processed_sequence = md.sequence_number;
+    instrument_id_ = md.instrument_id;
 
     if (md.bid_levels.empty() || md.ask_levels.empty()) {
         std::cout << "WARNING: Empty order book detected, skipping quote update\n";
         return;
     }
 
-    // Process fill events for our resting orders
+    // Process fill events for our orders. With simulated order latency a fill
+    // can land on an order whose cancel is still in flight, so match on the id
+    // tag rather than on active_orders.
     for (const auto& fill : md.mm_fills) {
-        if (active_orders.count(fill.order_id)) {
+        if (is_own_order(fill.order_id)) {
             on_fill(fill);
         }
     }
 
     // Mark-to-market on each market data event
-    double mid_price = (md.best_bid_price + md.best_ask_price) / 2.0;
+    double mid_price = (from_ticks(md.best_bid_price) + from_ticks(md.best_ask_price)) / 2.0;
     accounting_.mark_to_market(mid_price);
 
     risk_manager_.evaluate(accounting_, md, mid_price);
@@ -63,7 +73,7 @@ void MarketMaker::on_fill(const FillEvent& fill) {
     ++total_fills;
 
     // Delegate to accounting (MM resting orders are maker fills)
-    accounting_.on_fill(fill.side, fill.price, fill.fill_qty, /*is_maker=*/true);
+    accounting_.on_fill(fill.side, from_ticks(fill.price), fill.fill_qty, /*is_maker=*/true);
 
     // Update or remove active order
     auto it = active_orders.find(fill.order_id);
@@ -78,7 +88,7 @@ void MarketMaker::on_fill(const FillEvent& fill) {
 
     std::cout << "FILL: " << (fill.side == Side::BUY ? "BUY" : "SELL")
               << " " << fill.fill_qty << " @ " << std::fixed << std::setprecision(4)
-              << fill.price << " (leaves=" << fill.leaves_qty
+              << from_ticks(fill.price) << " (leaves=" << fill.leaves_qty
               << ") pos=" << accounting_.position()
               << " cash=" << std::setprecision(2) << accounting_.cash()
               << " realized=" << accounting_.realized_pnl()
@@ -86,23 +96,92 @@ void MarketMaker::on_fill(const FillEvent& fill) {
 }
 
 void MarketMaker::cancel_all_orders(MarketSimulator& simulator, std::chrono::system_clock::time_point now) {
-    for (auto it = active_orders.begin(); it != active_orders.end(); ) {
-        risk_manager_.record_cancel(now);
-        simulator.cancel_order(it->first);
-        it = active_orders.erase(it);
+    for (const auto& entry : active_orders) {
+        pending_cancels_.push_back(entry.first);
     }
+    baseline_order_messages_ += static_cast<int64_t>(active_orders.size());
+    active_orders.clear();
+    bid_order_id_ = 0;
+    ask_order_id_ = 0;
+    flush_order_batches(simulator, now);
 }
 
-void MarketMaker::update_quotes(const MarketDataEvent& md, MarketSimulator& simulator) {
-    // Cancel stale orders before placing new ones
-    cancel_all_orders(simulator, md.timestamp);
+void MarketMaker::flush_order_batches(MarketSimulator& simulator, std::chrono::system_clock::time_point now) {
+    // Cancels go first so a cancel + new on one side never has both resting
+    if (!pending_cancels_.empty()) {
+        batch_statuses_.resize(pending_cancels_.size());
+        simulator.cancel_orders(pending_cancels_, batch_statuses_);
+        risk_manager_.record_cancel(now, pending_cancels_.size());
+        order_messages_ += static_cast<int64_t>(pending_cancels_.size());
+        pending_cancels_.clear();
+    }
+
+    if (!pending_orders_.empty()) {
+        batch_statuses_.resize(pending_orders_.size());
+        simulator.submit_orders(pending_orders_, batch_statuses_);
+        std::size_t accepted = 0;
+        for (std::size_t i = 0; i < pending_orders_.size(); ++i) {
+            if (!is_live_status(batch_statuses_[i])) {
+                continue;
+            }
+            Order& order = pending_orders_[i];
+            order.status = batch_statuses_[i];
+            active_orders.emplace(order.order_id, order);
+            (order.side == Side::BUY ? bid_order_id_ : ask_order_id_) = order.order_id;
+            ++accepted;
+        }
+        risk_manager_.record_quote(now, accepted);
+        order_messages_ += static_cast<int64_t>(pending_orders_.size());
+        pending_orders_.clear();
+    }
+}
 
-    double best_bid = md.bid_levels[0].price;
-    double best_ask = md.ask_levels[0].price;
+void MarketMaker::requote_side(Side side, uint64_t& order_id, Price price, int qty,
+                               std::chrono::system_clock::time_point now, MarketSimulator& simulator) {
+    auto it = active_orders.find(order_id);
+    const Order* live = (it != active_orders.end()) ? &it->second : nullptr;
+
+    switch (decide_requote(live, price, qty, now, requote_cfg_)) {
+        case RequoteAction::None:
+            return;
+        case RequoteAction::Amend:
+            // The amend is a message whether or not the engine takes it
+            ++order_messages_;
+            risk_manager_.record_replace(now);
+            if (is_live_status(simulator.replace_order(order_id, price, qty))) {
+                Order& order = it->second;
+                order.original_qty = (order.original_qty - order.leaves_qty) + qty;
+                order.price = price;
+                order.leaves_qty = qty;
+                order.updated_at = now;
+                return;
+            }
+            // A rejected amend can leave the order resting (e.g. a price off
+            // the tick ladder), so cancel it before sending a fresh one
+            pending_cancels_.push_back(order_id);
+            active_orders.erase(it);
+            break;
+        case RequoteAction::CancelNew:
+            pending_cancels_.push_back(order_id);
+            active_orders.erase(it);
+            break;
+        case RequoteAction::New:
+            break;
+    }
+
+    // Queued for the next batch; order_id is set once the engine acknowledges it
+    order_id = 0;
+    pending_orders_.emplace_back(generate_order_id(), side, price, qty, now);
+    pending_orders_.back().instrument_id = instrument_id_;
+}
+
+void MarketMaker::update_quotes(const MarketDataEvent& md, MarketSimulator& simulator) {
+    double best_bid = from_ticks(md.bid_levels[0].price);
+    double best_ask = from_ticks(md.ask_levels[0].price);
     double mid_price = (best_bid + best_ask) / 2.0;
 
-    // Build snapshot for strategy
-    StrategySnapshot snap;
+    // Build snapshot for strategy; vector assignment reuses existing capacity
+    StrategySnapshot& snap = snapshot_;
     snap.best_bid = best_bid;
     snap.best_ask = best_ask;
     snap.mid_price = mid_price;
@@ -117,6 +196,7 @@ void MarketMaker::update_quotes(const MarketDataEvent& md, MarketSimulator& simu
     QuoteDecision decision = strategy_->compute_quotes(snap);
 
     if (!decision.should_quote) {
+        cancel_all_orders(simulator, md.timestamp);
         return;
     }
 
@@ -125,32 +205,29 @@ void MarketMaker::update_quotes(const MarketDataEvent& md, MarketSimulator& simu
     int bid_size = std::max(cfg.min_quote_size, std::min(decision.bid_size, cfg.max_quote_size));
     int ask_size = std::max(cfg.min_quote_size, std::min(decision.ask_size, cfg.max_quote_size));
 
-    // Submit bid
-    uint64_t bid_id = generate_order_id();
-    Order bid_order(bid_id, Side::BUY, decision.bid_price, bid_size, md.timestamp);
-    if (simulator.submit_order(bid_order) == OrderStatus::ACKNOWLEDGED) {
-        bid_order.status = OrderStatus::ACKNOWLEDGED;
-        active_orders.emplace(bid_id, bid_order);
-        risk_manager_.record_quote(md.timestamp);
-    }
+    // Cancel-all requoting would cancel every live order and submit both sides
+    baseline_order_messages_ += static_cast<int64_t>(active_orders.size()) + 2;
 
-    // Submit ask
-    uint64_t ask_id = generate_order_id();
-    Order ask_order(ask_id, Side::SELL, decision.ask_price, ask_size, md.timestamp);
-    if (simulator.submit_order(ask_order) == OrderStatus::ACKNOWLEDGED) {
-        ask_order.status = OrderStatus::ACKNOWLEDGED;
-        active_orders.emplace(ask_id, ask_order);
-        risk_manager_.record_quote(md.timestamp);
-    }
+    requote_side(Side::BUY, bid_order_id_, to_ticks(decision.bid_price), bid_size, md.timestamp, simulator);
+    requote_side(Side::SELL, ask_order_id_, to_ticks(decision.ask_price), ask_size, md.timestamp, simulator);
+    flush_order_batches(simulator, md.timestamp);
 
     last_quote_time = md.timestamp;
 }
 
 uint64_t MarketMaker::generate_order_id() {
-    constexpr uint64_t kMmOrderTag = 1ULL << 48;
     return kMmOrderTag | static_cast<uint64_t>(++order_counter);
 }
 
+bool MarketMaker::is_own_order(uint64_t order_id) {
+    return (order_id & kOrderTagMask) == kMmOrderTag;
+}
+
+// ACKNOWLEDGED: the engine took it now; NEW: still in flight to the engine
+bool MarketMaker::is_live_status(OrderStatus status) {
+    return status == OrderStatus::ACKNOWLEDGED || status == OrderStatus::NEW;
+}
+
 static const char* risk_state_str(RiskState s) {
     switch (s) {
         case RiskState::Normal: return "Normal";
@@ -167,7 +244,7 @@ void MarketMaker::report() {
         return;
     }
 
-    double mark = (last_bid_price_ + last_ask_price_) / 2.0;
+    double mark = (from_ticks(last_bid_price_) + from_ticks(last_ask_price_)) / 2.0;
     accounting_.mark_to_market(mark);
 
     // Inline skew formula (same as get_inventory_skew)
@@ -195,6 +272,12 @@ void MarketMaker::report() {
     std::cout << "High Water Mark: $" << risk_manager_.high_water_mark() << std::endl;
     std::cout << "Total Fills: " << total_fills << std::endl;
     std::cout << "Active Orders: " << active_orders.size() << std::endl;
+    std::cout << "Order Messages: " << order_messages_
+              << " (cancel-all requoting: " << baseline_order_messages_ << ")" << std::endl;
+    double reduction = baseline_order_messages_ > 0
+        ? 1.0 - static_cast<double>(order_messages_) / static_cast<double>(baseline_order_messages_)
+        : 0.0;
+    std::cout << "Message Reduction: " << reduction * 100.0 << "%" << std::endl;
     std::cout << "Strategy: " << strategy_->name() << std::endl;
     std::cout << "Inventory Skew: " << skew << std::endl;
     std::cout << "============================" << std::endl;
@@ -210,7 +293,7 @@ int MarketMaker::get_inventory() const {
 
 double MarketMaker::get_mark_price() const {
     if (!has_last_event_) return 0.0;
-    return (last_bid_price_ + last_ask_price_) / 2.0;
+    return (from_ticks(last_bid_price_) + from_ticks(last_ask_price_)) / 2.0;
 }
 
 double MarketMaker::get_unrealized_pnl() const {
@@ -229,6 +312,18 @@ int MarketMaker::get_total_fills() const {
     return total_fills;
 }
 
+int64_t MarketMaker::get_order_messages() const {
+    return order_messages_;
+}
+
+int64_t MarketMaker::get_baseline_order_messages() const {
+    return baseline_order_messages_;
+}
+
+std::size_t MarketMaker::get_active_order_count() const {
+    return active_orders.size();
+}
+
 double MarketMaker::get_inventory_skew() const {
     const double skew_factor = 0.001;
     const double max_skew = 0.01;
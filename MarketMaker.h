@@ -4,8 +4,11 @@
 #include "MarketDataEvent.h"
 #include "Order.h"
 #include "include/Accounting.h"
+#include "include/ObjectPool.h"
+#include "include/RequotePolicy.h"
 #include "include/RiskManager.h"
 #include "include/Strategy.h"
+#include <functional>
 #include <unordered_map>
 #include <vector>
 #include <chrono>
@@ -18,7 +21,8 @@ class MarketMaker {
 public:
     MarketMaker();
     explicit MarketMaker(const RiskConfig& cfg);
-    MarketMaker(const RiskConfig& cfg, std::unique_ptr<Strategy> strategy);
+    MarketMaker(const RiskConfig& cfg, std::unique_ptr<Strategy> strategy,
+                const RequoteConfig& requote_cfg = RequoteConfig{});
     void on_market_data(const MarketDataEvent& md, MarketSimulator& simulator);
     void report();
     double get_cash() const;
@@ -28,6 +32,9 @@ public:
     double get_realized_pnl() const;
     double get_total_pnl() const;
     int get_total_fills() const;
+    int64_t get_order_messages() const;
+    int64_t get_baseline_order_messages() const;
+    std::size_t get_active_order_count() const;
     double get_inventory_skew() const;
     double get_fees() const;
     double get_rebates() const;
@@ -41,22 +48,46 @@ public:
     const std::vector<RiskRuleResult>& get_risk_details() const;
 
 private:
-    std::unordered_map<uint64_t, Order> active_orders;
-    double last_bid_price_ = 0.0;
-    double last_ask_price_ = 0.0;
+    using ActiveOrderAllocator = PoolAllocator<std::pair<const uint64_t, Order>>;
+    using ActiveOrderMap = std::unordered_map<uint64_t, Order, std::hash<uint64_t>,
+                                              std::equal_to<uint64_t>, ActiveOrderAllocator>;
+
+    // Pool is declared first so it outlives active_orders
+    FixedBlockPool active_order_pool_{node_block_size<std::pair<const uint64_t, Order>>(),
+                                      alignof(std::max_align_t), 16};
+    ActiveOrderMap active_orders{16, std::hash<uint64_t>{}, std::equal_to<uint64_t>{},
+                                 ActiveOrderAllocator(&active_order_pool_)};
+    StrategySnapshot snapshot_;  // reused across events so level/trade copies keep their capacity
+    Price last_bid_price_ = 0;
+    Price last_ask_price_ = 0;
     bool has_last_event_ = false;
+    InstrumentId instrument_id_ = kNoInstrument;  // stamped on new orders; taken from market data
     Accounting accounting_{100000.0};
     RiskManager risk_manager_;
     std::unique_ptr<Strategy> strategy_;
+    RequoteConfig requote_cfg_;
     std::chrono::system_clock::time_point last_quote_time;
     int64_t last_processed_sequence = 0;
     int order_counter = 0;
+    uint64_t bid_order_id_ = 0;  // working quote per side, amended in place while it rests
+    uint64_t ask_order_id_ = 0;
+    int64_t order_messages_ = 0;           // new + amend + cancel messages actually sent
+    int64_t baseline_order_messages_ = 0;  // what cancel-all + resubmit every event would have sent
+    // Per-event order-entry batches; cleared after each flush so capacity is reused
+    std::vector<Order> pending_orders_;
+    std::vector<uint64_t> pending_cancels_;
+    std::vector<OrderStatus> batch_statuses_;
     int total_fills = 0;
 
     void on_fill(const FillEvent& fill);
     void update_quotes(const MarketDataEvent& md, MarketSimulator& simulator);
     void cancel_all_orders(MarketSimulator& simulator, std::chrono::system_clock::time_point now);
+    void flush_order_batches(MarketSimulator& simulator, std::chrono::system_clock::time_point now);
+    void requote_side(Side side, uint64_t& order_id, Price price, int qty,
+                      std::chrono::system_clock::time_point now, MarketSimulator& simulator);
     uint64_t generate_order_id();
+    static bool is_own_order(uint64_t order_id);
+    static bool is_live_status(OrderStatus status);
 };
 
 #endif
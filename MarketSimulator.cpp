@@ -1,13 +1,8 @@
 #include "MarketSimulator.h"
 #include <algorithm>
 #include <cstdint>
-#include <fstream>
-#include <iomanip>
 #include <iostream>
-#include <limits>
-#include <sstream>
 #include <stdexcept>
-#include <thread>
 #include <utility>
 
 namespace {
@@ -17,81 +12,155 @@ constexpr int64_t kBaseTimestampMs = 1700000000000LL;
 constexpr uint64_t kSimOrderTag  = 2ULL << 48;
 constexpr uint64_t kTradeIdTag   = 3ULL << 48;
 
-std::vector<std::string> split(const std::string& input, char delimiter) {
-    std::vector<std::string> out;
-    std::size_t start = 0;
-    std::size_t pos = input.find(delimiter);
-    while (pos != std::string::npos) {
-        out.push_back(input.substr(start, pos - start));
-        start = pos + 1;
-        pos = input.find(delimiter, start);
+// Synthetic book price jitter; capped further so levels cannot meet
+constexpr double kMaxLevelJitter = 0.001;
+
+// Philox substreams. Each consumer draws from (stream, event index), so the
+// randomness of event n is addressable without replaying events 0..n-1, and
+// a change in how many values one consumer draws never shifts another.
+enum RngStream : uint32_t {
+    kInitStream = 0,
+    kMidStream = 1,
+    kBookStream = 2,
+    kTradeStream = 3,
+    kLatencyStream = 4,
+};
+
+// FNV-1a of the symbol, so instruments sharing a seed get unrelated streams
+uint32_t instrument_key(const std::string& symbol) {
+    uint32_t h = 2166136261u;
+    for (unsigned char ch : symbol) {
+        h = (h ^ ch) * 16777619u;
     }
-    out.push_back(input.substr(start));
-    return out;
-}
-
-int64_t to_millis(const std::chrono::system_clock::time_point& ts) {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(ts.time_since_epoch()).count();
+    return h;
 }
 
 std::chrono::system_clock::time_point from_millis(int64_t ms) {
     return std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
 }
 
-const char* side_to_str(Side s) {
-    return s == Side::BUY ? "BUY" : "SELL";
+// Prefix of the error for an index left over from another log, which points
+// past the end, at the wrong event or into the middle of one
+std::string index_mismatch(const std::string& log_path) {
+    return sequence_index::path_for(log_path) + " does not match the log: ";
 }
 
-Side str_to_side(const std::string& s) {
-    return s == "BUY" ? Side::BUY : Side::SELL;
+// Config of the positional constructor; everything else keeps its default
+SimulationConfig legacy_config(std::string instrument, double initial_price, double spread, double volatility,
+                               int latency_ms) {
+    SimulationConfig cfg;
+    cfg.instrument = std::move(instrument);
+    cfg.initial_price = initial_price;
+    cfg.spread = spread;
+    cfg.volatility = volatility;
+    cfg.latency_ms = latency_ms;
+    return cfg;
 }
+
 } // namespace
 
 MarketSimulator::MarketSimulator(std::string instrument_, double init_price_, double spread_, double volatility_, int latency_ms_)
-    : MarketSimulator(SimulationConfig{
-          std::move(instrument_),
-          init_price_,
-          spread_,
-          volatility_,
-          latency_ms_,
-          1000,
-          42,
-          "",
-          "",
-          SimulationMode::Simulate,
-          false}) {}
+    : MarketSimulator(legacy_config(std::move(instrument_), init_price_, spread_, volatility_, latency_ms_)) {}
 
 MarketSimulator::MarketSimulator(const SimulationConfig& cfg)
     : config(cfg),
       instrument(cfg.instrument),
+      instrument_id_(InstrumentRegistry::global().intern(cfg.instrument)),
       mid_price(cfg.initial_price),
       spread(cfg.spread),
       volatility(cfg.volatility),
-      latency_ms(cfg.latency_ms),
-      rng(cfg.seed),
+      matching_engine(cfg.max_resting_orders,
+                      TickLadderConfig{to_ticks(cfg.initial_price), cfg.ladder_half_width_ticks}),
+      rng_key_(PhiloxStream::make_key(cfg.seed, instrument_key(cfg.instrument))),
+      rng(rng_key_, kInitStream, 0),
+      price_batch_(rng_key_),
       sequence_number(0),
       simulation_clock(from_millis(kBaseTimestampMs + static_cast<int64_t>(cfg.seed) * 1000)),
-      replay_index(0) {
-
-    trades_buf_.reserve(4);
-    mm_fills_buf_.reserve(8);
+      md_latency_ns_(static_cast<int64_t>(cfg.latency_ms) * 1000000),
+      feed_latency_(cfg.feed_latency),
+      order_latency_(cfg.order_latency),
+      cancel_latency_(cfg.cancel_latency),
+      ack_latency_(cfg.ack_latency),
+      latency_rng_(rng_key_, kLatencyStream, 0) {
+
+    if (md_latency_ns_ < 0) {
+        throw std::invalid_argument("Simulated latencies must be >= 0");
+    }
+    if (cfg.tick_interval_ns == 0) {
+        throw std::invalid_argument("tick_interval_ns must be > 0");
+    }
+    if (cfg.book_depth == 0 || cfg.book_depth > kMaxBookDepth) {
+        throw std::invalid_argument("book_depth must be in 1.." + std::to_string(kMaxBookDepth));
+    }
+    order_arrivals_.reserve(64);
+    fill_reports_.reserve(64);
+    price_batch_.reserve(4 * cfg.book_depth);
 
     if (config.mode == SimulationMode::Replay) {
         if (config.replay_log_path.empty()) {
             throw std::runtime_error("Replay mode requires a replay log path");
         }
-        if (!load_event_log(config.replay_log_path)) {
+        const bool skip_ahead = config.replay_start_sequence > 0 || config.replay_start_time_ns > 0;
+        if (config.replay_start_sequence > 0 && config.replay_start_time_ns > 0) {
+            throw std::invalid_argument("Set at most one of replay_start_sequence and replay_start_time_ns");
+        }
+        // The seek point to start from, when the log has an index
+        SequenceIndex index;
+        const sequence_index::IndexEntry* point = nullptr;
+        if (skip_ahead && index.load(sequence_index::path_for(config.replay_log_path))) {
+            point = config.replay_start_sequence > 0 ? index.point_for_sequence(config.replay_start_sequence)
+                                                     : index.point_for_time(config.replay_start_time_ns);
+        }
+
+        // Only the mapping (and any parser threads) is set up here; events are
+        // parsed as they are replayed
+        bool opened = false;
+        bool has_events = false;
+        if (config.replay_format == ReplayFormat::Binary) {
+            try {
+                opened = binary_replay_.open(config.replay_log_path);
+            } catch (const std::exception& e) {
+                throw std::runtime_error("Failed to load replay log: " + config.replay_log_path + ": " + e.what());
+            }
+            if (opened && point != nullptr) {
+                try {
+                    binary_replay_.seek(point->offset, point->event_number, index.symbol_offsets());
+                } catch (const std::exception& e) {
+                    throw std::runtime_error(index_mismatch(config.replay_log_path) + e.what());
+                }
+            }
+            has_events = opened && binary_replay_.has_next();
+        } else if (config.replay_threads > 1) {
+            parallel_replay_ = std::make_unique<ParallelReplayReader>();
+            opened = parallel_replay_->open(config.replay_log_path, config.replay_threads,
+                                            ParallelReplayReader::kDefaultChunkBytes, point ? point->offset : 0,
+                                            point ? point->event_number : 0);
+            has_events = opened && parallel_replay_->has_next();
+        } else {
+            opened = replay_.open(config.replay_log_path);
+            if (opened && point != nullptr) {
+                replay_.seek(point->offset, point->event_number);
+            }
+            has_events = opened && replay_.has_next();
+        }
+        if (!opened) {
             throw std::runtime_error("Failed to load replay log: " + config.replay_log_path);
         }
-        if (replay_events.empty()) {
+        if (!has_events && point != nullptr) {
+            throw std::runtime_error(index_mismatch(config.replay_log_path) + "seek point past the end");
+        }
+        if (!has_events) {
             throw std::runtime_error("Replay log is empty: " + config.replay_log_path);
         }
+        if (skip_ahead) {
+            skip_to_replay_start(point);
+        }
         return;
     }
 
     if (!config.event_log_path.empty()) {
-        event_log_stream.open(config.event_log_path, std::ios::out | std::ios::trunc);
-        if (!event_log_stream) {
+        event_log_ = std::make_unique<AsyncEventLog>();
+        if (!event_log_->open(config.event_log_path)) {
             throw std::runtime_error("Failed to open event log for writing: " + config.event_log_path);
         }
     }
@@ -100,45 +169,66 @@ MarketSimulator::MarketSimulator(const SimulationConfig& cfg)
 }
 
 void MarketSimulator::initialize_order_book() {
-    std::uniform_int_distribution<int> size_dist(1, 10);
-    bid_levels_.reserve(5);
-    ask_levels_.reserve(5);
-    for (int i = 1; i <= 5; ++i) {
-        double price_offset = i * spread / 2;
-        bid_levels_.emplace_back(mid_price - price_offset, size_dist(rng), generate_order_id(), current_time());
-        ask_levels_.emplace_back(mid_price + price_offset, size_dist(rng), generate_order_id(), current_time());
+    bid_levels_.reserve(config.book_depth);
+    ask_levels_.reserve(config.book_depth);
+    for (std::size_t i = 1; i <= config.book_depth; ++i) {
+        double price_offset = static_cast<double>(i) * spread / 2;
+        bid_levels_.emplace_back(to_ticks(mid_price - price_offset), random_batch::next_int(rng, 1, 10), generate_order_id(), current_time());
+        ask_levels_.emplace_back(to_ticks(mid_price + price_offset), random_batch::next_int(rng, 1, 10), generate_order_id(), current_time());
     }
 }
 
 MarketDataEvent MarketSimulator::generate_event() {
-    if (!replay_events.empty()) {
-        if (replay_index >= replay_events.size()) {
-            throw std::out_of_range("Replay log exhausted");
+    MarketDataEvent event;
+    generate_event(event);
+    return event;
+}
+
+void MarketSimulator::generate_event(MarketDataEvent& event) {
+    if (config.mode == SimulationMode::Replay) {
+        if (replay_first_pending_) {
+            std::swap(event, replay_first_);
+            replay_first_pending_ = false;
+            return;
         }
-        return replay_events[replay_index++];
+        replay_next_event(event);
+        return;
     }
 
-    std::normal_distribution<> noise(0, volatility);
-    mid_price += noise(rng);
+    // Order actions that reached the exchange since the last tick
+    apply_order_arrivals(exchange_time());
+
+    // The mid is still a random walk, but each step's draw depends only on
+    // (seed, instrument, event index), not on what earlier events consumed
+    const uint64_t event_index = static_cast<uint64_t>(sequence_number) + 1;
+    rng.reset(kMidStream, event_index);
+    mid_price += random_batch::next_normal(rng, 0.0, volatility);
     mid_price = std::max(mid_price, 0.01);
 
-    update_order_book();
+    update_order_book(event_index);
 
-    // Reuse pre-allocated buffers
-    trades_buf_.clear();
-    mm_fills_buf_.clear();
-    simulate_trade_activity(trades_buf_, mm_fills_buf_);
+    // Every field is overwritten; clear() and assignment keep the caller's capacity
+    event.trades.clear();
+    rng.reset(kTradeStream, event_index);
+    latency_rng_.reset(kLatencyStream, event_index);
+    simulate_trade_activity(event.trades);
 
+    // Published at the exchange now; the MM sees it feed latency later, along
+    // with every fill report that has reached it by then. The feed is in order,
+    // so a fast sample never overtakes an earlier event.
     auto event_creation_time = current_time();
-    if (latency_ms > 0) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(latency_ms));
-    }
+    mm_receive_time_ = std::max(mm_receive_time_,
+                                to_sim_time(event_creation_time) + md_latency_ns_ + feed_latency_.sample(latency_rng_));
+    event.mm_fills.clear();
+    fill_reports_.run_until(mm_receive_time_, [&event](SimTime, const FillEvent& fill) {
+        event.mm_fills.push_back(fill);
+    });
 
     // Build partial_fills from mm_fills for backwards compatibility
-    std::vector<PartialFillEvent> partial_fills;
-    for (const auto& fill : mm_fills_buf_) {
+    event.partial_fills.clear();
+    for (const auto& fill : event.mm_fills) {
         if (fill.leaves_qty > 0) {
-            partial_fills.push_back(PartialFillEvent{
+            event.partial_fills.push_back(PartialFillEvent{
                 fill.order_id,
                 fill.price,
                 fill.fill_qty,
@@ -148,43 +238,29 @@ MarketDataEvent MarketSimulator::generate_event() {
         }
     }
 
-    MarketDataEvent event{
-        instrument,
-        bid_levels_.empty() ? 0.0 : bid_levels_.front().price,
-        ask_levels_.empty() ? 0.0 : ask_levels_.front().price,
-        bid_levels_.empty() ? 0 : bid_levels_.front().size,
-        ask_levels_.empty() ? 0 : ask_levels_.front().size,
-        bid_levels_,
-        ask_levels_,
-        std::move(trades_buf_),
-        std::move(partial_fills),
-        std::move(mm_fills_buf_),
-        event_creation_time,
-        ++sequence_number
-    };
+    event.instrument_id = instrument_id_;
+    event.best_bid_price = bid_levels_.empty() ? 0 : bid_levels_.front().price;
+    event.best_ask_price = ask_levels_.empty() ? 0 : ask_levels_.front().price;
+    event.best_bid_size = bid_levels_.empty() ? 0 : bid_levels_.front().size;
+    event.best_ask_size = ask_levels_.empty() ? 0 : ask_levels_.front().size;
+    event.bid_levels = bid_levels_;
+    event.ask_levels = ask_levels_;
+    event.timestamp = event_creation_time;
+    event.sequence_number = ++sequence_number;
 
     maybe_write_event_log(event);
-
-    // Re-initialize moved-from buffers for next event
-    trades_buf_.reserve(4);
-    mm_fills_buf_.reserve(8);
-
-    return event;
 }
 
-void MarketSimulator::simulate_trade_activity(std::vector<Trade>& trades, std::vector<FillEvent>& mm_fills) {
-    std::uniform_real_distribution<> prob_dist(0.0, 1.0);
-    std::uniform_int_distribution<> size_dist(1, 20);
-
+void MarketSimulator::simulate_trade_activity(TradeList& trades) {
     // 20% chance of trade activity
-    if (prob_dist(rng) < 0.2) {
-        bool is_buy = prob_dist(rng) < 0.5;
+    if (random_batch::next_uniform(rng, 0.0, 1.0) < 0.2) {
+        bool is_buy = random_batch::next_uniform(rng, 0.0, 1.0) < 0.5;
         Side aggressor_side = is_buy ? Side::BUY : Side::SELL;
         auto& levels = is_buy ? ask_levels_ : bid_levels_;
 
         if (!levels.empty()) {
-            int trade_size = size_dist(rng);
-            double trade_price = levels[0].price;
+            int trade_size = random_batch::next_int(rng, 1, 20);
+            Price trade_price = levels[0].price;
             uint64_t trade_id = kTradeIdTag | static_cast<uint64_t>(sequence_number + 1);
             auto ts = current_time();
 
@@ -196,44 +272,156 @@ void MarketSimulator::simulate_trade_activity(std::vector<Trade>& trades, std::v
                 ts
             });
 
-            // Route through matching engine to fill MM resting orders
-            auto fills = matching_engine.match_incoming_order(
-                aggressor_side, trade_price, trade_size, trade_id, ts);
-            mm_fills.insert(mm_fills.end(), fills.begin(), fills.end());
+            // Orders that arrived before the trade can be hit by it
+            apply_order_arrivals(to_sim_time(ts));
+
+            // Route through matching engine to fill MM resting orders; the fill
+            // reports reach the MM ack latency after the match
+            last_report_time_ = std::max(last_report_time_, to_sim_time(ts) + ack_latency_.sample(latency_rng_));
+            const SimTime report_time = last_report_time_;
+            matching_engine.match_incoming_order_with(
+                aggressor_side, trade_price, trade_size, trade_id, ts,
+                [this, report_time](const FillEvent& fill) { fill_reports_.schedule(report_time, fill); });
         }
     }
 }
 
+SimTime MarketSimulator::order_arrival_time(OrderAction::Kind kind) {
+    const LatencySampler& path = kind == OrderAction::Kind::Cancel ? cancel_latency_ : order_latency_;
+    last_order_arrival_ = std::max(last_order_arrival_, mm_receive_time_ + path.sample(latency_rng_));
+    return last_order_arrival_;
+}
+
+// Replay has no exchange clock driving arrivals, so it keeps the direct path
+bool MarketSimulator::arrives_now(SimTime arrival) const {
+    return config.mode == SimulationMode::Replay || arrival <= exchange_time();
+}
+
+void MarketSimulator::schedule_order_action(SimTime arrival, OrderAction::Kind kind, const Order& order) {
+    order_arrivals_.schedule(arrival, OrderAction{kind, order});
+}
+
+void MarketSimulator::apply_order_arrivals(SimTime until) {
+    order_arrivals_.run_until(until, [this](SimTime, const OrderAction& action) {
+        bool accepted = false;
+        switch (action.kind) {
+            case OrderAction::Kind::Add:
+                accepted = matching_engine.add_order(action.order) == OrderStatus::ACKNOWLEDGED;
+                break;
+            case OrderAction::Kind::Cancel:
+                accepted = matching_engine.cancel_order(action.order.order_id);
+                break;
+            case OrderAction::Kind::Replace:
+                accepted = matching_engine.replace_order(action.order.order_id, action.order.price,
+                                                         action.order.leaves_qty) == OrderStatus::ACKNOWLEDGED;
+                break;
+        }
+        if (!accepted) {
+            ++rejected_on_arrival_;
+        }
+    });
+}
+
 OrderStatus MarketSimulator::submit_order(const Order& order) {
-    return matching_engine.add_order(order);
+    const SimTime arrival = order_arrival_time(OrderAction::Kind::Add);
+    if (arrives_now(arrival)) {
+        return matching_engine.add_order(order);
+    }
+    schedule_order_action(arrival, OrderAction::Kind::Add, order);
+    return OrderStatus::NEW;
 }
 
 bool MarketSimulator::cancel_order(uint64_t order_id) {
-    return matching_engine.cancel_order(order_id);
+    const SimTime arrival = order_arrival_time(OrderAction::Kind::Cancel);
+    if (arrives_now(arrival)) {
+        return matching_engine.cancel_order(order_id);
+    }
+    schedule_order_action(arrival, OrderAction::Kind::Cancel, Order(order_id, Side::BUY, 0, 0, from_sim_time(arrival)));
+    return true;
+}
+
+std::size_t MarketSimulator::submit_orders(Span<const Order> orders, Span<OrderStatus> statuses) {
+    const SimTime arrival = order_arrival_time(OrderAction::Kind::Add);
+    if (arrives_now(arrival)) {
+        return matching_engine.add_orders(orders, statuses);
+    }
+    // A batch travels together, so its orders arrive in batch order
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+        schedule_order_action(arrival, OrderAction::Kind::Add, orders[i]);
+        statuses[i] = OrderStatus::NEW;
+    }
+    return 0;
+}
+
+std::size_t MarketSimulator::cancel_orders(Span<const uint64_t> order_ids, Span<OrderStatus> statuses) {
+    const SimTime arrival = order_arrival_time(OrderAction::Kind::Cancel);
+    if (arrives_now(arrival)) {
+        return matching_engine.cancel_orders(order_ids, statuses);
+    }
+    for (std::size_t i = 0; i < order_ids.size(); ++i) {
+        schedule_order_action(arrival, OrderAction::Kind::Cancel,
+                              Order(order_ids[i], Side::BUY, 0, 0, from_sim_time(arrival)));
+        statuses[i] = OrderStatus::NEW;
+    }
+    return 0;
+}
+
+OrderStatus MarketSimulator::replace_order(uint64_t order_id, Price new_price, int new_qty) {
+    const SimTime arrival = order_arrival_time(OrderAction::Kind::Replace);
+    if (arrives_now(arrival)) {
+        return matching_engine.replace_order(order_id, new_price, new_qty);
+    }
+    schedule_order_action(arrival, OrderAction::Kind::Replace,
+                          Order(order_id, Side::BUY, new_price, new_qty, from_sim_time(arrival)));
+    return OrderStatus::NEW;
 }
 
-void MarketSimulator::update_order_book() {
-    std::uniform_real_distribution<> noise_dist(-0.001, 0.001);
-    std::uniform_int_distribution<> size_change_dist(-2, 2);
+void MarketSimulator::update_order_book(uint64_t event_index) {
+    // Level i sits (i + 1) * spread / 2 from mid_price. Neighbouring jitters
+    // differ by less than the spacing minus one tick, so after rounding to
+    // ticks the levels stay strictly ordered: both sides are sorted by
+    // construction, with no per-event sort and O(depth) work per update.
+    const double spacing = spread / 2.0;
+    const double jitter_bound = std::min(kMaxLevelJitter, std::max(0.0, (spacing - kTickSize) / 2.0));
+
+    // One draw per event: a price jitter for every level, bids first, then a
+    // size change in [-2, 2] for every level. A shallow book draws its words
+    // one at a time, which is faster than a block there and gives the same values.
+    const std::size_t nb = bid_levels_.size();
+    const std::size_t levels = nb + ask_levels_.size();
+    const double* jitter;
+    const int* size_change;
+    double word_jitter[random_batch::kMinBatchWords / 2];
+    int word_size_change[random_batch::kMinBatchWords / 2];
+    if (2 * levels < random_batch::kMinBatchWords) {
+        rng.reset(kBookStream, event_index);
+        for (std::size_t i = 0; i < levels; ++i) {
+            word_jitter[i] = random_batch::next_uniform(rng, -jitter_bound, jitter_bound);
+        }
+        for (std::size_t i = 0; i < levels; ++i) {
+            word_size_change[i] = random_batch::next_int(rng, -2, 2);
+        }
+        jitter = word_jitter;
+        size_change = word_size_change;
+    } else {
+        price_batch_.draw(kBookStream, event_index, 2 * levels);
+        jitter = price_batch_.uniforms(0, levels, -jitter_bound, jitter_bound);
+        size_change = price_batch_.ints(levels, levels, -2, 2);
+    }
 
     // Re-anchor each level around mid_price so the book tracks actual price movements.
     // Without this, bid/ask levels drift far from mid_price, giving the strategy
     // stale market data and a permanently zero sigma estimate.
-    for (std::size_t i = 0; i < bid_levels_.size(); ++i) {
-        double base_offset = static_cast<double>(i + 1) * spread / 2.0;
-        bid_levels_[i].price = mid_price - base_offset + noise_dist(rng);
-        bid_levels_[i].size = std::max(1, bid_levels_[i].size + size_change_dist(rng));
+    for (std::size_t i = 0; i < nb; ++i) {
+        double base_offset = static_cast<double>(i + 1) * spacing;
+        bid_levels_[i].price = to_ticks(mid_price - base_offset + jitter[i]);
+        bid_levels_[i].size = std::max(1, bid_levels_[i].size + size_change[i]);
     }
-    std::sort(bid_levels_.begin(), bid_levels_.end(),
-              [](const OrderLevel& a, const OrderLevel& b) { return a.price > b.price; });
-
     for (std::size_t i = 0; i < ask_levels_.size(); ++i) {
-        double base_offset = static_cast<double>(i + 1) * spread / 2.0;
-        ask_levels_[i].price = mid_price + base_offset + noise_dist(rng);
-        ask_levels_[i].size = std::max(1, ask_levels_[i].size + size_change_dist(rng));
+        double base_offset = static_cast<double>(i + 1) * spacing;
+        ask_levels_[i].price = to_ticks(mid_price + base_offset + jitter[nb + i]);
+        ask_levels_[i].size = std::max(1, ask_levels_[i].size + size_change[nb + i]);
     }
-    std::sort(ask_levels_.begin(), ask_levels_.end(),
-              [](const OrderLevel& a, const OrderLevel& b) { return a.price < b.price; });
 }
 
 uint64_t MarketSimulator::generate_order_id() {
@@ -241,179 +429,93 @@ uint64_t MarketSimulator::generate_order_id() {
 }
 
 std::chrono::system_clock::time_point MarketSimulator::current_time() {
-    simulation_clock += std::chrono::milliseconds(1);
+    simulation_clock += std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds(config.tick_interval_ns));
     return simulation_clock;
 }
 
 void MarketSimulator::maybe_write_event_log(const MarketDataEvent& event) {
-    if (!event_log_stream) {
-        return;
+    if (event_log_) {
+        event_log_->push(event);
     }
-    event_log_stream << serialize_event(event) << "\n";
-}
-
-std::string MarketSimulator::serialize_event(const MarketDataEvent& event) {
-    auto serialize_levels = [](const std::vector<OrderLevel>& levels) {
-        std::ostringstream oss;
-        oss << std::setprecision(std::numeric_limits<double>::max_digits10);
-        for (std::size_t i = 0; i < levels.size(); ++i) {
-            const auto& level = levels[i];
-            oss << level.price << "," << level.size << "," << level.order_id << "," << to_millis(level.timestamp);
-            if (i + 1 < levels.size()) {
-                oss << ";";
-            }
-        }
-        return oss.str();
-    };
-
-    auto serialize_trades = [](const std::vector<Trade>& trades) {
-        std::ostringstream oss;
-        oss << std::setprecision(std::numeric_limits<double>::max_digits10);
-        for (std::size_t i = 0; i < trades.size(); ++i) {
-            const auto& trade = trades[i];
-            oss << side_to_str(trade.aggressor_side) << "," << trade.price << "," << trade.size << "," << trade.trade_id << "," << to_millis(trade.timestamp);
-            if (i + 1 < trades.size()) {
-                oss << ";";
-            }
-        }
-        return oss.str();
-    };
-
-    auto serialize_partial_fills = [](const std::vector<PartialFillEvent>& fills) {
-        std::ostringstream oss;
-        oss << std::setprecision(std::numeric_limits<double>::max_digits10);
-        for (std::size_t i = 0; i < fills.size(); ++i) {
-            const auto& fill = fills[i];
-            oss << fill.order_id << "," << fill.price << "," << fill.filled_size << "," << fill.remaining_size << "," << to_millis(fill.timestamp);
-            if (i + 1 < fills.size()) {
-                oss << ";";
-            }
-        }
-        return oss.str();
-    };
-
-    std::ostringstream line;
-    line << std::setprecision(std::numeric_limits<double>::max_digits10);
-    line << event.sequence_number << "|"
-         << event.instrument << "|"
-         << event.best_bid_price << "|"
-         << event.best_ask_price << "|"
-         << event.best_bid_size << "|"
-         << event.best_ask_size << "|"
-         << to_millis(event.timestamp) << "|"
-         << serialize_levels(event.bid_levels) << "|"
-         << serialize_levels(event.ask_levels) << "|"
-         << serialize_trades(event.trades) << "|"
-         << serialize_partial_fills(event.partial_fills);
-    return line.str();
 }
 
-MarketDataEvent MarketSimulator::deserialize_event(const std::string& line) {
-    const auto fields = split(line, '|');
-    if (fields.size() != 11) {
-        throw std::runtime_error("Malformed replay log line");
+std::size_t MarketSimulator::replay_line_number() const {
+    if (config.replay_format == ReplayFormat::Binary) {
+        return binary_replay_.record_number();
     }
+    return parallel_replay_ ? parallel_replay_->line_number() : replay_.line_number();
+}
 
-    auto parse_levels = [](const std::string& raw) {
-        std::vector<OrderLevel> levels;
-        if (raw.empty()) {
-            return levels;
-        }
-        for (const auto& entry : split(raw, ';')) {
-            if (entry.empty()) {
-                continue;
-            }
-            const auto tokens = split(entry, ',');
-            if (tokens.size() != 4) {
-                throw std::runtime_error("Malformed level entry");
-            }
-            levels.emplace_back(
-                std::stod(tokens[0]),
-                std::stoi(tokens[1]),
-                std::stoull(tokens[2]),
-                from_millis(std::stoll(tokens[3])));
+// Reads up to the configured start, from the index seek point if there is
+// one, and holds the start event for the first generate_event
+void MarketSimulator::skip_to_replay_start(const sequence_index::IndexEntry* point) {
+    auto read = [&] {
+        try {
+            replay_next_event(replay_first_);
+        } catch (const std::out_of_range&) {
+            throw std::runtime_error("Replay start is past the end of " + config.replay_log_path);
         }
-        return levels;
     };
-
-    auto parse_trades = [](const std::string& raw) {
-        std::vector<Trade> trades;
-        if (raw.empty()) {
-            return trades;
+    if (point == nullptr) {
+        read();
+    } else {
+        const std::string stale = index_mismatch(config.replay_log_path);
+        try {
+            read();
+        } catch (const std::runtime_error& e) {
+            throw std::runtime_error(stale + e.what());
         }
-        for (const auto& entry : split(raw, ';')) {
-            if (entry.empty()) {
-                continue;
-            }
-            const auto tokens = split(entry, ',');
-            if (tokens.size() != 5) {
-                throw std::runtime_error("Malformed trade entry");
-            }
-            trades.push_back(Trade{
-                str_to_side(tokens[0]),
-                std::stod(tokens[1]),
-                std::stoi(tokens[2]),
-                std::stoull(tokens[3]),
-                from_millis(std::stoll(tokens[4]))});
+        if (replay_first_.sequence_number != point->sequence_number) {
+            throw std::runtime_error(stale + "expected sequence " + std::to_string(point->sequence_number) +
+                                     " at byte " + std::to_string(point->offset) + ", got " +
+                                     std::to_string(replay_first_.sequence_number));
         }
-        return trades;
-    };
+    }
+    const int64_t start_ns = config.replay_start_time_ns;
+    while (config.replay_start_sequence > 0 ? replay_first_.sequence_number < config.replay_start_sequence
+                                            : binary_capture::to_nanos(replay_first_.timestamp) < start_ns) {
+        read();
+    }
+    replay_first_pending_ = true;
+}
 
-    auto parse_partial_fills = [](const std::string& raw) {
-        std::vector<PartialFillEvent> fills;
-        if (raw.empty()) {
-            return fills;
-        }
-        for (const auto& entry : split(raw, ';')) {
-            if (entry.empty()) {
-                continue;
-            }
-            const auto tokens = split(entry, ',');
-            if (tokens.size() != 5) {
-                throw std::runtime_error("Malformed partial fill entry");
+void MarketSimulator::replay_next_event(MarketDataEvent& event) {
+    bool got = false;
+    try {
+        if (config.replay_format == ReplayFormat::Binary) {
+            got = binary_replay_.next(event);
+            // The capture's MM fills belong to the MM that ran when it was
+            // recorded; replay feeds market data only, as the text log does
+            event.mm_fills.clear();
+        } else if (parallel_replay_) {
+            got = parallel_replay_->next(event);
+        } else {
+            const char* line = nullptr;
+            std::size_t len = 0;
+            got = replay_.next_line(line, len);
+            if (got) {
+                replay_parser_.parse(std::string_view(line, len), event);
             }
-            fills.push_back(PartialFillEvent{
-                std::stoull(tokens[0]),
-                std::stod(tokens[1]),
-                std::stoi(tokens[2]),
-                std::stoi(tokens[3]),
-                from_millis(std::stoll(tokens[4]))});
         }
-        return fills;
-    };
-
-    MarketDataEvent event;
-    event.instrument = fields[1];
-    event.best_bid_price = std::stod(fields[2]);
-    event.best_ask_price = std::stod(fields[3]);
-    event.best_bid_size = std::stoi(fields[4]);
-    event.best_ask_size = std::stoi(fields[5]);
-    event.timestamp = from_millis(std::stoll(fields[6]));
-    event.bid_levels = parse_levels(fields[7]);
-    event.ask_levels = parse_levels(fields[8]);
-    event.trades = parse_trades(fields[9]);
-    event.partial_fills = parse_partial_fills(fields[10]);
-    event.sequence_number = std::stoll(fields[0]);
-    return event;
-}
-
-bool MarketSimulator::load_event_log(const std::string& path) {
-    std::ifstream input(path);
-    if (!input) {
-        return false;
+    } catch (const std::exception& e) {
+        throw std::runtime_error(config.replay_log_path + ":" + std::to_string(replay_line_number()) + ": " +
+                                 e.what());
     }
-
-    std::string line;
-    while (std::getline(input, line)) {
-        if (line.empty()) {
-            continue;
-        }
-        replay_events.push_back(deserialize_event(line));
+    if (!got) {
+        throw std::out_of_range("Replay log exhausted");
     }
 
-    if (!replay_events.empty()) {
-        sequence_number = replay_events.back().sequence_number;
-        simulation_clock = replay_events.back().timestamp;
+    // A log is one unbroken sequence; a gap means lost or reordered lines
+    // (including across the chunks of a parallel load)
+    if (replay_started_ && event.sequence_number != sequence_number + 1) {
+        throw std::runtime_error(config.replay_log_path + ":" + std::to_string(replay_line_number()) +
+                                 ": sequence gap: expected " + std::to_string(sequence_number + 1) + ", got " +
+                                 std::to_string(event.sequence_number));
     }
-    return true;
+    replay_started_ = true;
+
+    // The clocks follow the replayed stream
+    sequence_number = event.sequence_number;
+    simulation_clock = event.timestamp;
 }
@@ -3,12 +3,20 @@
 
 #include <chrono>
 #include <cstdint>
-#include <fstream>
-#include <random>
+#include <memory>
 #include <string>
 #include <vector>
 #include "MarketDataEvent.h"
 #include "MatchingEngine.h"
+#include "include/AsyncEventLog.h"
+#include "include/BinaryCaptureReader.h"
+#include "include/EventLogParser.h"
+#include "include/EventScheduler.h"
+#include "include/ParallelReplayReader.h"
+#include "include/Philox.h"
+#include "include/RandomBatch.h"
+#include "include/ReplaySource.h"
+#include "include/SequenceIndex.h"
 #include "include/SimulationConfig.h"
 
 class MarketSimulator {
@@ -16,43 +24,87 @@ public:
     MarketSimulator(std::string instrument_, double init_price_, double spread_, double volatility_, int latency_ms_);
     explicit MarketSimulator(const SimulationConfig& config);
     MarketDataEvent generate_event();
+    // Fills `event` in place, reusing its vectors' capacity; steady state makes no allocations
+    void generate_event(MarketDataEvent& event);
 
-    // MM order submission interface
+    // MM order submission interface. An order action reaches the engine at
+    // (MM receive time of the latest event + sampled order or cancel latency)
+    // in simulated time, never before an action sent earlier. Actions that have
+    // already arrived run immediately and report the engine's status; later
+    // ones are queued and report NEW (cancel_order: true) until the exchange
+    // clock reaches them.
     OrderStatus submit_order(const Order& order);
     bool cancel_order(uint64_t order_id);
+    std::size_t submit_orders(Span<const Order> orders, Span<OrderStatus> statuses);
+    std::size_t cancel_orders(Span<const uint64_t> order_ids, Span<OrderStatus> statuses);
+    OrderStatus replace_order(uint64_t order_id, Price new_price, int new_qty);
     const MatchingEngine& get_matching_engine() const { return matching_engine; }
 
+    // Simulated clocks: exchange time of the latest tick, and when the MM sees the latest event
+    SimTime exchange_time() const { return to_sim_time(simulation_clock); }
+    SimTime mm_receive_time() const { return mm_receive_time_; }
+    std::size_t pending_order_actions() const { return order_arrivals_.size(); }
+    std::size_t pending_fill_reports() const { return fill_reports_.size(); }
+    // Queued actions the engine rejected on arrival (e.g. a cancel that lost the race with a fill)
+    uint64_t rejected_on_arrival() const { return rejected_on_arrival_; }
+
 private:
     SimulationConfig config;
     std::string instrument;
+    InstrumentId instrument_id_;
     double mid_price;
     double spread;
     double volatility;
-    int latency_ms;
-    std::vector<OrderLevel> bid_levels_;
-    std::vector<OrderLevel> ask_levels_;
+    LevelList bid_levels_;
+    LevelList ask_levels_;
     MatchingEngine matching_engine;
-    std::mt19937 rng;
+    uint64_t rng_key_;  // (seed, instrument)
+    PhiloxStream rng;   // repositioned per (stream, event)
+    RandomBatch price_batch_;  // block draws for book updates at kMinBatchWords and up
     int64_t sequence_number;
     uint64_t sim_order_counter_ = 0;
     std::chrono::system_clock::time_point simulation_clock;
-    std::ofstream event_log_stream;
-    std::vector<MarketDataEvent> replay_events;
-    std::size_t replay_index;
 
-    // Pre-allocated vectors reused across events
-    std::vector<Trade> trades_buf_;
-    std::vector<FillEvent> mm_fills_buf_;
+    // Order entry and fill reporting in simulated time
+    struct OrderAction {
+        enum class Kind : uint8_t { Add, Cancel, Replace };
+        Kind kind;
+        Order order;  // Cancel uses order_id; Replace uses order_id, price and leaves_qty
+    };
+    int64_t md_latency_ns_;  // fixed part of the feed latency (latency_ms)
+    LatencySampler feed_latency_;
+    LatencySampler order_latency_;
+    LatencySampler cancel_latency_;
+    LatencySampler ack_latency_;
+    PhiloxStream latency_rng_;  // own substream so sampling never shifts the market path
+    SimTime mm_receive_time_ = 0;
+    SimTime last_order_arrival_ = 0;  // order entry is one session: arrivals stay in send order
+    SimTime last_report_time_ = 0;    // same for fill reports back to the MM
+    EventScheduler<OrderAction> order_arrivals_;
+    EventScheduler<FillEvent> fill_reports_;
+    uint64_t rejected_on_arrival_ = 0;
+    std::unique_ptr<AsyncEventLog> event_log_;  // formats and writes on its own thread
+    ReplaySource replay_;  // mmapped log, parsed one line per generate_event
+    EventLogParser replay_parser_;
+    std::unique_ptr<ParallelReplayReader> parallel_replay_;  // replaces replay_ when replay_threads > 1
+    BinaryCaptureReader binary_replay_;  // ReplayFormat::Binary
+    bool replay_started_ = false;
+    MarketDataEvent replay_first_;  // the start event when replay skipped ahead
+    bool replay_first_pending_ = false;
 
     void initialize_order_book();
-    void update_order_book();
-    void simulate_trade_activity(std::vector<Trade>& trades, std::vector<FillEvent>& mm_fills);
+    void update_order_book(uint64_t event_index);
+    void simulate_trade_activity(TradeList& trades);
+    SimTime order_arrival_time(OrderAction::Kind kind);
+    bool arrives_now(SimTime arrival) const;
+    void schedule_order_action(SimTime arrival, OrderAction::Kind kind, const Order& order);
+    void apply_order_arrivals(SimTime until);
     uint64_t generate_order_id();
     std::chrono::system_clock::time_point current_time();
     void maybe_write_event_log(const MarketDataEvent& event);
-    bool load_event_log(const std::string& path);
-    static std::string serialize_event(const MarketDataEvent& event);
-    static MarketDataEvent deserialize_event(const std::string& line);
+    void replay_next_event(MarketDataEvent& event);
+    std::size_t replay_line_number() const;
+    void skip_to_replay_start(const sequence_index::IndexEntry* point);
 };
 
 #endif // MARKET_SIMULATOR_H
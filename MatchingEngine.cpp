@@ -1,105 +1,272 @@
 #include "MatchingEngine.h"
-#include <algorithm>
+#include <iterator>
+
+MatchingEngine::MatchingEngine(std::size_t max_resting_orders, const TickLadderConfig& ladder)
+    : level_pool_(node_block_size<std::pair<const int64_t, PriceLevel>>(), alignof(std::max_align_t)),
+      index_pool_(node_block_size<std::pair<const uint64_t, OrderNode*>>(), alignof(std::max_align_t)),
+      bid_levels_(std::less<int64_t>{}, LevelAllocator(&level_pool_)),
+      ask_levels_(std::less<int64_t>{}, LevelAllocator(&level_pool_)),
+      order_index_(0, std::hash<uint64_t>{}, std::equal_to<uint64_t>{}, IndexAllocator(&index_pool_)) {
+    if (ladder.half_width_ticks > 0) {
+        const std::size_t slots = 2 * ladder.half_width_ticks + 1;
+        use_ladder_ = true;
+        ladder_base_ = ladder.reference_price - static_cast<Price>(ladder.half_width_ticks);
+        bid_ladder_.resize(slots);
+        ask_ladder_.resize(slots);
+        bid_occupied_.resize(slots);
+        ask_occupied_.resize(slots);
+    }
+    reserve(max_resting_orders);
+}
+
+MatchingEngine::~MatchingEngine() {
+    for (auto& entry : order_index_) {
+        order_pool_.destroy(entry.second);
+    }
+}
+
+void MatchingEngine::reserve(std::size_t max_resting_orders) {
+    order_pool_.reserve(max_resting_orders);
+    // Worst case every resting order sits on its own price level
+    if (!use_ladder_) {
+        level_pool_.reserve(max_resting_orders);
+    }
+    index_pool_.reserve(max_resting_orders);
+    order_index_.reserve(max_resting_orders);
+}
+
+bool MatchingEngine::accepts(const Order& order) const {
+    return order.leaves_qty > 0 && order.price > 0 && !order_index_.count(order.order_id) &&
+           (!use_ladder_ || in_ladder(order.price));
+}
 
 OrderStatus MatchingEngine::add_order(Order order) {
-    if (order.leaves_qty <= 0 || order.price <= 0.0) {
+    if (!accepts(order)) {
         order.status = OrderStatus::REJECTED;
         return OrderStatus::REJECTED;
     }
 
     order.status = OrderStatus::ACKNOWLEDGED;
 
-    if (order.side == Side::BUY) {
-        insert_bid(std::move(order));
-    } else {
-        insert_ask(std::move(order));
-    }
+    const Side side = order.side;
+    const Price price = order.price;
+    OrderNode* node = order_pool_.create(OrderNode{std::move(order)});
+    order_index_.emplace(node->order.order_id, node);
+    append_to_level(side, price, node);
 
     return OrderStatus::ACKNOWLEDGED;
 }
 
-void MatchingEngine::insert_bid(Order order) {
-    auto it = std::lower_bound(bid_book.begin(), bid_book.end(), order,
-        [](const Order& existing, const Order& incoming) {
-            if (existing.price != incoming.price)
-                return existing.price > incoming.price; // descending by price
-            return existing.created_at < incoming.created_at; // ascending by time (earlier first)
-        });
-    bid_book.insert(it, std::move(order));
-}
+std::size_t MatchingEngine::add_orders(Span<const Order> orders, Span<OrderStatus> statuses) {
+    // Pass 1: validate and index in batch order, so duplicate ids resolve first-wins
+    batch_scratch_.clear();
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+        const Order& order = orders[i];
+        if (!accepts(order)) {
+            statuses[i] = OrderStatus::REJECTED;
+            continue;
+        }
+        OrderNode* node = order_pool_.create(OrderNode{order});
+        node->order.status = OrderStatus::ACKNOWLEDGED;
+        order_index_.emplace(order.order_id, node);
+        statuses[i] = OrderStatus::ACKNOWLEDGED;
+        batch_scratch_.push_back(BatchEntry{order.side, slot_key(order.side, order.price), i, node});
+    }
 
-void MatchingEngine::insert_ask(Order order) {
-    auto it = std::lower_bound(ask_book.begin(), ask_book.end(), order,
-        [](const Order& existing, const Order& incoming) {
-            if (existing.price != incoming.price)
-                return existing.price < incoming.price; // ascending by price
-            return existing.created_at < incoming.created_at; // ascending by time (earlier first)
-        });
-    ask_book.insert(it, std::move(order));
+    // Pass 2: link in (side, level) order; seq keeps FIFO within a level
+    std::sort(batch_scratch_.begin(), batch_scratch_.end(), [](const BatchEntry& a, const BatchEntry& b) {
+        if (a.side != b.side) return a.side < b.side;
+        if (a.key != b.key) return a.key < b.key;
+        return a.seq < b.seq;
+    });
+
+    PriceLevel* level = nullptr;
+    LevelMap::iterator hint;
+    for (std::size_t i = 0; i < batch_scratch_.size(); ++i) {
+        const BatchEntry& entry = batch_scratch_[i];
+        const bool new_side = i == 0 || entry.side != batch_scratch_[i - 1].side;
+        if (new_side || entry.key != batch_scratch_[i - 1].key) {
+            if (use_ladder_) {
+                level = ladder_level(entry.side, static_cast<std::size_t>(entry.key));
+            } else {
+                // Ascending keys: the slot after the previous level is usually the right hint
+                LevelMap& levels = levels_for(entry.side);
+                if (new_side) {
+                    hint = levels.lower_bound(entry.key);
+                }
+                auto it = levels.try_emplace(hint, entry.key);
+                level = &it->second;
+                hint = std::next(it);
+            }
+            if (level->order_count == 0) {
+                activate_level(entry.side, *level, entry.node->order.price, entry.key);
+            }
+        }
+        link_tail(*level, entry.node);
+    }
+
+    return batch_scratch_.size();
 }
 
-bool MatchingEngine::cancel_order(uint64_t order_id) {
-    for (auto it = bid_book.begin(); it != bid_book.end(); ++it) {
-        if (it->order_id == order_id) {
-            it->status = OrderStatus::CANCELED;
-            bid_book.erase(it);
-            return true;
+std::size_t MatchingEngine::cancel_orders(Span<const uint64_t> order_ids, Span<OrderStatus> statuses) {
+    std::size_t canceled = 0;
+    for (std::size_t i = 0; i < order_ids.size(); ++i) {
+        if (cancel_order(order_ids[i])) {
+            statuses[i] = OrderStatus::CANCELED;
+            ++canceled;
+        } else {
+            statuses[i] = OrderStatus::REJECTED;
         }
     }
-    for (auto it = ask_book.begin(); it != ask_book.end(); ++it) {
-        if (it->order_id == order_id) {
-            it->status = OrderStatus::CANCELED;
-            ask_book.erase(it);
-            return true;
+    return canceled;
+}
+
+void MatchingEngine::append_to_level(Side side, Price price, OrderNode* node) {
+    const int64_t key = slot_key(side, price);
+    PriceLevel* level = use_ladder_
+        ? ladder_level(side, static_cast<std::size_t>(key))
+        : &levels_for(side).try_emplace(key).first->second;
+    if (level->order_count == 0) {
+        activate_level(side, *level, price, key);
+    }
+    link_tail(*level, node);
+}
+
+void MatchingEngine::activate_level(Side side, PriceLevel& level, Price price, int64_t key) {
+    level.price = price;
+    level.key = key;
+    if (use_ladder_) {
+        (side == Side::BUY ? bid_occupied_ : ask_occupied_).set(static_cast<std::size_t>(key));
+    }
+}
+
+void MatchingEngine::link_tail(PriceLevel& level, OrderNode* node) {
+    node->level = &level;
+    node->prev = level.tail;
+    node->next = nullptr;
+    if (level.tail) {
+        level.tail->next = node;
+    } else {
+        level.head = node;
+    }
+    level.tail = node;
+    level.total_qty += node->order.leaves_qty;
+    ++level.order_count;
+}
+
+void MatchingEngine::unlink_node(Side side, OrderNode* node) {
+    PriceLevel* level = node->level;
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        level->head = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    } else {
+        level->tail = node->prev;
+    }
+    level->total_qty -= node->order.leaves_qty;
+    --level->order_count;
+    node->prev = node->next = nullptr;
+    node->level = nullptr;
+
+    if (level->order_count == 0) {
+        if (use_ladder_) {
+            (side == Side::BUY ? bid_occupied_ : ask_occupied_).reset(static_cast<std::size_t>(level->key));
+        } else {
+            levels_for(side).erase(level->key);
         }
     }
-    return false;
+}
+
+bool MatchingEngine::cancel_order(uint64_t order_id) {
+    auto it = order_index_.find(order_id);
+    if (it == order_index_.end()) {
+        return false;
+    }
+
+    OrderNode* node = it->second;
+    node->order.status = OrderStatus::CANCELED;
+    unlink_node(node->order.side, node);
+    order_index_.erase(it);
+    order_pool_.destroy(node);
+    return true;
+}
+
+OrderStatus MatchingEngine::replace_order(uint64_t order_id, Price new_price, int new_qty) {
+    auto it = order_index_.find(order_id);
+    if (it == order_index_.end() || new_qty <= 0 || new_price <= 0 ||
+        (use_ladder_ && !in_ladder(new_price))) {
+        return OrderStatus::REJECTED;
+    }
+
+    OrderNode* node = it->second;
+    Order& order = node->order;
+    const int filled_qty = order.original_qty - order.leaves_qty;
+
+    if (new_price == order.price && new_qty <= order.leaves_qty) {
+        // Size-down in place: queue position is unchanged
+        node->level->total_qty -= order.leaves_qty - new_qty;
+        order.leaves_qty = new_qty;
+    } else {
+        unlink_node(order.side, node);
+        order.price = new_price;
+        order.leaves_qty = new_qty;
+        append_to_level(order.side, new_price, node);
+    }
+    order.original_qty = filled_qty + new_qty;
+
+    return OrderStatus::ACKNOWLEDGED;
 }
 
 std::vector<FillEvent> MatchingEngine::match_incoming_order(
-    Side aggressor_side, double price, int qty,
+    Side aggressor_side, Price price, int qty,
     uint64_t trade_id,
     std::chrono::system_clock::time_point timestamp)
 {
     std::vector<FillEvent> fills;
-    int remaining = qty;
-
-    // Aggressor BUY hits resting ASKs; aggressor SELL hits resting BIDs
-    auto& passive_book = (aggressor_side == Side::BUY) ? ask_book : bid_book;
-
-    auto it = passive_book.begin();
-    while (it != passive_book.end() && remaining > 0) {
-        // Check price compatibility
-        if (aggressor_side == Side::BUY && it->price > price) break;
-        if (aggressor_side == Side::SELL && it->price < price) break;
+    match_incoming_order(aggressor_side, price, qty, trade_id, timestamp, fills);
+    return fills;
+}
 
-        int fill_qty = std::min(remaining, it->leaves_qty);
-        it->leaves_qty -= fill_qty;
-        it->updated_at = timestamp;
-        remaining -= fill_qty;
+std::size_t MatchingEngine::match_incoming_order(
+    Side aggressor_side, Price price, int qty,
+    uint64_t trade_id,
+    std::chrono::system_clock::time_point timestamp,
+    std::vector<FillEvent>& out)
+{
+    const std::size_t before = out.size();
+    match_incoming_order_with(aggressor_side, price, qty, trade_id, timestamp,
+                              [&out](const FillEvent& fill) { out.push_back(fill); });
+    return out.size() - before;
+}
 
-        if (it->leaves_qty == 0) {
-            it->status = OrderStatus::FILLED;
-        } else {
-            it->status = OrderStatus::PARTIALLY_FILLED;
+std::vector<Order> MatchingEngine::snapshot(Side side) const {
+    std::vector<Order> out;
+    auto append_level = [&out](const PriceLevel& level) {
+        for (const OrderNode* node = level.head; node; node = node->next) {
+            out.push_back(node->order);
         }
+    };
 
-        fills.push_back(FillEvent{
-            it->order_id,
-            trade_id,
-            it->side,
-            it->price,
-            fill_qty,
-            it->leaves_qty,
-            timestamp
-        });
-
-        if (it->leaves_qty == 0) {
-            it = passive_book.erase(it);
-        } else {
-            ++it;
+    if (!use_ladder_) {
+        for (const auto& entry : (side == Side::BUY ? bid_levels_ : ask_levels_)) {
+            append_level(entry.second);
         }
+        return out;
     }
 
-    return fills;
+    if (side == Side::BUY) {
+        for (std::size_t slot = bid_occupied_.find_last(); slot != LevelBitmap::npos;
+             slot = slot == 0 ? LevelBitmap::npos : bid_occupied_.prev_set(slot - 1)) {
+            append_level(bid_ladder_[slot]);
+        }
+    } else {
+        for (std::size_t slot = ask_occupied_.find_first(); slot != LevelBitmap::npos;
+             slot = ask_occupied_.next_set(slot + 1)) {
+            append_level(ask_ladder_[slot]);
+        }
+    }
+    return out;
 }
@@ -2,26 +2,245 @@
 #define MATCHING_ENGINE_H
 
 #include "Order.h"
+#include "include/LevelBitmap.h"
+#include "include/ObjectPool.h"
+#include "include/Span.h"
+#include <algorithm>
 #include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
 #include <vector>
 
+// Optional dense book. When half_width_ticks > 0, every tick in
+// [reference_price - half_width_ticks, reference_price + half_width_ticks]
+// gets a preallocated level slot per side, and best/next-level lookups use an
+// occupancy bitmap instead of a tree walk. Orders priced outside the ladder
+// are rejected.
+struct TickLadderConfig {
+    Price reference_price = 0;
+    std::size_t half_width_ticks = 0;
+};
+
 class MatchingEngine {
 public:
+    static constexpr std::size_t kDefaultMaxRestingOrders = 1024;
+
+    explicit MatchingEngine(std::size_t max_resting_orders = kDefaultMaxRestingOrders,
+                            const TickLadderConfig& ladder = TickLadderConfig{});
+    ~MatchingEngine();
+    MatchingEngine(const MatchingEngine&) = delete;
+    MatchingEngine& operator=(const MatchingEngine&) = delete;
+
+    // Queues the order at the tail of its price level. Priority within a price
+    // is arrival order at the engine; created_at is not consulted, so an order
+    // stamped earlier but added later still queues behind.
     OrderStatus add_order(Order order);
     bool cancel_order(uint64_t order_id);
-    std::vector<FillEvent> match_incoming_order(Side aggressor_side, double price, int qty,
+
+    // Batch entry: statuses[i] receives the result for orders[i] (statuses must
+    // hold at least orders.size()). Accepted orders are sorted by side and price
+    // and linked into the book in one ordered pass; orders at the same price keep
+    // their batch order behind any already resting there, whatever their
+    // created_at. Returns the number accepted.
+    std::size_t add_orders(Span<const Order> orders, Span<OrderStatus> statuses);
+    // statuses[i] is CANCELED, or REJECTED for an unknown id. Returns the number canceled.
+    std::size_t cancel_orders(Span<const uint64_t> order_ids, Span<OrderStatus> statuses);
+
+    // Amend a resting order in one step. Lowering the size at the same price
+    // keeps queue priority; any price change or size increase re-queues the
+    // order at the tail of its (new) level. new_qty is the new open quantity.
+    OrderStatus replace_order(uint64_t order_id, Price new_price, int new_qty);
+    std::vector<FillEvent> match_incoming_order(Side aggressor_side, Price price, int qty,
                                                  uint64_t trade_id,
                                                  std::chrono::system_clock::time_point timestamp);
 
-    const std::vector<Order>& get_bids() const { return bid_book; }
-    const std::vector<Order>& get_asks() const { return ask_book; }
+    // Appends fills to a caller-owned buffer (reused across calls); returns the count appended
+    std::size_t match_incoming_order(Side aggressor_side, Price price, int qty,
+                                     uint64_t trade_id,
+                                     std::chrono::system_clock::time_point timestamp,
+                                     std::vector<FillEvent>& out);
+
+    // Hands each fill to on_fill(const FillEvent&) as it happens, with no intermediate container
+    template <typename FillSink>
+    void match_incoming_order_with(Side aggressor_side, Price price, int qty,
+                                   uint64_t trade_id,
+                                   std::chrono::system_clock::time_point timestamp,
+                                   FillSink&& on_fill);
+
+    // Snapshots in priority order (best price first, FIFO within a price)
+    std::vector<Order> get_bids() const { return snapshot(Side::BUY); }
+    std::vector<Order> get_asks() const { return snapshot(Side::SELL); }
+
+    std::size_t resting_order_count() const { return order_index_.size(); }
+    std::size_t bid_level_count() const { return use_ladder_ ? bid_occupied_.count() : bid_levels_.size(); }
+    std::size_t ask_level_count() const { return use_ladder_ ? ask_occupied_.count() : ask_levels_.size(); }
+    bool uses_ladder() const { return use_ladder_; }
+
+    // Pre-size node pools and the order index for the expected working set
+    void reserve(std::size_t max_resting_orders);
 
 private:
-    std::vector<Order> bid_book; // sorted descending by price, then ascending by time
-    std::vector<Order> ask_book; // sorted ascending by price, then ascending by time
+    struct PriceLevel;
+
+    // Intrusive FIFO node; its address is the handle stored in order_index_
+    struct OrderNode {
+        Order order;
+        OrderNode* prev = nullptr;
+        OrderNode* next = nullptr;
+        PriceLevel* level = nullptr;
+    };
+
+    struct PriceLevel {
+        Price price = 0;
+        int64_t key = 0;  // map key, or ladder slot index in ladder mode
+        OrderNode* head = nullptr;
+        OrderNode* tail = nullptr;
+        int total_qty = 0;
+        std::size_t order_count = 0;
+    };
+
+    // Keyed so that begin() is always the best level: bids use -price, asks use price
+    using LevelAllocator = PoolAllocator<std::pair<const int64_t, PriceLevel>>;
+    using LevelMap = std::map<int64_t, PriceLevel, std::less<int64_t>, LevelAllocator>;
+    using IndexAllocator = PoolAllocator<std::pair<const uint64_t, OrderNode*>>;
+    using OrderIndex = std::unordered_map<uint64_t, OrderNode*, std::hash<uint64_t>,
+                                          std::equal_to<uint64_t>, IndexAllocator>;
+
+    // Pools must outlive the containers that allocate from them
+    ObjectPool<OrderNode> order_pool_;
+    FixedBlockPool level_pool_;
+    FixedBlockPool index_pool_;
+    LevelMap bid_levels_;
+    LevelMap ask_levels_;
+    OrderIndex order_index_;
+
+    // Scratch for add_orders; keeps its capacity between batches
+    struct BatchEntry {
+        Side side;
+        int64_t key;
+        std::size_t seq;
+        OrderNode* node;
+    };
+    std::vector<BatchEntry> batch_scratch_;
 
-    void insert_bid(Order order);
-    void insert_ask(Order order);
+    // Dense ladder mode: slot i holds price ladder_base_ + i
+    bool use_ladder_ = false;
+    Price ladder_base_ = 0;
+    std::vector<PriceLevel> bid_ladder_;
+    std::vector<PriceLevel> ask_ladder_;
+    LevelBitmap bid_occupied_;
+    LevelBitmap ask_occupied_;
+
+    LevelMap& levels_for(Side side) { return side == Side::BUY ? bid_levels_ : ask_levels_; }
+    static int64_t level_key(Side side, Price price) { return side == Side::BUY ? -price : price; }
+
+    bool in_ladder(Price price) const {
+        return price >= ladder_base_ && price - ladder_base_ < static_cast<Price>(bid_ladder_.size());
+    }
+    PriceLevel* ladder_level(Side side, std::size_t slot) {
+        return side == Side::BUY ? &bid_ladder_[slot] : &ask_ladder_[slot];
+    }
+
+    PriceLevel* best_level(Side side);
+    PriceLevel* next_level(Side side, const PriceLevel* emptied);
+    int64_t slot_key(Side side, Price price) const {
+        return use_ladder_ ? price - ladder_base_ : level_key(side, price);
+    }
+    bool accepts(const Order& order) const;
+
+    void append_to_level(Side side, Price price, OrderNode* node);
+    void activate_level(Side side, PriceLevel& level, Price price, int64_t key);
+    static void link_tail(PriceLevel& level, OrderNode* node);
+    void unlink_node(Side side, OrderNode* node);
+    std::vector<Order> snapshot(Side side) const;
 };
 
+inline MatchingEngine::PriceLevel* MatchingEngine::best_level(Side side) {
+    if (use_ladder_) {
+        // Bids: highest occupied slot; asks: lowest
+        std::size_t slot = side == Side::BUY ? bid_occupied_.find_last() : ask_occupied_.find_first();
+        return slot == LevelBitmap::npos ? nullptr : ladder_level(side, slot);
+    }
+    LevelMap& levels = levels_for(side);
+    return levels.empty() ? nullptr : &levels.begin()->second;
+}
+
+// Next level in priority order after `emptied` has been drained. In map mode
+// the drained level is already erased, so this is simply the new best.
+inline MatchingEngine::PriceLevel* MatchingEngine::next_level(Side side, const PriceLevel* emptied) {
+    if (use_ladder_) {
+        const std::size_t slot = static_cast<std::size_t>(emptied->key);
+        std::size_t next = LevelBitmap::npos;
+        if (side == Side::BUY) {
+            next = slot == 0 ? LevelBitmap::npos : bid_occupied_.prev_set(slot - 1);
+        } else {
+            next = ask_occupied_.next_set(slot + 1);
+        }
+        return next == LevelBitmap::npos ? nullptr : ladder_level(side, next);
+    }
+    return best_level(side);
+}
+
+template <typename FillSink>
+void MatchingEngine::match_incoming_order_with(
+    Side aggressor_side, Price price, int qty,
+    uint64_t trade_id,
+    std::chrono::system_clock::time_point timestamp,
+    FillSink&& on_fill)
+{
+    int remaining = qty;
+
+    // Aggressor BUY hits resting ASKs; aggressor SELL hits resting BIDs
+    const Side passive_side = (aggressor_side == Side::BUY) ? Side::SELL : Side::BUY;
+
+    PriceLevel* level = best_level(passive_side);
+    while (remaining > 0 && level) {
+        // Check price compatibility
+        if (aggressor_side == Side::BUY && level->price > price) break;
+        if (aggressor_side == Side::SELL && level->price < price) break;
+
+        // Walk the FIFO queue; the level may be released once its last order fills
+        OrderNode* node = level->head;
+        while (node && remaining > 0) {
+            OrderNode* next = node->next;
+            Order& resting = node->order;
+
+            int fill_qty = std::min(remaining, resting.leaves_qty);
+            resting.leaves_qty -= fill_qty;
+            resting.updated_at = timestamp;
+            remaining -= fill_qty;
+            level->total_qty -= fill_qty;
+
+            if (resting.leaves_qty == 0) {
+                resting.status = OrderStatus::FILLED;
+            } else {
+                resting.status = OrderStatus::PARTIALLY_FILLED;
+            }
+
+            on_fill(FillEvent{
+                resting.order_id,
+                trade_id,
+                resting.side,
+                resting.instrument_id,
+                resting.price,
+                fill_qty,
+                resting.leaves_qty,
+                timestamp
+            });
+
+            if (resting.leaves_qty == 0) {
+                order_index_.erase(resting.order_id);
+                unlink_node(passive_side, node);
+                order_pool_.destroy(node);
+            }
+            node = next;
+        }
+
+        if (!node) {
+            level = next_level(passive_side, level);
+        }
+    }
+}
+
 #endif // MATCHING_ENGINE_H
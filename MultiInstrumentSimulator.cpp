@@ -0,0 +1,166 @@
+#include "MultiInstrumentSimulator.h"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+// splitmix64 finalizer: decorrelates neighbouring (seed, index) pairs
+uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+void pin_current_thread(std::size_t cpu) {
+#ifdef __linux__
+    unsigned int cpus = std::thread::hardware_concurrency();
+    if (cpus == 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<int>(cpu % cpus), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+} // namespace
+
+uint32_t MultiInstrumentSimulator::instrument_seed(uint32_t base_seed, std::size_t index) {
+    return static_cast<uint32_t>(mix64((static_cast<uint64_t>(base_seed) << 32) | index));
+}
+
+MultiInstrumentSimulator::MultiInstrumentSimulator(const MultiInstrumentConfig& config)
+    : instruments_(config.instruments) {
+    if (instruments_.empty()) {
+        throw std::invalid_argument("MultiInstrumentSimulator requires at least one instrument");
+    }
+    if (config.base.mode != SimulationMode::Simulate) {
+        throw std::invalid_argument("MultiInstrumentSimulator only supports simulate mode");
+    }
+
+    books_.reserve(instruments_.size());
+    for (std::size_t i = 0; i < instruments_.size(); ++i) {
+        SimulationConfig cfg = config.base;
+        cfg.instrument = instruments_[i];
+        cfg.seed = instrument_seed(config.base.seed, i);
+        // Every book would write the same path, so event_log_path is ignored:
+        // no text log is written for the shards or for the merged stream
+        cfg.event_log_path.clear();
+        books_.push_back(std::make_unique<MarketSimulator>(cfg));
+    }
+    pending_.resize(instruments_.size());
+
+    const std::size_t shard_count = std::max<std::size_t>(1, std::min(config.shard_count, instruments_.size()));
+    shards_.resize(shard_count);
+    for (std::size_t i = 0; i < instruments_.size(); ++i) {
+        shards_[i % shard_count].instruments.push_back(i);
+    }
+    for (std::size_t s = 0; s < shard_count; ++s) {
+        shards_[s].worker = std::thread(&MultiInstrumentSimulator::run_shard, this, s, config.pin_threads);
+    }
+}
+
+MultiInstrumentSimulator::~MultiInstrumentSimulator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        ++generation_;
+    }
+    start_cv_.notify_all();
+    for (auto& shard : shards_) {
+        if (shard.worker.joinable()) {
+            shard.worker.join();
+        }
+    }
+}
+
+void MultiInstrumentSimulator::run_shard(std::size_t shard_index, bool pin) {
+    if (pin) {
+        pin_current_thread(shard_index);
+    }
+
+    uint64_t seen_generation = 0;
+    for (;;) {
+        int rounds = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return generation_ != seen_generation; });
+            seen_generation = generation_;
+            if (stopping_) {
+                return;
+            }
+            rounds = batch_rounds_;
+        }
+
+        std::exception_ptr error;
+        try {
+            generate_for_shard(shards_[shard_index], rounds);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error && !error_) {
+                error_ = error;
+            }
+            if (--shards_running_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+}
+
+void MultiInstrumentSimulator::generate_for_shard(const Shard& shard, int rounds) {
+    for (std::size_t index : shard.instruments) {
+        auto& events = pending_[index];
+        events.resize(static_cast<std::size_t>(rounds));
+        MarketSimulator& sim = *books_[index];
+        for (auto& event : events) {
+            sim.generate_event(event);
+        }
+    }
+}
+
+std::size_t MultiInstrumentSimulator::generate_batch(int rounds, std::vector<TaggedEvent>& out) {
+    if (rounds <= 0) {
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch_rounds_ = rounds;
+        shards_running_ = shards_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    start_cv_.notify_all();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [&] { return shards_running_ == 0; });
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    // Merge: round-major, instrument index within a round
+    const std::size_t before = out.size();
+    out.reserve(before + static_cast<std::size_t>(rounds) * books_.size());
+    for (int r = 0; r < rounds; ++r) {
+        for (std::size_t i = 0; i < books_.size(); ++i) {
+            TaggedEvent tagged;
+            tagged.instrument_index = i;
+            tagged.global_sequence = ++global_sequence_;
+            tagged.event = std::move(pending_[i][static_cast<std::size_t>(r)]);
+            out.push_back(std::move(tagged));
+        }
+    }
+    return out.size() - before;
+}
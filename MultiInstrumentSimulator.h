@@ -0,0 +1,84 @@
+#ifndef MULTI_INSTRUMENT_SIMULATOR_H
+#define MULTI_INSTRUMENT_SIMULATOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MarketDataEvent.h"
+#include "MarketSimulator.h"
+#include "include/SimulationConfig.h"
+
+struct MultiInstrumentConfig {
+    SimulationConfig base;                 // per-book template; instrument and seed are overridden
+    std::vector<std::string> instruments;
+    std::size_t shard_count = 1;
+    bool pin_threads = false;              // pin shard i to CPU i (Linux only; ignored elsewhere)
+};
+
+// Event from one book plus its position in the merged global stream
+struct TaggedEvent {
+    std::size_t instrument_index = 0;
+    int64_t global_sequence = 0;
+    MarketDataEvent event;
+};
+
+// Owns one MarketSimulator per instrument. Books are split across shard
+// threads (instrument i -> shard i % shard_count). Each book draws from its
+// own RNG stream seeded from (base seed, instrument index), so a book's event
+// stream does not depend on the shard count. Batches merge in (round,
+// instrument index) order, so the global sequence is reproducible for a given
+// seed regardless of thread scheduling or shard count.
+class MultiInstrumentSimulator {
+public:
+    explicit MultiInstrumentSimulator(const MultiInstrumentConfig& config);
+    ~MultiInstrumentSimulator();
+    MultiInstrumentSimulator(const MultiInstrumentSimulator&) = delete;
+    MultiInstrumentSimulator& operator=(const MultiInstrumentSimulator&) = delete;
+
+    // Generate `rounds` events per instrument in parallel and append them to
+    // `out` in merged order. Returns the number of events appended.
+    std::size_t generate_batch(int rounds, std::vector<TaggedEvent>& out);
+
+    std::size_t instrument_count() const { return books_.size(); }
+    std::size_t shard_count() const { return shards_.size(); }
+    const std::string& instrument(std::size_t index) const { return instruments_[index]; }
+
+    // Per-book order entry. Not thread-safe against a running generate_batch.
+    MarketSimulator& book(std::size_t index) { return *books_[index]; }
+
+    // Seed of instrument `index` for a given base seed
+    static uint32_t instrument_seed(uint32_t base_seed, std::size_t index);
+
+private:
+    struct Shard {
+        std::vector<std::size_t> instruments;
+        std::thread worker;
+    };
+
+    std::vector<std::string> instruments_;
+    std::vector<std::unique_ptr<MarketSimulator>> books_;
+    std::vector<std::vector<MarketDataEvent>> pending_;  // per-instrument batch output, reused
+    std::vector<Shard> shards_;
+    int64_t global_sequence_ = 0;
+
+    // Start/finish barrier shared by the shard workers
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    std::size_t shards_running_ = 0;
+    int batch_rounds_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;  // first failure inside a shard, rethrown by generate_batch
+
+    void run_shard(std::size_t shard_index, bool pin);
+    void generate_for_shard(const Shard& shard, int rounds);
+};
+
+#endif // MULTI_INSTRUMENT_SIMULATOR_H
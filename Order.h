@@ -3,6 +3,8 @@
 
 #include <cstdint>
 #include <chrono>
+#include "include/InstrumentRegistry.h"
+#include "include/Price.h"
 
 enum class Side { BUY, SELL };
 enum class OrderStatus { NEW, ACKNOWLEDGED, PARTIALLY_FILLED, FILLED, CANCELED, REJECTED };
@@ -10,7 +12,8 @@ enum class OrderStatus { NEW, ACKNOWLEDGED, PARTIALLY_FILLED, FILLED, CANCELED,
 struct Order {
     uint64_t order_id;
     Side side;
-    double price;
+    InstrumentId instrument_id = kNoInstrument;  // fills the padding before price
+    Price price;          // ticks
     int original_qty;
     int leaves_qty;       // remaining unfilled quantity
     OrderStatus status;
@@ -18,14 +21,14 @@ struct Order {
     std::chrono::system_clock::time_point updated_at;
 
     // Full constructor
-    Order(uint64_t id, Side s, double p, int qty,
+    Order(uint64_t id, Side s, Price p, int qty,
           std::chrono::system_clock::time_point ts)
         : order_id(id), side(s), price(p),
           original_qty(qty), leaves_qty(qty),
           status(OrderStatus::NEW), created_at(ts), updated_at(ts) {}
 
     // Legacy constructor for compatibility with existing OrderLevel-style usage
-    Order(double price_, int size_, uint64_t order_id_,
+    Order(Price price_, int size_, uint64_t order_id_,
           std::chrono::system_clock::time_point timestamp_)
         : order_id(order_id_), side(Side::BUY), price(price_),
           original_qty(size_), leaves_qty(size_),
@@ -36,7 +39,8 @@ struct FillEvent {
     uint64_t order_id;
     uint64_t trade_id;
     Side side;
-    double price;
+    InstrumentId instrument_id;  // copied from the resting order
+    Price price;
     int fill_qty;
     int leaves_qty;
     std::chrono::system_clock::time_point timestamp;
@@ -50,11 +50,9 @@ RiskRuleResult RiskManager::eval_max_quote_rate(std::chrono::system_clock::time_
     auto window = std::chrono::duration<double>(config_.rate_window_seconds);
     auto cutoff = now - std::chrono::duration_cast<std::chrono::system_clock::duration>(window);
 
-    while (!quote_timestamps_.empty() && quote_timestamps_.front() < cutoff) {
-        quote_timestamps_.pop_front();
-    }
+    quote_timestamps_.expire_before(cutoff);
 
-    double current = static_cast<double>(quote_timestamps_.size()) / config_.rate_window_seconds;
+    double current = static_cast<double>(quote_timestamps_.total()) / config_.rate_window_seconds;
     double limit = config_.max_quotes_per_second;
     double ratio = current / limit;
     RiskState level = classify(ratio);
@@ -65,11 +63,9 @@ RiskRuleResult RiskManager::eval_max_cancel_rate(std::chrono::system_clock::time
     auto window = std::chrono::duration<double>(config_.rate_window_seconds);
     auto cutoff = now - std::chrono::duration_cast<std::chrono::system_clock::duration>(window);
 
-    while (!cancel_timestamps_.empty() && cancel_timestamps_.front() < cutoff) {
-        cancel_timestamps_.pop_front();
-    }
+    cancel_timestamps_.expire_before(cutoff);
 
-    double current = static_cast<double>(cancel_timestamps_.size()) / config_.rate_window_seconds;
+    double current = static_cast<double>(cancel_timestamps_.total()) / config_.rate_window_seconds;
     double limit = config_.max_cancels_per_second;
     double ratio = current / limit;
     RiskState level = classify(ratio);
@@ -94,7 +90,7 @@ RiskRuleResult RiskManager::eval_stale_market_data(std::chrono::system_clock::ti
 }
 
 RiskRuleResult RiskManager::eval_max_quote_spread(const MarketDataEvent& md) {
-    double spread = md.best_ask_price - md.best_bid_price;
+    double spread = from_ticks(md.best_ask_price - md.best_bid_price);
     double limit = config_.max_quote_spread;
     double ratio = spread / limit;
     RiskState level = classify(ratio);
@@ -178,12 +174,16 @@ void RiskManager::reset_kill_switch() {
     }
 }
 
-void RiskManager::record_quote(std::chrono::system_clock::time_point ts) {
-    quote_timestamps_.push_back(ts);
+void RiskManager::record_quote(std::chrono::system_clock::time_point ts, std::size_t count) {
+    quote_timestamps_.push(ts, count);
+}
+
+void RiskManager::record_cancel(std::chrono::system_clock::time_point ts, std::size_t count) {
+    cancel_timestamps_.push(ts, count);
 }
 
-void RiskManager::record_cancel(std::chrono::system_clock::time_point ts) {
-    cancel_timestamps_.push_back(ts);
+void RiskManager::record_replace(std::chrono::system_clock::time_point ts) {
+    quote_timestamps_.push(ts);
 }
 
 bool RiskManager::is_quoting_allowed() const {
@@ -553,6 +553,7 @@ void WsSession::run_simulation(
         MarketDataEvent last_md;
         bool has_last_md = false;
 
+        MarketDataEvent md;
         for (int iteration = 0; iteration < sim_cfg.iterations; ++iteration) {
             if (stop_requested_.load(std::memory_order_acquire) ||
                 task->stop_requested.load(std::memory_order_acquire)) {
@@ -560,9 +561,8 @@ void WsSession::run_simulation(
             }
 
             auto iter_start = std::chrono::steady_clock::now();
-            MarketDataEvent md;
             try {
-                md = simulator.generate_event();
+                simulator.generate_event(md);
             } catch (const std::out_of_range&) {
                 break;
             }
@@ -572,6 +572,12 @@ void WsSession::run_simulation(
             perf.record_latency(
                 std::chrono::duration_cast<std::chrono::nanoseconds>(iter_end - iter_start).count());
 
+            // Latency is simulated in virtual time; this wall-clock pause only
+            // paces the UI stream at one event per latency_ms
+            if (sim_cfg.latency_ms > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(sim_cfg.latency_ms));
+            }
+
             ++processed;
             last_md = md;
             has_last_md = true;
@@ -753,14 +759,14 @@ std::string WsSession::make_update_json(
         << ",\"run_id\":" << run_id
         << ",\"iteration\":" << iteration
         << ",\"is_final\":" << (is_final ? "true" : "false")
-        << ",\"best_bid_price\":" << md.best_bid_price
-        << ",\"best_ask_price\":" << md.best_ask_price
-        << ",\"spread\":" << (md.best_ask_price - md.best_bid_price)
+        << ",\"best_bid_price\":" << from_ticks(md.best_bid_price)
+        << ",\"best_ask_price\":" << from_ticks(md.best_ask_price)
+        << ",\"spread\":" << from_ticks(md.best_ask_price - md.best_bid_price)
         << ",\"trades\":[";
 
     for (std::size_t i = 0; i < md.trades.size(); ++i) {
         const auto& trade = md.trades[i];
-        out << "{\"price\":" << trade.price
+        out << "{\"price\":" << from_ticks(trade.price)
             << ",\"size\":" << trade.size
             << ",\"side\":\"" << side_to_string(trade.aggressor_side) << "\"}";
         if (i + 1 < md.trades.size()) {
@@ -0,0 +1,270 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "MarketDataEvent.h"
+#include "include/BinaryCapture.h"
+#include "include/ColumnStore.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+namespace scan = column_scan;
+
+const char* const kColumns[] = {"timestamp_ns", "sequence", "bid_price", "ask_price",
+                                "bid_size", "ask_size", "trade_timestamp_ns", "trade_sequence",
+                                "trade_price", "trade_size", "trade_side"};
+
+void remove_store(const std::string& dir) {
+    for (const char* name : kColumns) {
+        std::remove(column_store::column_path(dir, name).c_str());
+    }
+    std::remove(dir.c_str());
+}
+
+// Synthetic top of book: a random-walk mid, a 1-3 tick spread, ~1 ms between
+// events and a trade on about one event in five
+void write_store(const std::string& dir, int64_t rows, uint32_t block_rows) {
+    ColumnStoreWriter writer;
+    if (!writer.open(dir, block_rows)) {
+        throw std::runtime_error("Cannot create column store " + dir);
+    }
+    std::mt19937_64 rng(42);
+    MarketDataEvent md;
+    int64_t ts_ns = 1700000000000000000LL;
+    Price bid = to_ticks(100.0);
+    uint64_t trade_id = 0;
+    for (int64_t i = 0; i < rows; ++i) {
+        const uint64_t r = rng();
+        ts_ns += 1 + static_cast<int64_t>(r % 2000000);
+        bid += static_cast<int64_t>((r >> 21) % 3) - 1;
+        md.sequence_number = i + 1;
+        md.timestamp = binary_capture::from_nanos(ts_ns);
+        md.best_bid_price = bid;
+        md.best_ask_price = bid + 1 + static_cast<int64_t>((r >> 23) % 3);
+        md.best_bid_size = 1 + static_cast<int>((r >> 25) % 500);
+        md.best_ask_size = 1 + static_cast<int>((r >> 34) % 500);
+        md.trades.clear();
+        if ((r >> 43) % 5 == 0) {
+            const bool buy = (r >> 46) & 1;
+            md.trades.push_back(Trade{buy ? Side::BUY : Side::SELL, buy ? md.best_ask_price : bid,
+                                      1 + static_cast<int>((r >> 47) % 100), ++trade_id, md.timestamp});
+        }
+        writer.append(md);
+    }
+    if (!writer.close()) {
+        throw std::runtime_error("Failed writing column store " + dir);
+    }
+}
+
+// Best of `runs` timings of fn(), which returns the query result
+template <typename Fn>
+double best_of(int runs, Fn&& fn, int64_t& result) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < runs; ++i) {
+        const auto start = Clock::now();
+        result = static_cast<int64_t>(fn());
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int64_t rows = 100000000;
+    uint32_t block_rows = column_store::kDefaultBlockRows;
+    std::string dir = "/tmp/bench_column_scan";
+    bool keep = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rows" && i + 1 < argc) {
+            rows = std::stoll(argv[++i]);
+        } else if (arg == "--block-rows" && i + 1 < argc) {
+            block_rows = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--dir" && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (arg == "--keep") {
+            keep = true;
+        } else if (arg == "--help") {
+            std::cout << "Usage: bench_column_scan [--rows N] [--block-rows N] [--dir PATH] [--keep]\n";
+            return 0;
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    try {
+        const auto write_start = Clock::now();
+        write_store(dir, rows, block_rows);
+        const double write_seconds = std::chrono::duration<double>(Clock::now() - write_start).count();
+
+        const ColumnStore store(dir);
+        const auto ts = store.column<int64_t>("timestamp_ns");
+        const auto bid = store.column<int64_t>("bid_price");
+        const auto ask = store.column<int64_t>("ask_price");
+        const auto trade_size = store.column<int32_t>("trade_size");
+        const auto trade_side = store.column<uint8_t>("trade_side");
+        const std::size_t n = bid.rows();
+        const int64_t* bids = bid.values().data();
+        const int64_t* asks = ask.values().data();
+        const int64_t* stamps = ts.values().data();
+        constexpr int kRuns = 3;
+        bool match = true;
+
+        // Sum of one column: every value read once
+        int64_t sum = 0;
+        const double sum_s = best_of(kRuns, [&] { return scan::sum(bid, scan::all(bid)); }, sum);
+
+        // Min and max: whole blocks from the stats vs a pass over the values
+        int64_t lo = 0;
+        int64_t hi = 0;
+        const double minmax_s = best_of(kRuns, [&] {
+            lo = scan::min(bid, scan::all(bid));
+            return hi = scan::max(bid, scan::all(bid));
+        }, hi);
+        int64_t naive_hi = 0;
+        const double naive_minmax_s = best_of(kRuns, [&] {
+            int64_t l = bids[0];
+            int64_t h = bids[0];
+            for (std::size_t i = 0; i < n; ++i) {
+                l = bids[i] < l ? bids[i] : l;
+                h = bids[i] > h ? bids[i] : h;
+            }
+            match = match && l == lo;
+            return h;
+        }, naive_hi);
+        match = match && naive_hi == hi;
+
+        // A selective filter: bids within 0.5% of the walk's range above its
+        // low, which only a few blocks can contain
+        const int64_t band_hi = lo + (hi - lo) / 200;
+        int64_t selected = 0;
+        const double filter_s = best_of(kRuns, [&] { return scan::count_between(bid, lo, band_hi, scan::all(bid)); },
+                                        selected);
+        int64_t naive_selected = 0;
+        const double naive_filter_s = best_of(kRuns, [&] {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (bids[i] >= lo && bids[i] <= band_hi) {
+                    ++count;
+                }
+            }
+            return count;
+        }, naive_selected);
+        match = match && naive_selected == selected;
+
+        // Traded volume by aggressor side
+        int64_t buy_volume = 0;
+        const double volume_s = best_of(kRuns, [&] {
+            return scan::sum_where_equal(trade_size, trade_side, uint8_t{0}, scan::all(trade_size));
+        }, buy_volume);
+        int64_t naive_buy_volume = 0;
+        const double naive_volume_s = best_of(kRuns, [&] {
+            const int32_t* size = trade_size.values().data();
+            const uint8_t* side = trade_side.values().data();
+            int64_t total = 0;
+            for (std::size_t i = 0; i < trade_size.rows(); ++i) {
+                if (side[i] == 0) {
+                    total += size[i];
+                }
+            }
+            return total;
+        }, naive_buy_volume);
+        match = match && naive_buy_volume == buy_volume;
+
+        // Mean spread per minute: rows_between on the timestamps, then
+        // sum_diff over each minute's rows, vs one pass bucketing every row
+        constexpr int64_t kMinute = 60LL * 1000 * 1000 * 1000;
+        const int64_t first_minute = stamps[0] / kMinute;
+        const int64_t minutes = stamps[n - 1] / kMinute - first_minute + 1;
+        std::vector<int64_t> spread(static_cast<std::size_t>(minutes));
+        std::vector<int64_t> counts(static_cast<std::size_t>(minutes));
+        int64_t checksum = 0;
+        const double minute_s = best_of(kRuns, [&] {
+            int64_t h = 0;
+            for (int64_t m = 0; m < minutes; ++m) {
+                const int64_t begin = (first_minute + m) * kMinute;
+                const scan::RowRange r = scan::rows_between(ts, begin, begin + kMinute - 1);
+                spread[m] = scan::sum_diff(ask, bid, r);
+                counts[m] = static_cast<int64_t>(r.size());
+                h = h * 31 + spread[m] + counts[m];
+            }
+            return h;
+        }, checksum);
+        int64_t naive_checksum = 0;
+        const double naive_minute_s = best_of(kRuns, [&] {
+            std::vector<int64_t> s(static_cast<std::size_t>(minutes));
+            std::vector<int64_t> c(static_cast<std::size_t>(minutes));
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::size_t m = static_cast<std::size_t>(stamps[i] / kMinute - first_minute);
+                s[m] += asks[i] - bids[i];
+                ++c[m];
+            }
+            int64_t h = 0;
+            for (int64_t m = 0; m < minutes; ++m) {
+                h = h * 31 + s[m] + c[m];
+            }
+            return h;
+        }, naive_checksum);
+        match = match && naive_checksum == checksum;
+
+        int64_t total_spread = 0;
+        int64_t total_rows = 0;
+        for (int64_t m = 0; m < minutes; ++m) {
+            total_spread += spread[m];
+            total_rows += counts[m];
+        }
+        match = match && total_rows == static_cast<int64_t>(n);
+
+        const double column_gb = static_cast<double>(n * sizeof(int64_t)) / 1e9;
+        std::cout << "=== COLUMN SCAN ===\n";
+        std::cout << "store: " << n << " events, " << trade_size.rows() << " trades, " << bid.blocks()
+                  << " blocks of " << bid.block_rows() << " rows\n";
+        std::cout << "export: " << std::fixed << std::setprecision(2) << write_seconds << " s ("
+                  << std::setprecision(0) << static_cast<double>(n) / write_seconds << " events/s)\n";
+        std::cout << std::fixed << std::setw(28) << "query" << std::setw(12) << "ms" << std::setw(12) << "naive ms"
+                  << std::setw(12) << "GB/s" << "\n";
+        auto row = [&](const char* name, double seconds, double naive_seconds, double gb) {
+            std::cout << std::setw(28) << name << std::setw(12) << std::setprecision(2) << seconds * 1e3;
+            if (naive_seconds > 0) {
+                std::cout << std::setw(12) << naive_seconds * 1e3;
+            } else {
+                std::cout << std::setw(12) << "-";
+            }
+            std::cout << std::setw(12) << std::setprecision(2) << gb / seconds << "\n";
+        };
+        row("sum(bid_price)", sum_s, 0.0, column_gb);
+        row("min/max(bid_price)", minmax_s, naive_minmax_s, column_gb);
+        row("count bid in low 0.5%", filter_s, naive_filter_s, column_gb);
+        row("buy volume (trades)", volume_s, naive_volume_s,
+            static_cast<double>(trade_size.rows() * (sizeof(int32_t) + sizeof(uint8_t))) / 1e9);
+        row("spread per minute", minute_s, naive_minute_s, 3 * column_gb);
+        std::cout << "sum of one column: " << std::setprecision(3) << sum_s << " s for " << n << " rows ("
+                  << (sum_s < 1.0 ? "under" : "OVER") << " 1 s)\n";
+        std::cout << "sum " << sum << ", selected " << selected << " rows, buy volume " << buy_volume << ", " << minutes
+                  << " minutes, mean spread " << std::setprecision(3)
+                  << static_cast<double>(total_spread) / static_cast<double>(n) << " ticks\n";
+        std::cout << "results " << (match ? "match" : "DIFFER") << "\n";
+        std::cout << "===================\n";
+
+        if (!keep) {
+            remove_store(dir);
+        }
+        return match ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << "\n";
+        if (!keep) {
+            remove_store(dir);
+        }
+        return 1;
+    }
+}
@@ -1,17 +1,245 @@
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 #include "MarketSimulator.h"
+#include "MatchingEngine.h"
 #include "MarketMaker.h"
 #include "include/SimulationConfig.h"
 #include "include/HeuristicStrategy.h"
 #include "PerformanceModule.h"
 
+namespace {
+
+constexpr int kMatchLevels = 8;
+constexpr int kOrdersPerLevel = 4;
+constexpr int kRestingQty = 5;
+
+// Book with kMatchLevels ask levels of kOrdersPerLevel orders each
+void seed_asks(MatchingEngine& engine, uint64_t& next_id) {
+    for (int level = 0; level < kMatchLevels; ++level) {
+        for (int i = 0; i < kOrdersPerLevel; ++i) {
+            engine.add_order(Order(next_id++, Side::SELL, to_ticks(100.01) + level * 100, kRestingQty,
+                                   std::chrono::system_clock::time_point{}));
+        }
+    }
+}
+
+// Each iteration sweeps the whole ask side with one aggressive buy and then
+// reposts it, so both paths see identical book states and fill counts.
+template <typename MatchFn>
+double run_matching(int iterations, MatchFn&& match) {
+    MatchingEngine engine(kMatchLevels * kOrdersPerLevel);
+    uint64_t next_id = 1;
+    std::size_t fills = 0;
+    const int sweep_qty = kMatchLevels * kOrdersPerLevel * kRestingQty;
+    const auto ts = std::chrono::system_clock::time_point{};
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        seed_asks(engine, next_id);
+        fills += match(engine, sweep_qty, static_cast<uint64_t>(i), ts);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    if (fills != static_cast<std::size_t>(iterations) * kMatchLevels * kOrdersPerLevel) {
+        std::cerr << "Unexpected fill count: " << fills << "\n";
+    }
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return seconds > 0.0 ? static_cast<double>(fills) / seconds : 0.0;
+}
+
+void report_matching_throughput(int iterations) {
+    double returned = run_matching(iterations,
+        [](MatchingEngine& engine, int qty, uint64_t trade_id, auto ts) {
+            return engine.match_incoming_order(Side::BUY, to_ticks(200.0), qty, trade_id, ts).size();
+        });
+
+    std::vector<FillEvent> buffer;
+    double buffered = run_matching(iterations,
+        [&buffer](MatchingEngine& engine, int qty, uint64_t trade_id, auto ts) {
+            buffer.clear();
+            return engine.match_incoming_order(Side::BUY, to_ticks(200.0), qty, trade_id, ts, buffer);
+        });
+
+    double streamed = run_matching(iterations,
+        [](MatchingEngine& engine, int qty, uint64_t trade_id, auto ts) {
+            std::size_t count = 0;
+            engine.match_incoming_order_with(Side::BUY, to_ticks(200.0), qty, trade_id, ts,
+                                             [&count](const FillEvent&) { ++count; });
+            return count;
+        });
+
+    std::cout << "\nMatching throughput (" << iterations << " sweeps x "
+              << kMatchLevels * kOrdersPerLevel << " fills)\n";
+    std::cout << "  returned vector: " << static_cast<int64_t>(returned) << " fills/s\n";
+    std::cout << "  reused buffer:   " << static_cast<int64_t>(buffered) << " fills/s\n";
+    std::cout << "  fill callback:   " << static_cast<int64_t>(streamed) << " fills/s\n";
+}
+
+// generate_event cost as synthetic book depth grows, next to what the
+// per-event sort of both sides that used to follow every update would add
+void report_generation_scaling(int events, uint32_t seed) {
+    int64_t sink = 0;
+    std::cout << "\nEvent generation vs book depth (" << events << " events)\n";
+    for (std::size_t depth : {5, 50, 500, 5000}) {
+        SimulationConfig config;
+        config.seed = seed;
+        config.latency_ms = 0;
+        config.quiet = true;
+        config.book_depth = depth;
+        MarketSimulator simulator(config);
+        MarketDataEvent md;
+        simulator.generate_event(md);  // warm the event's level capacity
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < events; ++i) {
+            simulator.generate_event(md);
+        }
+        const double gen_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / events;
+
+        LevelList bids = md.bid_levels;
+        LevelList asks = md.ask_levels;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < events; ++i) {
+            bids[i % depth].price += (i & 1) ? 3 : -3;  // keep the input from staying sorted
+            std::sort(bids.begin(), bids.end(),
+                      [](const OrderLevel& a, const OrderLevel& b) { return a.price > b.price; });
+            std::sort(asks.begin(), asks.end(),
+                      [](const OrderLevel& a, const OrderLevel& b) { return a.price < b.price; });
+            sink += bids.front().price;
+        }
+        const double sort_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / events;
+
+        std::cout << "  depth " << depth << ": " << static_cast<int64_t>(gen_ns) << " ns/event"
+                  << " (sorting both sides would add " << static_cast<int64_t>(sort_ns) << " ns)\n";
+    }
+    std::cout << "  (checksum " << sink << ")\n";
+}
+
+
+// The previous synchronous log path: ostringstream per list and per line,
+// written to an ofstream from inside the generation loop
+std::string legacy_serialize(const MarketDataEvent& event) {
+    auto millis = [](std::chrono::system_clock::time_point ts) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(ts.time_since_epoch()).count();
+    };
+    auto levels = [&](const LevelList& list) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(kPriceDecimals);
+        for (std::size_t i = 0; i < list.size(); ++i) {
+            oss << (i ? ";" : "") << from_ticks(list[i].price) << "," << list[i].size << "," << list[i].order_id
+                << "," << millis(list[i].timestamp);
+        }
+        return oss.str();
+    };
+    std::ostringstream trades;
+    trades << std::fixed << std::setprecision(kPriceDecimals);
+    for (std::size_t i = 0; i < event.trades.size(); ++i) {
+        const auto& t = event.trades[i];
+        trades << (i ? ";" : "") << (t.aggressor_side == Side::BUY ? "BUY" : "SELL") << "," << from_ticks(t.price)
+               << "," << t.size << "," << t.trade_id << "," << millis(t.timestamp);
+    }
+    std::ostringstream fills;
+    fills << std::fixed << std::setprecision(kPriceDecimals);
+    for (std::size_t i = 0; i < event.partial_fills.size(); ++i) {
+        const auto& f = event.partial_fills[i];
+        fills << (i ? ";" : "") << f.order_id << "," << from_ticks(f.price) << "," << f.filled_size << ","
+              << f.remaining_size << "," << millis(f.timestamp);
+    }
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(kPriceDecimals);
+    line << event.sequence_number << "|" << InstrumentRegistry::global().name(event.instrument_id) << "|"
+         << from_ticks(event.best_bid_price) << "|" << from_ticks(event.best_ask_price) << "|" << event.best_bid_size
+         << "|" << event.best_ask_size << "|" << millis(event.timestamp) << "|" << levels(event.bid_levels) << "|"
+         << levels(event.ask_levels) << "|" << trades.str() << "|" << fills.str();
+    return line.str();
+}
+
+double thread_cpu_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+}
+
+// Generation throughput with --event-log off, through the async writer, and
+// through the previous synchronous serializer. The async wall figure is the
+// simulation loop alone; "with drain" adds waiting for the writer to finish.
+// Simulation-thread CPU time is what logging costs the critical path when
+// the writer has a core of its own; with fewer cores than threads the wall
+// figures also carry the writer's formatting.
+void report_event_log_overhead(int events, uint32_t seed) {
+    const std::string path = "/tmp/bench_engine_event_log.log";
+    auto run = [&](int mode, double& drain_ns, double& cpu_ns) {
+        SimulationConfig config;
+        config.seed = seed;
+        config.latency_ms = 0;
+        config.quiet = true;
+        if (mode == 1) {
+            config.event_log_path = path;
+        }
+        std::ofstream legacy_out;
+        if (mode == 2) {
+            legacy_out.open(path, std::ios::trunc);
+        }
+        auto simulator = std::make_unique<MarketSimulator>(config);
+        MarketDataEvent md;
+        const auto start = std::chrono::steady_clock::now();
+        const double cpu_start = thread_cpu_ns();
+        for (int i = 0; i < events; ++i) {
+            simulator->generate_event(md);
+            if (mode == 2) {
+                legacy_out << legacy_serialize(md) << "\n";
+            }
+        }
+        const auto loop_end = std::chrono::steady_clock::now();
+        cpu_ns = (thread_cpu_ns() - cpu_start) / events;
+        simulator.reset();  // joins the writer once the ring is drained
+        legacy_out.close();
+        const auto end = std::chrono::steady_clock::now();
+        drain_ns = std::chrono::duration<double, std::nano>(end - start).count() / events;
+        return std::chrono::duration<double, std::nano>(loop_end - start).count() / events;
+    };
+
+    double drain_off = 0, drain_async = 0, drain_sync = 0;
+    double cpu_off = 0, cpu_async = 0, cpu_sync = 0;
+    const double off = run(0, drain_off, cpu_off);
+    const double async = run(1, drain_async, cpu_async);
+    const double sync = run(2, drain_sync, cpu_sync);
+    std::remove(path.c_str());
+    std::remove(sequence_index::path_for(path).c_str());
+
+    auto pct = [](double ns, double base) { return (ns / base - 1.0) * 100.0; };
+    std::cout << "\nEvent log overhead (" << events << " events, " << std::thread::hardware_concurrency()
+              << " hardware threads)\n" << std::fixed << std::setprecision(1);
+    std::cout << "  log off:            " << off << " ns/event wall, " << cpu_off << " ns simulation-thread CPU\n";
+    std::cout << "  async writer:       " << async << " ns/event wall (" << std::showpos << pct(async, off)
+              << std::noshowpos << "%), with drain " << drain_async << " (" << std::showpos << pct(drain_async, off)
+              << std::noshowpos << "%), " << cpu_async << " ns CPU (" << std::showpos << pct(cpu_async, cpu_off) << std::noshowpos << "%)\n";
+    std::cout << "  sync ostringstream: " << sync << " ns/event wall (" << std::showpos << pct(sync, off)
+              << std::noshowpos << "%), " << cpu_sync << " ns CPU\n";
+}
+
+} // namespace
+
 int main(int argc, char* argv[]) {
     int events = 10000;
+    int match_iters = 100000;
+    int depth_events = 2000;
+    int log_events = 200000;
+    std::size_t book_depth = 5;
     uint32_t seed = 42;
 
     for (int i = 1; i < argc; ++i) {
@@ -20,8 +248,17 @@ int main(int argc, char* argv[]) {
             events = std::stoi(argv[++i]);
         } else if (arg == "--seed" && i + 1 < argc) {
             seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--match-iters" && i + 1 < argc) {
+            match_iters = std::stoi(argv[++i]);
+        } else if (arg == "--book-depth" && i + 1 < argc) {
+            book_depth = static_cast<std::size_t>(std::stoull(argv[++i]));
+        } else if (arg == "--depth-events" && i + 1 < argc) {
+            depth_events = std::stoi(argv[++i]);
+        } else if (arg == "--log-events" && i + 1 < argc) {
+            log_events = std::stoi(argv[++i]);
         } else if (arg == "--help") {
-            std::cout << "Usage: bench_engine [--events N] [--seed N]\n";
+            std::cout << "Usage: bench_engine [--events N] [--seed N] [--match-iters N] [--book-depth N]\n"
+                      << "                    [--depth-events N] [--log-events N]\n";
             return 0;
         } else {
             std::cerr << "Unknown argument: " << arg << "\n";
@@ -34,6 +271,7 @@ int main(int argc, char* argv[]) {
     config.iterations = events;
     config.latency_ms = 0;
     config.quiet = true;
+    config.book_depth = book_depth;
 
     MarketSimulator simulator(config);
     RiskConfig risk_cfg;
@@ -45,10 +283,11 @@ int main(int argc, char* argv[]) {
     auto wall_start = std::chrono::steady_clock::now();
     int processed = 0;
 
+    // Reused across iterations so generation reuses the event's capacity
+    MarketDataEvent md;
     for (int i = 0; i < events; ++i) {
-        MarketDataEvent md;
         try {
-            md = simulator.generate_event();
+            simulator.generate_event(md);
         } catch (const std::out_of_range&) {
             break;
         }
@@ -70,5 +309,15 @@ int main(int argc, char* argv[]) {
     std::cout << "Wall time: " << wall_ms << " ms\n\n";
     perf.report_latency_percentiles();
 
+    if (match_iters > 0) {
+        report_matching_throughput(match_iters);
+    }
+    if (depth_events > 0) {
+        report_generation_scaling(depth_events, seed);
+    }
+    if (log_events > 0) {
+        report_event_log_overhead(log_events, seed);
+    }
+
     return 0;
 }
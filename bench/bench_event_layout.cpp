@@ -0,0 +1,142 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "MarketDataEvent.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The previous MarketDataEvent layout: one heap block per list
+struct VectorEvent {
+    InstrumentId instrument_id = kNoInstrument;
+    Price best_bid_price;
+    Price best_ask_price;
+    int best_bid_size;
+    int best_ask_size;
+    std::vector<OrderLevel> bid_levels;
+    std::vector<OrderLevel> ask_levels;
+    std::vector<Trade> trades;
+    std::vector<PartialFillEvent> partial_fills;
+    std::vector<FillEvent> mm_fills;
+    std::chrono::system_clock::time_point timestamp;
+    int64_t sequence_number;
+};
+
+struct LayoutResult {
+    double build_ns = 0.0;
+    double copy_ns = 0.0;
+    double assign_ns = 0.0;
+};
+
+double elapsed_ns_per_op(Clock::time_point start, Clock::time_point end, int ops) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / ops;
+}
+
+// Same shape as a simulator event: 5 levels a side, one trade, two maker fills
+template <typename Event>
+void populate(Event& ev, int64_t seq) {
+    const auto ts = std::chrono::system_clock::time_point(std::chrono::milliseconds(seq));
+    const Price mid = to_ticks(100.0) + seq % 7;
+    ev.instrument_id = 1;
+    ev.sequence_number = seq;
+    ev.timestamp = ts;
+    for (int i = 1; i <= 5; ++i) {
+        ev.bid_levels.emplace_back(mid - i * 50, 10 + i, static_cast<uint64_t>(seq * 10 + i), ts);
+        ev.ask_levels.emplace_back(mid + i * 50, 10 + i, static_cast<uint64_t>(seq * 10 + 5 + i), ts);
+    }
+    ev.best_bid_price = ev.bid_levels[0].price;
+    ev.best_ask_price = ev.ask_levels[0].price;
+    ev.best_bid_size = ev.bid_levels[0].size;
+    ev.best_ask_size = ev.ask_levels[0].size;
+    ev.trades.push_back(Trade{Side::BUY, ev.best_ask_price, 3, static_cast<uint64_t>(seq), ts});
+    for (int i = 0; i < 2; ++i) {
+        ev.mm_fills.push_back(FillEvent{static_cast<uint64_t>(i + 1), static_cast<uint64_t>(seq), Side::SELL, 1,
+                                        ev.best_ask_price, 1, 1 - i, ts});
+    }
+    ev.partial_fills.push_back(PartialFillEvent{1, ev.best_ask_price, 1, 1, ts});
+}
+
+template <typename Event>
+int64_t digest(const Event& ev) {
+    return ev.sequence_number + ev.bid_levels.back().price + ev.mm_fills.back().leaves_qty +
+           static_cast<int64_t>(ev.trades.size());
+}
+
+template <typename Event>
+LayoutResult run_layout(int ops, int64_t& sink) {
+    LayoutResult result;
+
+    // Fresh event per iteration: what generate_event() by value used to cost
+    auto build_start = Clock::now();
+    for (int i = 0; i < ops; ++i) {
+        Event ev;
+        populate(ev, i);
+        sink += digest(ev);
+    }
+    result.build_ns = elapsed_ns_per_op(build_start, Clock::now(), ops);
+
+    // Copy-construct, e.g. an event pushed into a replay buffer or a batch
+    Event source;
+    populate(source, 1);
+    auto copy_start = Clock::now();
+    for (int i = 0; i < ops; ++i) {
+        source.sequence_number = i;
+        Event copy(source);
+        sink += digest(copy);
+    }
+    result.copy_ns = elapsed_ns_per_op(copy_start, Clock::now(), ops);
+
+    // Copy-assign into a reused event, e.g. `last_md = md`
+    Event target;
+    auto assign_start = Clock::now();
+    for (int i = 0; i < ops; ++i) {
+        source.sequence_number = i;
+        target = source;
+        sink += digest(target);
+    }
+    result.assign_ns = elapsed_ns_per_op(assign_start, Clock::now(), ops);
+
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int ops = 1000000;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ops" && i + 1 < argc) {
+            ops = std::stoi(argv[++i]);
+        } else if (arg == "--help") {
+            std::cout << "Usage: bench_event_layout [--ops N]\n";
+            return 0;
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    int64_t sink = 0;
+    LayoutResult vec = run_layout<VectorEvent>(ops, sink);
+    LayoutResult inl = run_layout<MarketDataEvent>(ops, sink);
+
+    std::cout << "=== MARKET DATA EVENT LAYOUT ===\n";
+    std::cout << std::setw(10) << "layout" << std::setw(12) << "sizeof"
+              << std::setw(14) << "build ns/op" << std::setw(14) << "copy ns/op"
+              << std::setw(14) << "assign ns/op" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(10) << "vector" << std::setw(12) << sizeof(VectorEvent)
+              << std::setw(14) << vec.build_ns << std::setw(14) << vec.copy_ns
+              << std::setw(14) << vec.assign_ns << "\n";
+    std::cout << std::setw(10) << "inline" << std::setw(12) << sizeof(MarketDataEvent)
+              << std::setw(14) << inl.build_ns << std::setw(14) << inl.copy_ns
+              << std::setw(14) << inl.assign_ns << "\n";
+    std::cout << "================================\n";
+    std::cout << "(checksum " << sink << ")\n";
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "MarketMaker.h"
+#include "MarketSimulator.h"
+#include "include/HeuristicStrategy.h"
+#include "include/LatencyModel.h"
+#include "include/RiskManager.h"
+#include "include/SimulationConfig.h"
+
+namespace {
+
+struct SweepOptions {
+    int events = 20000;
+    int seeds = 3;
+    int64_t max_ns = 100000;
+    int64_t step_ns = 10000;
+    int markout_events = 50;
+    uint64_t tick_interval_ns = 1000;  // finer than the step, so each step moves arrivals by whole ticks
+    LatencyModel feed_latency;
+    LatencyModel ack_latency;
+    std::string jitter;  // optional lognormal sigma applied around each step's latency
+};
+
+struct FillQuality {
+    int64_t fills = 0;
+    int64_t filled_qty = 0;
+    double markout_ticks_sum = 0.0;  // size-weighted, positive = favourable to the maker
+    double total_pnl = 0.0;
+
+    // Price units per share
+    double markout_per_share() const {
+        return filled_qty == 0 ? 0.0 : markout_ticks_sum / static_cast<double>(filled_qty) / kTicksPerUnit;
+    }
+};
+
+struct PendingMarkout {
+    int due_event;
+    Side side;
+    Price price;
+    int qty;
+};
+
+LatencyModel step_model(int64_t latency_ns, const std::string& jitter) {
+    if (jitter.empty() || latency_ns == 0) {
+        return LatencyModel::constant(latency_ns);
+    }
+    return LatencyModel::lognormal(latency_ns, std::stod(jitter));
+}
+
+// One market maker run with order entry and cancels both at `latency_ns`.
+// Each fill is marked against the mid `markout_events` events after the MM
+// saw it.
+FillQuality run_once(const SweepOptions& opt, int64_t latency_ns, uint32_t seed) {
+    SimulationConfig config;
+    config.seed = seed;
+    config.iterations = opt.events;
+    config.latency_ms = 0;
+    config.quiet = true;
+    config.tick_interval_ns = opt.tick_interval_ns;
+    config.feed_latency = opt.feed_latency;
+    config.ack_latency = opt.ack_latency;
+    config.order_latency = step_model(latency_ns, opt.jitter);
+    config.cancel_latency = config.order_latency;
+
+    // Quote and cancel rates are counted per second of event time; at
+    // microsecond ticks the default limits would stop quoting
+    RiskConfig risk_cfg;
+    risk_cfg.max_net_position = 1000000;
+    risk_cfg.max_notional_exposure = 1e12;
+    risk_cfg.max_drawdown = 1e12;
+    risk_cfg.max_quotes_per_second = 1e12;
+    risk_cfg.max_cancels_per_second = 1e12;
+
+    MarketSimulator simulator(config);
+    MarketMaker mm(risk_cfg, std::make_unique<HeuristicStrategy>());
+
+    FillQuality quality;
+    std::vector<PendingMarkout> pending;
+    std::size_t next_pending = 0;
+    MarketDataEvent md;
+    for (int i = 0; i < opt.events; ++i) {
+        simulator.generate_event(md);
+        // In ticks; a one-tick spread puts the mid on a half tick
+        const double mid = (static_cast<double>(md.best_bid_price) + static_cast<double>(md.best_ask_price)) / 2.0;
+
+        while (next_pending < pending.size() && pending[next_pending].due_event <= i) {
+            const PendingMarkout& p = pending[next_pending++];
+            const double price = static_cast<double>(p.price);
+            const double edge = p.side == Side::BUY ? mid - price : price - mid;
+            quality.markout_ticks_sum += edge * p.qty;
+        }
+        for (const auto& fill : md.mm_fills) {
+            ++quality.fills;
+            quality.filled_qty += fill.fill_qty;
+            pending.push_back(PendingMarkout{i + opt.markout_events, fill.side, fill.price, fill.fill_qty});
+        }
+        mm.on_market_data(md, simulator);
+    }
+    // Fills too close to the end to mark out are left out of the average
+    for (std::size_t k = next_pending; k < pending.size(); ++k) {
+        --quality.fills;
+        quality.filled_qty -= pending[k].qty;
+    }
+    quality.total_pnl = mm.get_total_pnl();
+    return quality;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SweepOptions opt;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--events" && i + 1 < argc) {
+                opt.events = std::stoi(argv[++i]);
+            } else if (arg == "--seeds" && i + 1 < argc) {
+                opt.seeds = std::stoi(argv[++i]);
+            } else if (arg == "--max" && i + 1 < argc) {
+                opt.max_ns = latency_detail::parse_duration_ns(argv[++i]);
+            } else if (arg == "--step" && i + 1 < argc) {
+                opt.step_ns = latency_detail::parse_duration_ns(argv[++i]);
+            } else if (arg == "--tick-interval" && i + 1 < argc) {
+                opt.tick_interval_ns = static_cast<uint64_t>(latency_detail::parse_duration_ns(argv[++i]));
+            } else if (arg == "--markout-events" && i + 1 < argc) {
+                opt.markout_events = std::stoi(argv[++i]);
+            } else if (arg == "--feed-latency" && i + 1 < argc) {
+                opt.feed_latency = parse_latency_model(argv[++i]);
+            } else if (arg == "--ack-latency" && i + 1 < argc) {
+                opt.ack_latency = parse_latency_model(argv[++i]);
+            } else if (arg == "--jitter-sigma" && i + 1 < argc) {
+                opt.jitter = argv[++i];
+            } else if (arg == "--help") {
+                std::cout << "Usage: bench_latency_sweep [--events N] [--seeds N] [--max D] [--step D]\n"
+                          << "                           [--tick-interval D] [--markout-events N]\n"
+                          << "                           [--feed-latency SPEC] [--ack-latency SPEC] [--jitter-sigma S]\n";
+                return 0;
+            } else {
+                std::cerr << "Unknown argument: " << arg << "\n";
+                return 1;
+            }
+        }
+        if (opt.step_ns <= 0 || opt.max_ns < 0 || opt.tick_interval_ns == 0 || opt.seeds <= 0) {
+            throw std::invalid_argument("--step, --tick-interval and --seeds must be > 0");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Argument error: " << e.what() << "\n";
+        return 1;
+    }
+
+    // MarketMaker logs every fill; keep the table readable
+    std::cout.setstate(std::ios::failbit);
+    std::vector<std::pair<int64_t, FillQuality>> rows;
+    for (int64_t latency = 0; latency <= opt.max_ns; latency += opt.step_ns) {
+        FillQuality sum;
+        for (int s = 0; s < opt.seeds; ++s) {
+            FillQuality q = run_once(opt, latency, 42u + static_cast<uint32_t>(s));
+            sum.fills += q.fills;
+            sum.filled_qty += q.filled_qty;
+            sum.markout_ticks_sum += q.markout_ticks_sum;
+            sum.total_pnl += q.total_pnl / opt.seeds;
+        }
+        rows.emplace_back(latency, sum);
+    }
+    std::cout.clear();
+
+    std::cout << "=== FILL QUALITY vs ORDER/CANCEL LATENCY ===\n";
+    std::cout << "events=" << opt.events << " seeds=" << opt.seeds << " tick=" << opt.tick_interval_ns
+              << "ns markout=" << opt.markout_events << " events\n";
+    std::cout << std::setw(12) << "latency us" << std::setw(10) << "fills" << std::setw(12) << "filled qty"
+              << std::setw(16) << "markout/sh" << std::setw(14) << "avg pnl" << "\n";
+    std::cout << std::fixed;
+    for (const auto& row : rows) {
+        std::cout << std::setw(12) << std::setprecision(1) << static_cast<double>(row.first) / 1000.0
+                  << std::setw(10) << row.second.fills << std::setw(12) << row.second.filled_qty
+                  << std::setw(16) << std::setprecision(4) << row.second.markout_per_share()
+                  << std::setw(14) << std::setprecision(2) << row.second.total_pnl << "\n";
+    }
+
+    // Least-squares slope of markout against latency, scaled to 10 us
+    if (rows.size() >= 2) {
+        double n = static_cast<double>(rows.size()), sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (const auto& row : rows) {
+            const double x = static_cast<double>(row.first) / 10000.0;
+            const double y = row.second.markout_per_share();
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+        }
+        const double denom = n * sxx - sx * sx;
+        const double slope = denom == 0.0 ? 0.0 : (n * sxy - sx * sy) / denom;
+        std::cout << "markout change per +10us: " << std::setprecision(5) << slope << " per share\n";
+    }
+    std::cout << "============================================\n";
+    return 0;
+}
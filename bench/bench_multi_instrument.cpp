@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MultiInstrumentSimulator.h"
+#include "include/SimulationConfig.h"
+
+namespace {
+
+double run_shards(std::size_t instruments, std::size_t shards, int rounds, int batch_rounds,
+                  uint32_t seed, bool pin) {
+    MultiInstrumentConfig cfg;
+    cfg.base.seed = seed;
+    cfg.base.latency_ms = 0;
+    cfg.base.quiet = true;
+    for (std::size_t i = 0; i < instruments; ++i) {
+        cfg.instruments.push_back("SYM" + std::to_string(i));
+    }
+    cfg.shard_count = shards;
+    cfg.pin_threads = pin;
+
+    MultiInstrumentSimulator sim(cfg);
+    std::vector<TaggedEvent> events;
+    events.reserve(static_cast<std::size_t>(batch_rounds) * instruments);
+
+    std::size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int done = 0; done < rounds; done += batch_rounds) {
+        events.clear();
+        total += sim.generate_batch(std::min(batch_rounds, rounds - done), events);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return seconds > 0.0 ? static_cast<double>(total) / seconds : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t instruments = 256;
+    int rounds = 200;
+    int batch_rounds = 50;
+    uint32_t seed = 42;
+    bool pin = false;
+    std::size_t max_shards = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--instruments" && i + 1 < argc) {
+            instruments = static_cast<std::size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            rounds = std::stoi(argv[++i]);
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batch_rounds = std::stoi(argv[++i]);
+        } else if (arg == "--max-shards" && i + 1 < argc) {
+            max_shards = static_cast<std::size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--pin") {
+            pin = true;
+        } else if (arg == "--help") {
+            std::cout << "Usage: bench_multi_instrument [--instruments N] [--rounds N] [--batch N] "
+                         "[--max-shards N] [--seed N] [--pin]\n";
+            return 0;
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "=== MULTI-INSTRUMENT SHARD SCALING ===\n";
+    std::cout << instruments << " instruments x " << rounds << " rounds, batch " << batch_rounds
+              << (pin ? ", pinned" : "") << "\n";
+    std::cout << std::setw(8) << "shards" << std::setw(16) << "events/s" << std::setw(10) << "speedup" << "\n";
+
+    double baseline = 0.0;
+    for (std::size_t shards = 1; shards <= max_shards; shards *= 2) {
+        double rate = run_shards(instruments, shards, rounds, batch_rounds, seed, pin);
+        if (shards == 1) baseline = rate;
+        std::cout << std::setw(8) << shards << std::setw(16) << static_cast<int64_t>(rate)
+                  << std::setw(10) << std::fixed << std::setprecision(2)
+                  << (baseline > 0.0 ? rate / baseline : 0.0) << "\n";
+    }
+    std::cout << "======================================\n";
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "MatchingEngine.h"
+#include "Order.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct ScalingResult {
+    std::size_t resting = 0;
+    std::size_t levels = 0;
+    double add_ns = 0.0;
+    double cancel_ns = 0.0;
+    double match_ns = 0.0;
+};
+
+auto make_ts(int64_t ms) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
+}
+
+double elapsed_ns_per_op(Clock::time_point start, Clock::time_point end, int ops) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / ops;
+}
+
+// Resting orders are spread over up to 500 price levels per side so the book
+// grows deep in both queue length and level count.
+ScalingResult run_scaling(std::size_t resting, int ops, uint32_t seed) {
+    const Price kMid = to_ticks(100.0);
+    const int levels_per_side = static_cast<int>(std::min<std::size_t>(500, std::max<std::size_t>(1, resting / 2)));
+
+    MatchingEngine engine;
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> level_dist(1, levels_per_side);
+    std::uniform_int_distribution<int> qty_dist(1, 10);
+
+    uint64_t next_id = 1;
+    int64_t ts = 0;
+    std::vector<uint64_t> live_ids;
+    live_ids.reserve(resting);
+
+    auto add_random = [&](uint64_t id) {
+        Side side = (id % 2 == 0) ? Side::BUY : Side::SELL;
+        Price offset = level_dist(rng);
+        Price price = side == Side::BUY ? kMid - offset : kMid + offset;
+        return engine.add_order(Order(id, side, price, qty_dist(rng), make_ts(++ts)));
+    };
+
+    for (std::size_t i = 0; i < resting; ++i) {
+        add_random(next_id);
+        live_ids.push_back(next_id++);
+    }
+
+    ScalingResult result;
+    result.resting = engine.resting_order_count();
+    result.levels = engine.bid_level_count() + engine.ask_level_count();
+
+    // Cancel distinct random resting orders, then re-add the same count so depth is preserved
+    std::vector<std::size_t> victims(live_ids.size());
+    for (std::size_t i = 0; i < victims.size(); ++i) {
+        victims[i] = i;
+    }
+    std::shuffle(victims.begin(), victims.end(), rng);
+    victims.resize(std::min(victims.size(), static_cast<std::size_t>(ops)));
+    const int cycle_ops = static_cast<int>(victims.size());
+
+    auto cancel_start = Clock::now();
+    for (std::size_t v : victims) {
+        engine.cancel_order(live_ids[v]);
+    }
+    auto cancel_end = Clock::now();
+    result.cancel_ns = elapsed_ns_per_op(cancel_start, cancel_end, cycle_ops);
+
+    auto add_start = Clock::now();
+    for (std::size_t v : victims) {
+        add_random(next_id);
+        live_ids[v] = next_id++;
+    }
+    auto add_end = Clock::now();
+    result.add_ns = elapsed_ns_per_op(add_start, add_end, cycle_ops);
+
+    // Small aggressive orders against the top of book; each call fills at most one lot
+    auto match_start = Clock::now();
+    std::size_t fills = 0;
+    for (int i = 0; i < ops; ++i) {
+        Side aggressor = (i % 2 == 0) ? Side::BUY : Side::SELL;
+        Price limit = aggressor == Side::BUY ? kMid + levels_per_side : kMid - levels_per_side;
+        fills += engine.match_incoming_order(aggressor, limit, 1, static_cast<uint64_t>(i), make_ts(++ts)).size();
+    }
+    auto match_end = Clock::now();
+    result.match_ns = elapsed_ns_per_op(match_start, match_end, ops);
+
+    if (fills == 0 && resting > 0) {
+        std::cerr << "warning: no fills generated at depth " << resting << "\n";
+    }
+    return result;
+}
+
+struct DepthResult {
+    double add_ns = 0.0;
+    double cancel_ns = 0.0;
+    double sweep_ns = 0.0;
+};
+
+constexpr Price kLevelSpacing = 3;   // occupied levels are kLevelSpacing ticks apart
+constexpr int kOrdersPerLevel = 2;
+constexpr int kSweepLevels = 4;
+
+// Fixed-depth book with the same order flow for map and ladder modes. Levels
+// are spaced apart so the ladder has empty slots between occupied ones.
+DepthResult run_depth(int depth, int ops, uint32_t seed, bool ladder) {
+    const Price kMid = to_ticks(100.0);
+    const std::size_t half_width = ladder ? static_cast<std::size_t>(depth * kLevelSpacing + kLevelSpacing) : 0;
+    MatchingEngine engine(static_cast<std::size_t>(depth) * kOrdersPerLevel * 2 + 64,
+                          TickLadderConfig{kMid, half_width});
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> level_dist(1, depth);
+    uint64_t next_id = 1;
+    int64_t ts = 0;
+
+    auto level_price = [kMid](Side side, int level) {
+        return side == Side::BUY ? kMid - level * kLevelSpacing : kMid + level * kLevelSpacing;
+    };
+
+    std::vector<uint64_t> live_ids;
+    for (int level = 1; level <= depth; ++level) {
+        for (int k = 0; k < kOrdersPerLevel; ++k) {
+            for (Side side : {Side::BUY, Side::SELL}) {
+                engine.add_order(Order(next_id, side, level_price(side, level), 5, make_ts(++ts)));
+                live_ids.push_back(next_id++);
+            }
+        }
+    }
+
+    DepthResult result;
+
+    // Cancel random resting orders, then add the same number back at random levels
+    std::vector<std::size_t> victims(live_ids.size());
+    for (std::size_t i = 0; i < victims.size(); ++i) {
+        victims[i] = i;
+    }
+    std::shuffle(victims.begin(), victims.end(), rng);
+    victims.resize(std::min(victims.size(), static_cast<std::size_t>(ops)));
+    const int cycle_ops = static_cast<int>(victims.size());
+
+    auto cancel_start = Clock::now();
+    for (std::size_t v : victims) {
+        engine.cancel_order(live_ids[v]);
+    }
+    auto cancel_end = Clock::now();
+    result.cancel_ns = elapsed_ns_per_op(cancel_start, cancel_end, cycle_ops);
+
+    auto add_start = Clock::now();
+    for (std::size_t v : victims) {
+        Side side = (v % 2 == 0) ? Side::BUY : Side::SELL;
+        engine.add_order(Order(next_id, side, level_price(side, level_dist(rng)), 5, make_ts(++ts)));
+        live_ids[v] = next_id++;
+    }
+    auto add_end = Clock::now();
+    result.add_ns = elapsed_ns_per_op(add_start, add_end, cycle_ops);
+
+    // Sweep the top kSweepLevels ask levels, then repost them so depth holds steady
+    const int sweep_qty = kSweepLevels * kOrdersPerLevel * 5;
+    const Price sweep_limit = level_price(Side::SELL, depth);
+    std::size_t fills = 0;
+    auto sweep_start = Clock::now();
+    for (int i = 0; i < ops; ++i) {
+        engine.match_incoming_order_with(Side::BUY, sweep_limit, sweep_qty, static_cast<uint64_t>(i), make_ts(++ts),
+                                         [&fills](const FillEvent&) { ++fills; });
+        for (int level = 1; level <= kSweepLevels; ++level) {
+            engine.add_order(Order(next_id++, Side::SELL, level_price(Side::SELL, level),
+                                   kOrdersPerLevel * 5, make_ts(++ts)));
+        }
+    }
+    auto sweep_end = Clock::now();
+    result.sweep_ns = elapsed_ns_per_op(sweep_start, sweep_end, ops);
+
+    if (fills == 0) {
+        std::cerr << "warning: no sweep fills at depth " << depth << "\n";
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t max_orders = 1000000;
+    int ops = 100000;
+    uint32_t seed = 42;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--max-orders" && i + 1 < argc) {
+            max_orders = static_cast<std::size_t>(std::stoull(argv[++i]));
+        } else if (arg == "--ops" && i + 1 < argc) {
+            ops = std::stoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--help") {
+            std::cout << "Usage: bench_order_book [--max-orders N] [--ops N] [--seed N]\n";
+            return 0;
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "=== ORDER BOOK SCALING ===\n";
+    std::cout << std::setw(10) << "resting" << std::setw(10) << "levels"
+              << std::setw(14) << "add ns/op" << std::setw(14) << "cancel ns/op"
+              << std::setw(14) << "match ns/op" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (std::size_t n = 10; n <= max_orders; n *= 10) {
+        ScalingResult r = run_scaling(n, ops, seed);
+        std::cout << std::setw(10) << r.resting << std::setw(10) << r.levels
+                  << std::setw(14) << r.add_ns << std::setw(14) << r.cancel_ns
+                  << std::setw(14) << r.match_ns << "\n";
+    }
+    std::cout << "==========================\n";
+
+    std::cout << "\n=== MAP vs TICK LADDER BY DEPTH ===\n";
+    std::cout << std::setw(8) << "depth" << std::setw(8) << "book"
+              << std::setw(14) << "add ns/op" << std::setw(14) << "cancel ns/op"
+              << std::setw(14) << "sweep ns/op" << "\n";
+    for (int depth : {5, 500, 50000}) {
+        for (bool ladder : {false, true}) {
+            DepthResult r = run_depth(depth, ops, seed, ladder);
+            std::cout << std::setw(8) << depth << std::setw(8) << (ladder ? "ladder" : "map")
+                      << std::setw(14) << r.add_ns << std::setw(14) << r.cancel_ns
+                      << std::setw(14) << r.sweep_ns << "\n";
+        }
+    }
+    std::cout << "===================================\n";
+    return 0;
+}
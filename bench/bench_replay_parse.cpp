@@ -0,0 +1,386 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "MarketSimulator.h"
+#include "include/BinaryCaptureReader.h"
+#include "include/BinaryLogger.h"
+#include "include/EventLogParser.h"
+#include "include/ParallelReplayReader.h"
+#include "include/ReplaySource.h"
+#include "include/SequenceIndex.h"
+#include "include/SimulationConfig.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The previous deserializer: split() into vectors of strings at three
+// levels, then std::stod / std::stoi / std::stoull per token
+std::vector<std::string> split(const std::string& input, char delimiter) {
+    std::vector<std::string> out;
+    std::size_t start = 0;
+    std::size_t pos = input.find(delimiter);
+    while (pos != std::string::npos) {
+        out.push_back(input.substr(start, pos - start));
+        start = pos + 1;
+        pos = input.find(delimiter, start);
+    }
+    out.push_back(input.substr(start));
+    return out;
+}
+
+std::chrono::system_clock::time_point from_millis(int64_t ms) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
+}
+
+MarketDataEvent legacy_parse(const std::string& line) {
+    const auto fields = split(line, '|');
+    if (fields.size() != 11) {
+        throw std::runtime_error("Malformed replay log line");
+    }
+    MarketDataEvent event;
+    event.instrument_id = InstrumentRegistry::global().intern(fields[1]);
+    event.best_bid_price = to_ticks(std::stod(fields[2]));
+    event.best_ask_price = to_ticks(std::stod(fields[3]));
+    event.best_bid_size = std::stoi(fields[4]);
+    event.best_ask_size = std::stoi(fields[5]);
+    event.timestamp = from_millis(std::stoll(fields[6]));
+    for (int side = 7; side <= 8; ++side) {
+        LevelList& levels = side == 7 ? event.bid_levels : event.ask_levels;
+        for (const auto& entry : split(fields[side], ';')) {
+            if (entry.empty()) continue;
+            const auto t = split(entry, ',');
+            levels.emplace_back(to_ticks(std::stod(t.at(0))), std::stoi(t.at(1)), std::stoull(t.at(2)),
+                                from_millis(std::stoll(t.at(3))));
+        }
+    }
+    for (const auto& entry : split(fields[9], ';')) {
+        if (entry.empty()) continue;
+        const auto t = split(entry, ',');
+        event.trades.push_back(Trade{t.at(0) == "BUY" ? Side::BUY : Side::SELL, to_ticks(std::stod(t.at(1))),
+                                     std::stoi(t.at(2)), std::stoull(t.at(3)), from_millis(std::stoll(t.at(4)))});
+    }
+    for (const auto& entry : split(fields[10], ';')) {
+        if (entry.empty()) continue;
+        const auto t = split(entry, ',');
+        event.partial_fills.push_back(PartialFillEvent{std::stoull(t.at(0)), to_ticks(std::stod(t.at(1))),
+                                                       std::stoi(t.at(2)), std::stoi(t.at(3)),
+                                                       from_millis(std::stoll(t.at(4)))});
+    }
+    event.sequence_number = std::stoll(fields[0]);
+    return event;
+}
+
+uint64_t digest(uint64_t h, const MarketDataEvent& ev) {
+    h = h * 1099511628211ULL ^ static_cast<uint64_t>(ev.sequence_number);
+    h = h * 1099511628211ULL ^ static_cast<uint64_t>(ev.best_bid_price + ev.best_ask_price);
+    for (const auto& level : ev.bid_levels) h = h * 1099511628211ULL ^ static_cast<uint64_t>(level.price + level.size);
+    for (const auto& level : ev.ask_levels) h = h * 1099511628211ULL ^ static_cast<uint64_t>(level.price + level.size);
+    for (const auto& trade : ev.trades) h = h * 1099511628211ULL ^ static_cast<uint64_t>(trade.price * trade.size);
+    for (const auto& fill : ev.partial_fills) h = h * 1099511628211ULL ^ fill.order_id;
+    return h;
+}
+
+struct ParseResult {
+    double seconds = 0.0;
+    int64_t events = 0;
+    uint64_t checksum = 1469598103934665603ULL;
+};
+
+template <typename ParseFn>
+ParseResult run_parser(const std::string& path, ParseFn&& parse) {
+    ReplaySource source;
+    if (!source.open(path)) {
+        throw std::runtime_error("Cannot map " + path);
+    }
+    ParseResult result;
+    const char* line = nullptr;
+    std::size_t len = 0;
+    const auto start = Clock::now();
+    while (source.next_line(line, len)) {
+        result.checksum = digest(result.checksum, parse(std::string_view(line, len)));
+        ++result.events;
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+// MarketSimulator in replay mode, end to end through generate_event
+ParseResult run_replay(const SimulationConfig& replay) {
+    ParseResult result;
+    const auto start = Clock::now();
+    MarketSimulator simulator(replay);
+    MarketDataEvent md;
+    for (;;) {
+        try {
+            simulator.generate_event(md);
+        } catch (const std::out_of_range&) {
+            break;
+        }
+        result.checksum = digest(result.checksum, md);
+        ++result.events;
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+// Binary capture read in place: the same digest straight off the mapped
+// records, without building events
+ParseResult run_capture_scan(const std::string& path) {
+    BinaryCaptureReader reader;
+    if (!reader.open(path)) {
+        throw std::runtime_error("Cannot map " + path);
+    }
+    ParseResult result;
+    BinaryCaptureReader::EventView view;
+    uint64_t h = result.checksum;
+    const auto start = Clock::now();
+    while (reader.next_view(view)) {
+        h = h * 1099511628211ULL ^ static_cast<uint64_t>(view.header->sequence_number);
+        h = h * 1099511628211ULL ^ static_cast<uint64_t>(view.header->best_bid_price + view.header->best_ask_price);
+        for (const auto& level : view.bids) h = h * 1099511628211ULL ^ static_cast<uint64_t>(level.price + level.size);
+        for (const auto& level : view.asks) h = h * 1099511628211ULL ^ static_cast<uint64_t>(level.price + level.size);
+        for (const auto& trade : view.trades) h = h * 1099511628211ULL ^ static_cast<uint64_t>(trade.price * trade.size);
+        for (const auto& fill : view.partial_fills) h = h * 1099511628211ULL ^ fill.order_id;
+        ++result.events;
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.checksum = h;
+    return result;
+}
+
+// The chunked reader on `threads` workers, events taken in file order
+ParseResult run_parallel(const std::string& path, std::size_t threads) {
+    ParallelReplayReader reader;
+    ParseResult result;
+    const auto start = Clock::now();
+    if (!reader.open(path, threads)) {
+        throw std::runtime_error("Cannot map " + path);
+    }
+    MarketDataEvent md;
+    while (reader.next(md)) {
+        result.checksum = digest(result.checksum, md);
+        ++result.events;
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+// Seconds from constructing a replay that starts at `start_seq` to having
+// its first event, with the log's sequence index or, if `indexed` is false,
+// with the index moved aside so replay reads from the start
+double time_to_start(SimulationConfig config, int64_t start_seq, bool indexed) {
+    const std::string index_path = sequence_index::path_for(config.replay_log_path);
+    const std::string aside = index_path + ".aside";
+    if (!indexed) {
+        std::rename(index_path.c_str(), aside.c_str());
+    }
+    config.replay_start_sequence = start_seq;
+    const auto start = Clock::now();
+    MarketSimulator simulator(config);
+    MarketDataEvent md;
+    simulator.generate_event(md);
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (!indexed) {
+        std::rename(aside.c_str(), index_path.c_str());
+    }
+    if (md.sequence_number != start_seq) {
+        throw std::runtime_error("Replay started at sequence " + std::to_string(md.sequence_number));
+    }
+    return seconds;
+}
+
+std::vector<std::size_t> parse_list(const std::string& s) {
+    std::vector<std::size_t> out;
+    std::size_t start = 0;
+    while (start < s.size()) {
+        std::size_t comma = s.find(',', start);
+        comma = comma == std::string::npos ? s.size() : comma;
+        out.push_back(static_cast<std::size_t>(std::stoull(s.substr(start, comma - start))));
+        start = comma + 1;
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int events = 2000000;
+    std::size_t depth = 5;
+    std::string path = "/tmp/bench_replay_parse.log";
+    bool keep = false;
+    std::vector<std::size_t> thread_counts = {1, 2, 4, 8};
+    uint32_t snapshot_interval = BinaryLogger::kDefaultSnapshotInterval;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--events" && i + 1 < argc) {
+            events = std::stoi(argv[++i]);
+        } else if (arg == "--book-depth" && i + 1 < argc) {
+            depth = static_cast<std::size_t>(std::stoull(argv[++i]));
+        } else if (arg == "--log" && i + 1 < argc) {
+            path = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            thread_counts = parse_list(argv[++i]);
+        } else if (arg == "--snapshot-interval" && i + 1 < argc) {
+            snapshot_interval = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--keep") {
+            keep = true;
+        } else if (arg == "--help") {
+            std::cout << "Usage: bench_replay_parse [--events N] [--book-depth N] [--log PATH] [--threads N,N,...] [--snapshot-interval N] [--keep]\n";
+            return 0;
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    const std::string capture_path = path + ".bin";
+    const std::string snapshots_path = path + ".snapshots.bin";  // the same capture without deltas
+    try {
+        // Generate the log once with the simulator's own writers
+        {
+            SimulationConfig config;
+            config.latency_ms = 0;
+            config.quiet = true;
+            config.book_depth = depth;
+            config.event_log_path = path;
+            MarketSimulator writer(config);
+            BinaryLogger capture(capture_path, snapshot_interval);
+            BinaryLogger snapshots(snapshots_path, 1);
+            MarketDataEvent md;
+            for (int i = 0; i < events; ++i) {
+                writer.generate_event(md);
+                capture.log_event(md);
+                snapshots.log_event(md);
+            }
+        }
+
+        const ParseResult legacy = run_parser(path, [](std::string_view line) {
+            return legacy_parse(std::string(line));
+        });
+
+        EventLogParser parser;
+        MarketDataEvent reused;
+        const ParseResult fast = run_parser(path, [&](std::string_view line) -> const MarketDataEvent& {
+            parser.parse(line, reused);
+            return reused;
+        });
+
+        // End to end: MarketSimulator in replay mode over the same log
+        SimulationConfig replay;
+        replay.mode = SimulationMode::Replay;
+        replay.replay_log_path = path;
+        const ParseResult sim = run_replay(replay);
+
+        // The same events from the binary captures
+        const ParseResult snapshot_scan = run_capture_scan(snapshots_path);
+        const ParseResult scan = run_capture_scan(capture_path);
+        ParseResult decoded;
+        {
+            BinaryCaptureReader reader;
+            reader.open(capture_path);
+            MarketDataEvent md;
+            const auto start = Clock::now();
+            while (reader.next(md)) {
+                decoded.checksum = digest(decoded.checksum, md);
+                ++decoded.events;
+            }
+            decoded.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        replay.replay_log_path = capture_path;
+        replay.replay_format = ReplayFormat::Binary;
+        const ParseResult binary_sim = run_replay(replay);
+
+        // Starting 90% of the way in, with and without the sequence index
+        const int64_t start_seq = std::max<int64_t>(1, static_cast<int64_t>(events) * 9 / 10);
+        replay.replay_log_path = path;
+        replay.replay_format = ReplayFormat::Text;
+        const double text_seek = time_to_start(replay, start_seq, true);
+        const double text_scan = time_to_start(replay, start_seq, false);
+        replay.replay_log_path = capture_path;
+        replay.replay_format = ReplayFormat::Binary;
+        const double binary_seek = time_to_start(replay, start_seq, true);
+        const double binary_scan = time_to_start(replay, start_seq, false);
+
+        std::vector<ParseResult> parallel;
+        for (std::size_t threads : thread_counts) {
+            parallel.push_back(run_parallel(path, threads));
+        }
+        bool match = legacy.checksum == fast.checksum && fast.checksum == sim.checksum;
+        for (const auto& r : parallel) {
+            match = match && r.checksum == fast.checksum && r.events == fast.events;
+        }
+        for (const ParseResult& r : {snapshot_scan, scan, decoded, binary_sim}) {
+            match = match && r.checksum == fast.checksum && r.events == fast.events;
+        }
+
+        ReplaySource sizer;
+        sizer.open(path);
+        const double mb = static_cast<double>(sizer.size()) / (1024.0 * 1024.0);
+        sizer.open(capture_path);
+        const double capture_mb = static_cast<double>(sizer.size()) / (1024.0 * 1024.0);
+        sizer.open(snapshots_path);
+        const double snapshots_mb = static_cast<double>(sizer.size()) / (1024.0 * 1024.0);
+
+        std::cout << "=== REPLAY PARSE THROUGHPUT ===\n";
+        std::cout << "log: " << events << " events, depth " << depth << ", " << std::fixed << std::setprecision(1)
+                  << mb << " MB text\n";
+        std::cout << "binary capture: " << snapshots_mb << " MB snapshots only, " << capture_mb
+                  << " MB with deltas (snapshot every " << snapshot_interval << "), "
+                  << std::setprecision(2) << snapshots_mb / capture_mb << "x smaller\n"
+                  << std::setprecision(1);
+        std::cout << std::setw(22) << "parser" << std::setw(14) << "events/s" << std::setw(10) << "MB/s"
+                  << std::setw(12) << "ns/event" << "\n";
+        auto row = [&](const char* name, const ParseResult& r, double size_mb) {
+            std::cout << std::setw(22) << name << std::setw(14) << static_cast<int64_t>(r.events / r.seconds)
+                      << std::setw(10) << std::setprecision(1) << size_mb / r.seconds << std::setw(12)
+                      << std::setprecision(0) << r.seconds * 1e9 / static_cast<double>(r.events) << "\n";
+        };
+        row("split + stod", legacy, mb);
+        row("from_chars", fast, mb);
+        row("replay generate_event", sim, mb);
+        for (std::size_t i = 0; i < parallel.size(); ++i) {
+            const std::string name = "parallel x" + std::to_string(thread_counts[i]);
+            row(name.c_str(), parallel[i], mb);
+        }
+        row("snapshots in place", snapshot_scan, snapshots_mb);
+        row("binary scan (deltas)", scan, capture_mb);
+        row("binary decode", decoded, capture_mb);
+        row("binary generate_event", binary_sim, capture_mb);
+        std::cout << "start at seq " << start_seq << ": text " << std::setprecision(2) << text_seek * 1e3
+                  << " ms indexed vs " << text_scan * 1e3 << " ms reading from the start, binary "
+                  << binary_seek * 1e3 << " ms vs " << binary_scan * 1e3 << " ms\n";
+        std::cout << "speedup: " << std::setprecision(2) << legacy.seconds / fast.seconds << "x\n";
+        std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+        std::cout << "checksums " << (match ? "match" : "DIFFER") << "\n";
+        std::cout << "===============================\n";
+
+        if (!keep) {
+            std::remove(path.c_str());
+            std::remove(sequence_index::path_for(path).c_str());
+            std::remove(capture_path.c_str());
+            std::remove(sequence_index::path_for(capture_path).c_str());
+            std::remove(snapshots_path.c_str());
+            std::remove(sequence_index::path_for(snapshots_path).c_str());
+        }
+        return match ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << "\n";
+        std::remove(path.c_str());
+        std::remove(sequence_index::path_for(path).c_str());
+        std::remove(capture_path.c_str());
+        std::remove(sequence_index::path_for(capture_path).c_str());
+        std::remove(snapshots_path.c_str());
+        std::remove(sequence_index::path_for(snapshots_path).c_str());
+        return 1;
+    }
+}
@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "include/Philox.h"
+#include "include/RandomBatch.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ns_per_op(Clock::time_point start, Clock::time_point end, int ops) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / ops;
+}
+
+// The book-update draw of one event at `levels` levels a side: a price jitter
+// and a size change per level, drawn one call at a time
+template <typename Rng>
+double scalar_event(Rng& rng, std::size_t levels) {
+    std::uniform_real_distribution<> noise_dist(-0.001, 0.001);
+    std::uniform_int_distribution<> size_change_dist(-2, 2);
+    double acc = 0.0;
+    for (std::size_t i = 0; i < 2 * levels; ++i) {
+        acc += noise_dist(rng);
+        acc += size_change_dist(rng);
+    }
+    return acc;
+}
+
+// The same draw through the fixed conversions one word at a time, as the
+// simulator does below kMinBatchLevels: jitters first, then size changes
+double stream_event(PhiloxStream& rng, std::size_t levels) {
+    const std::size_t n = 2 * levels;
+    double acc = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        acc += random_batch::next_uniform(rng, -0.001, 0.001);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        acc += random_batch::next_int(rng, -2, 2);
+    }
+    return acc;
+}
+
+double batch_event(RandomBatch& batch, uint64_t event, std::size_t levels) {
+    const std::size_t n = 2 * levels;
+    batch.draw(2, event, 2 * n);
+    const double* jitter = batch.uniforms(0, n, -0.001, 0.001);
+    const int* size_change = batch.ints(n, n, -2, 2);
+    double acc = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        acc += jitter[i] + size_change[i];
+    }
+    return acc;
+}
+
+struct Row {
+    double mt19937_ns;
+    double philox_ns;
+    double stream_ns;
+    double batch_ns;
+};
+
+Row run_levels(std::size_t levels, int events, double& sink) {
+    Row row{};
+    const uint64_t key = PhiloxStream::make_key(42, 1);
+
+    std::mt19937 mt(42);
+    auto start = Clock::now();
+    for (int e = 0; e < events; ++e) {
+        sink += scalar_event(mt, levels);
+    }
+    row.mt19937_ns = elapsed_ns_per_op(start, Clock::now(), events);
+
+    PhiloxStream philox(key);
+    start = Clock::now();
+    for (int e = 0; e < events; ++e) {
+        philox.reset(2, static_cast<uint64_t>(e));
+        sink += scalar_event(philox, levels);
+    }
+    row.philox_ns = elapsed_ns_per_op(start, Clock::now(), events);
+
+    start = Clock::now();
+    for (int e = 0; e < events; ++e) {
+        philox.reset(2, static_cast<uint64_t>(e));
+        sink += stream_event(philox, levels);
+    }
+    row.stream_ns = elapsed_ns_per_op(start, Clock::now(), events);
+
+    RandomBatch batch(key);
+    batch.reserve(4 * levels);
+    start = Clock::now();
+    for (int e = 0; e < events; ++e) {
+        sink += batch_event(batch, static_cast<uint64_t>(e), levels);
+    }
+    row.batch_ns = elapsed_ns_per_op(start, Clock::now(), events);
+    return row;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int events = 200000;
+    int normals = 4000000;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--events" && i + 1 < argc) {
+            events = std::stoi(argv[++i]);
+        } else if (arg == "--normals" && i + 1 < argc) {
+            normals = std::stoi(argv[++i]);
+        } else if (arg == "--help") {
+            std::cout << "Usage: bench_rng [--events N] [--normals N]\n";
+            return 0;
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    double sink = 0.0;
+    std::cout << "=== BOOK UPDATE RANDOM DRAWS (ns/event) ===\n";
+    std::cout << std::setw(8) << "levels" << std::setw(14) << "mt19937" << std::setw(14) << "philox"
+              << std::setw(14) << "stream" << std::setw(14) << "batch" << std::setw(10) << "speedup" << "\n";
+    std::cout << std::fixed;
+    for (std::size_t levels : {2, 5, 8, 16, 50, 500}) {
+        // Keep the total draw count roughly constant across rows
+        const int n = std::max(1000, static_cast<int>(events * 5 / levels));
+        const Row row = run_levels(levels, n, sink);
+        // The simulator takes the stream path below kMinBatchWords
+        const double sim_ns = 4 * levels < random_batch::kMinBatchWords ? row.stream_ns : row.batch_ns;
+        std::cout << std::setw(8) << levels << std::setprecision(1) << std::setw(14) << row.mt19937_ns
+                  << std::setw(14) << row.philox_ns << std::setw(14) << row.stream_ns << std::setw(14) << row.batch_ns << std::setprecision(2)
+                  << std::setw(9) << row.mt19937_ns / sim_ns << "x\n";
+    }
+
+    // Normals: std::normal_distribution one at a time vs Box-Muller blocks
+    std::mt19937 mt(42);
+    std::normal_distribution<> dist(0.0, 1.0);
+    auto start = Clock::now();
+    for (int i = 0; i < normals; ++i) {
+        sink += dist(mt);
+    }
+    const double scalar_ns = elapsed_ns_per_op(start, Clock::now(), normals);
+
+    const std::size_t block = 1024;
+    RandomBatch batch(PhiloxStream::make_key(42, 1));
+    batch.reserve(block);
+    start = Clock::now();
+    for (int done = 0, index = 0; done < normals; done += static_cast<int>(block), ++index) {
+        batch.draw(1, static_cast<uint64_t>(index), block);
+        const double* z = batch.normals(0, block, 0.0, 1.0);
+        for (std::size_t i = 0; i < block; ++i) {
+            sink += z[i];
+        }
+    }
+    const double batch_ns = elapsed_ns_per_op(start, Clock::now(), normals);
+
+    std::cout << "normals: mt19937+normal_distribution " << std::setprecision(2) << scalar_ns
+              << " ns, batch Box-Muller " << batch_ns << " ns (" << scalar_ns / batch_ns << "x)\n";
+    std::cout << "===========================================\n";
+    std::cout << "(checksum " << sink << ")\n";
+    return 0;
+}
@@ -0,0 +1,347 @@
+#ifndef ASYNC_EVENT_LOG_H
+#define ASYNC_EVENT_LOG_H
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../MarketDataEvent.h"
+#include "InstrumentRegistry.h"
+#include "Price.h"
+#include "SequenceIndex.h"
+
+// Text event log line formatting, the inverse of EventLogParser:
+//
+//   seq|symbol|bid|ask|bid_size|ask_size|ts_ms|bid_levels|ask_levels|trades|partial_fills
+//
+// Timestamps are milliseconds since the epoch; one that does not fall on a
+// whole millisecond (sub-ms ticks, --tick-interval) gets a six-digit
+// fraction, ts_ms.nnnnnn, with the remaining nanoseconds, so logs of
+// millisecond runs are unchanged and finer clocks still round-trip.
+// Prices are written from ticks in integer arithmetic with kPriceDecimals
+// fractional digits, which is what std::fixed with that precision printed
+// for from_ticks(price), and integers go through std::to_chars. Lines are
+// written through a raw pointer into space the caller sized with
+// max_line_size(), so there is no per-token bounds check or allocation.
+namespace event_log {
+
+// Longest text of any integer field, sign included
+constexpr std::size_t kMaxIntChars = 20;
+constexpr std::size_t kMaxPriceChars = kMaxIntChars + 1 + kPriceDecimals;
+constexpr int kNanosDecimals = 6;  // digits of the sub-millisecond fraction
+constexpr std::size_t kMaxTimeChars = kMaxIntChars + 1 + kNanosDecimals;
+
+template <typename T>
+inline char* write_int(char* p, T value) {
+    return std::to_chars(p, p + kMaxIntChars, value).ptr;
+}
+
+inline char* write_price(char* p, Price ticks) {
+    if (ticks < 0) {
+        *p++ = '-';
+    }
+    const uint64_t magnitude = ticks < 0 ? 0 - static_cast<uint64_t>(ticks) : static_cast<uint64_t>(ticks);
+    p = write_int(p, magnitude / kTicksPerUnit);
+    *p = '.';
+    uint64_t rest = magnitude % kTicksPerUnit;
+    for (int d = kPriceDecimals; d > 0; --d) {
+        p[d] = static_cast<char>('0' + rest % 10);
+        rest /= 10;
+    }
+    return p + kPriceDecimals + 1;
+}
+
+inline char* write_millis(char* p, std::chrono::system_clock::time_point ts) {
+    const auto ms = std::chrono::floor<std::chrono::milliseconds>(ts.time_since_epoch());
+    p = write_int(p, ms.count());
+    int64_t rest = std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch() - ms).count();
+    if (rest == 0) {
+        return p;
+    }
+    *p = '.';
+    for (int d = kNanosDecimals; d > 0; --d) {
+        p[d] = static_cast<char>('0' + rest % 10);
+        rest /= 10;
+    }
+    return p + kNanosDecimals + 1;
+}
+
+// Upper bound on the bytes write_event() produces for `event`
+inline std::size_t max_line_size(const MarketDataEvent& event, std::size_t symbol_size) {
+    constexpr std::size_t kLevel = kMaxPriceChars + 2 * kMaxIntChars + kMaxTimeChars + 4;
+    constexpr std::size_t kTrade = 5 + kMaxPriceChars + 2 * kMaxIntChars + kMaxTimeChars + 4;
+    constexpr std::size_t kFill = kMaxPriceChars + 3 * kMaxIntChars + kMaxTimeChars + 5;
+    return symbol_size + 2 * kMaxPriceChars + 3 * kMaxIntChars + kMaxTimeChars + 16 +
+           (event.bid_levels.size() + event.ask_levels.size()) * kLevel + event.trades.size() * kTrade +
+           event.partial_fills.size() * kFill;
+}
+
+inline char* write_levels(char* p, const LevelList& levels) {
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        const auto& level = levels[i];
+        if (i > 0) *p++ = ';';
+        p = write_price(p, level.price);
+        *p++ = ',';
+        p = write_int(p, level.size);
+        *p++ = ',';
+        p = write_int(p, level.order_id);
+        *p++ = ',';
+        p = write_millis(p, level.timestamp);
+    }
+    return p;
+}
+
+// Writes one line and its newline at `p`, which must have
+// max_line_size() bytes of room; returns the end
+inline char* write_event(char* p, const MarketDataEvent& event, const std::string& symbol) {
+    p = write_int(p, event.sequence_number);
+    *p++ = '|';
+    std::memcpy(p, symbol.data(), symbol.size());
+    p += symbol.size();
+    *p++ = '|';
+    p = write_price(p, event.best_bid_price);
+    *p++ = '|';
+    p = write_price(p, event.best_ask_price);
+    *p++ = '|';
+    p = write_int(p, event.best_bid_size);
+    *p++ = '|';
+    p = write_int(p, event.best_ask_size);
+    *p++ = '|';
+    p = write_millis(p, event.timestamp);
+    *p++ = '|';
+    p = write_levels(p, event.bid_levels);
+    *p++ = '|';
+    p = write_levels(p, event.ask_levels);
+    *p++ = '|';
+    for (std::size_t i = 0; i < event.trades.size(); ++i) {
+        const auto& trade = event.trades[i];
+        if (i > 0) *p++ = ';';
+        if (trade.aggressor_side == Side::BUY) {
+            std::memcpy(p, "BUY,", 4);
+            p += 4;
+        } else {
+            std::memcpy(p, "SELL,", 5);
+            p += 5;
+        }
+        p = write_price(p, trade.price);
+        *p++ = ',';
+        p = write_int(p, trade.size);
+        *p++ = ',';
+        p = write_int(p, trade.trade_id);
+        *p++ = ',';
+        p = write_millis(p, trade.timestamp);
+    }
+    *p++ = '|';
+    for (std::size_t i = 0; i < event.partial_fills.size(); ++i) {
+        const auto& fill = event.partial_fills[i];
+        if (i > 0) *p++ = ';';
+        p = write_int(p, fill.order_id);
+        *p++ = ',';
+        p = write_price(p, fill.price);
+        *p++ = ',';
+        p = write_int(p, fill.filled_size);
+        *p++ = ',';
+        p = write_int(p, fill.remaining_size);
+        *p++ = ',';
+        p = write_millis(p, fill.timestamp);
+    }
+    *p++ = '\n';
+    return p;
+}
+
+// Appends one line, newline included, to `out`
+inline void append_event(std::string& out, const MarketDataEvent& event, const std::string& symbol) {
+    const std::size_t used = out.size();
+    out.resize(used + max_line_size(event, symbol.size()));
+    char* end = write_event(&out[used], event, symbol);
+    out.resize(static_cast<std::size_t>(end - out.data()));
+}
+
+} // namespace event_log
+
+// Writes the text event log from a background thread. push() copies the
+// event into a single-producer/single-consumer ring of preallocated slots
+// (which keep their capacity, so steady-state pushes do not allocate) and
+// returns; the writer thread formats lines into a kWriteBytes buffer and
+// hands the file one large write each time it fills. When the ring is full
+// push() waits for the writer rather than dropping events. close() drains the
+// ring, writes what is left and joins the thread. The writer also keeps the
+// log's sequence index (include/SequenceIndex.h) at <path>.idx, since it is
+// the one that knows where each line lands.
+class AsyncEventLog {
+public:
+    static constexpr std::size_t kDefaultCapacity = 1024;  // events, rounded up to a power of two
+    static constexpr std::size_t kWriteBytes = 1u << 20;
+
+    AsyncEventLog() = default;
+    ~AsyncEventLog() { close(); }
+
+    AsyncEventLog(const AsyncEventLog&) = delete;
+    AsyncEventLog& operator=(const AsyncEventLog&) = delete;
+
+    // Truncates `path` and its index and starts the writer thread; false if
+    // either cannot be opened. An index_interval of 0 writes no index.
+    bool open(const std::string& path, std::size_t capacity = kDefaultCapacity,
+              uint32_t index_interval = sequence_index::kDefaultInterval) {
+        close();
+        out_.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!out_) {
+            return false;
+        }
+        index_.reset();
+        if (index_interval > 0) {
+            index_ = std::make_unique<SequenceIndexWriter>();
+            if (!index_->open(sequence_index::path_for(path), index_interval)) {
+                out_.close();
+                return false;
+            }
+        }
+        written_ = 0;
+        std::size_t slots = 1;
+        while (slots < std::max<std::size_t>(capacity, 2)) {
+            slots <<= 1;
+        }
+        slots_ = std::vector<MarketDataEvent>(slots);
+        mask_ = slots - 1;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        tail_cache_ = 0;
+        stop_.store(false, std::memory_order_relaxed);
+        failed_.store(false, std::memory_order_relaxed);
+        writer_ = std::thread([this] { writer_loop(); });
+        return true;
+    }
+
+    bool is_open() const { return writer_.joinable(); }
+
+    // Queues a copy of `event` for writing
+    void push(const MarketDataEvent& event) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        while (head - tail_cache_ > mask_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ > mask_) {
+                std::this_thread::yield();
+            }
+        }
+        // Only what the log line holds; mm_fills are not written
+        MarketDataEvent& slot = slots_[head & mask_];
+        slot.instrument_id = event.instrument_id;
+        slot.best_bid_price = event.best_bid_price;
+        slot.best_ask_price = event.best_ask_price;
+        slot.best_bid_size = event.best_bid_size;
+        slot.best_ask_size = event.best_ask_size;
+        slot.bid_levels = event.bid_levels;
+        slot.ask_levels = event.ask_levels;
+        slot.trades = event.trades;
+        slot.partial_fills = event.partial_fills;
+        slot.timestamp = event.timestamp;
+        slot.sequence_number = event.sequence_number;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // Writes out every queued event and stops the writer. Returns false if
+    // any write failed.
+    bool close() {
+        if (writer_.joinable()) {
+            stop_.store(true, std::memory_order_release);
+            writer_.join();
+            out_.close();
+            index_.reset();  // flushes
+        }
+        return !failed_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Polling interval while the ring is empty, and how many empty polls in
+    // a row before a partly filled buffer is written anyway
+    static constexpr std::chrono::microseconds kIdleSleep{200};
+    static constexpr int kIdleFlushPolls = 50;
+
+    void writer_loop() {
+        std::vector<char> buffer(kWriteBytes);
+        std::size_t used = 0;
+        InstrumentId symbol_id = kNoInstrument;
+        std::string symbol;
+        int idle_polls = 0;
+        for (;;) {
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+            const std::size_t head = head_.load(std::memory_order_acquire);
+            if (tail == head) {
+                if (stop_.load(std::memory_order_acquire) && head_.load(std::memory_order_acquire) == tail) {
+                    break;
+                }
+                if (used > 0 && ++idle_polls >= kIdleFlushPolls) {
+                    write(buffer.data(), used);
+                }
+                std::this_thread::sleep_for(kIdleSleep);
+                continue;
+            }
+            idle_polls = 0;
+            for (; tail != head; ++tail) {
+                const MarketDataEvent& event = slots_[tail & mask_];
+                // The registry takes a lock per lookup; logs rarely change symbol
+                if (event.instrument_id != symbol_id || symbol.empty()) {
+                    symbol_id = event.instrument_id;
+                    symbol = InstrumentRegistry::global().name(symbol_id);
+                }
+                const std::size_t bound = event_log::max_line_size(event, symbol.size());
+                if (buffer.size() - used < bound) {
+                    write(buffer.data(), used);
+                    if (buffer.size() < bound) {
+                        buffer.resize(bound);  // one very deep book
+                    }
+                }
+                if (index_) {
+                    if (index_->due()) {
+                        const int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                               event.timestamp.time_since_epoch())
+                                               .count();
+                        index_->add_point(written_ + used, event.sequence_number, ns);
+                    }
+                    index_->count_event();
+                }
+                used = static_cast<std::size_t>(event_log::write_event(buffer.data() + used, event, symbol) -
+                                                buffer.data());
+                tail_.store(tail + 1, std::memory_order_release);
+            }
+        }
+        write(buffer.data(), used);
+        out_.flush();
+        if (!out_) {
+            failed_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void write(const char* data, std::size_t& used) {
+        out_.write(data, static_cast<std::streamsize>(used));
+        if (!out_) {
+            failed_.store(true, std::memory_order_relaxed);
+        }
+        written_ += used;
+        used = 0;
+    }
+
+    std::ofstream out_;
+    std::vector<MarketDataEvent> slots_;
+    std::size_t mask_ = 0;
+    std::thread writer_;
+    std::unique_ptr<SequenceIndexWriter> index_;  // writer thread only while open
+    uint64_t written_ = 0;                        // bytes handed to out_
+
+    // Producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<std::size_t> head_{0};  // next slot to fill (producer)
+    std::size_t tail_cache_ = 0;                    // producer's last view of tail_
+    alignas(64) std::atomic<std::size_t> tail_{0};  // next slot to write (writer)
+    alignas(64) std::atomic<bool> stop_{false};
+    std::atomic<bool> failed_{false};
+};
+
+#endif // ASYNC_EVENT_LOG_H
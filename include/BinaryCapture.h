@@ -0,0 +1,262 @@
+#ifndef BINARY_CAPTURE_H
+#define BINARY_CAPTURE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// On-disk layout of the binary event capture written by BinaryLogger and
+// read by BinaryCaptureReader.
+//
+// A file is a FileHeader followed by records. Every record starts with a
+// RecordHeader whose size covers the header, the body and padding up to a
+// multiple of kRecordAlign, so readers can skip record types they do not
+// know. Symbol records map a file-local symbol id to its name and appear
+// before the first event that uses the id. Event records are full
+// snapshots: an EventHeader followed by its bid levels, ask levels, trades,
+// partial fills and MM fills, each a packed array of the fixed-size structs
+// below.
+//
+// Since version 3, events between snapshots of the same symbol are stored
+// as deltas in delta block records (DeltaBlock, then `bytes` of encoded
+// deltas). A delta holds only what changed since the symbol's previous
+// event: for each changed level its index, a zigzag varint price change in
+// ticks (relative to the previous changed level's change on that side, as
+// the whole book usually moves with the mid) and its size change; order id
+// and timestamp changes are flagged and rare. Sequence numbers and
+// timestamps are deltas of deltas, and trades and fills are varints
+// relative to the event's best bid, timestamp and the last id seen. A
+// snapshot resets the symbol's delta state, so decoding can start at any
+// snapshot. See DeltaFlags and BinaryLogger::encode_delta for the layout.
+//
+// All fields are little-endian (checked through FileHeader::byte_order),
+// naturally aligned, and records are 8-byte aligned, so a reader can use the
+// arrays in place in a memory map. Prices are ticks and timestamps are
+// nanoseconds since the epoch. The header records the size of each struct;
+// a reader rejects a file whose sizes differ from its own. Version 1 was the
+// headerless top-of-book format, which cannot be replayed.
+namespace binary_capture {
+
+constexpr char kMagic[8] = {'M', 'M', 'C', 'A', 'P', 'T', 'U', 'R'};
+constexpr uint16_t kVersion = 3;
+constexpr uint16_t kMinVersion = 2;  // version 2 has snapshots only
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr std::size_t kRecordAlign = 8;
+
+enum RecordType : uint32_t {
+    kSymbolRecord = 1,
+    kEventRecord = 2,
+    kDeltaBlockRecord = 3
+};
+
+struct FileHeader {
+    char magic[8];
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t byte_order;
+    uint16_t event_header_size;
+    uint16_t level_size;
+    uint16_t trade_size;
+    uint16_t partial_fill_size;
+    uint16_t fill_size;
+    uint16_t record_align;
+    uint32_t reserved;
+};
+
+struct RecordHeader {
+    uint32_t size;  // whole record, padding included
+    uint32_t type;
+};
+
+// Followed by `length` bytes of name
+struct SymbolRecord {
+    uint32_t symbol;
+    uint32_t length;
+};
+
+struct EventHeader {
+    int64_t sequence_number;
+    int64_t timestamp_ns;
+    int64_t best_bid_price;
+    int64_t best_ask_price;
+    int32_t best_bid_size;
+    int32_t best_ask_size;
+    uint32_t symbol;
+    uint32_t bid_count;
+    uint32_t ask_count;
+    uint32_t trade_count;
+    uint32_t partial_fill_count;
+    uint32_t mm_fill_count;
+};
+
+struct Level {
+    int64_t price;
+    uint64_t order_id;
+    int64_t timestamp_ns;
+    int32_t size;
+    uint32_t reserved;
+};
+
+struct Trade {
+    int64_t price;
+    uint64_t trade_id;
+    int64_t timestamp_ns;
+    int32_t size;
+    uint8_t side;  // 0 = BUY, 1 = SELL
+    uint8_t reserved[3];
+};
+
+struct PartialFill {
+    uint64_t order_id;
+    int64_t price;
+    int64_t timestamp_ns;
+    int32_t filled_size;
+    int32_t remaining_size;
+};
+
+struct Fill {
+    uint64_t order_id;
+    uint64_t trade_id;
+    int64_t price;
+    int64_t timestamp_ns;
+    int32_t fill_qty;
+    int32_t leaves_qty;
+    uint32_t symbol;
+    uint8_t side;
+    uint8_t reserved[3];
+};
+
+// Followed by `bytes` of `count` encoded deltas
+struct DeltaBlock {
+    uint32_t count;
+    uint32_t bytes;
+};
+
+// First byte of an encoded delta, after the symbol
+enum DeltaFlags : uint8_t {
+    kExplicitBestBid = 1 << 0,  // best bid is not bid level 0 (or 0/0 for an empty side)
+    kExplicitBestAsk = 1 << 1,
+    kLevelCounts = 1 << 2,      // book depth changed
+    kHasTrades = 1 << 3,
+    kHasPartialFills = 1 << 4,
+    kHasMmFills = 1 << 5
+};
+
+// Low bits of a changed level's index-gap varint
+enum LevelFlags : uint8_t {
+    kLevelOrderId = 1 << 0,
+    kLevelTimestamp = 1 << 1,
+    kLevelFlagBits = 2
+};
+
+// Per-symbol state that deltas are relative to, kept in step by the writer
+// and the reader
+struct DeltaState {
+    std::vector<Level> bids;
+    std::vector<Level> asks;
+    EventHeader last{};  // the symbol's previous event (counts unused)
+    int64_t ts_step = 0;  // last timestamp increment
+    uint64_t last_trade_id = 0;
+    uint64_t last_order_id = 0;
+    uint32_t since_snapshot = 0;
+    bool primed = false;  // a snapshot has been seen
+
+    void reset(const EventHeader& snapshot) {
+        last = snapshot;
+        ts_step = 0;
+        last_trade_id = 0;
+        last_order_id = 0;
+        since_snapshot = 0;
+        primed = true;
+    }
+};
+
+inline uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// Wrapping difference, for ids that only need to round-trip
+inline int64_t diff(uint64_t a, uint64_t b) {
+    return static_cast<int64_t>(a - b);
+}
+
+inline void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+inline void put_signed(std::vector<uint8_t>& out, int64_t v) {
+    put_varint(out, zigzag(v));
+}
+
+// False if the varint runs past `end` or is longer than 10 bytes
+inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p != end; shift += 7) {
+        const uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static_assert(sizeof(FileHeader) == 32, "capture layout");
+static_assert(sizeof(RecordHeader) == 8, "capture layout");
+static_assert(sizeof(SymbolRecord) == 8, "capture layout");
+static_assert(sizeof(DeltaBlock) == 8, "capture layout");
+static_assert(sizeof(EventHeader) == 64, "capture layout");
+static_assert(sizeof(Level) == 32, "capture layout");
+static_assert(sizeof(Trade) == 32, "capture layout");
+static_assert(sizeof(PartialFill) == 32, "capture layout");
+static_assert(sizeof(Fill) == 48, "capture layout");
+
+inline FileHeader make_file_header() {
+    FileHeader header{};
+    for (std::size_t i = 0; i < sizeof(kMagic); ++i) {
+        header.magic[i] = kMagic[i];
+    }
+    header.version = kVersion;
+    header.header_size = sizeof(FileHeader);
+    header.byte_order = kByteOrderMark;
+    header.event_header_size = sizeof(EventHeader);
+    header.level_size = sizeof(Level);
+    header.trade_size = sizeof(Trade);
+    header.partial_fill_size = sizeof(PartialFill);
+    header.fill_size = sizeof(Fill);
+    header.record_align = kRecordAlign;
+    return header;
+}
+
+constexpr std::size_t padded(std::size_t bytes) {
+    return (bytes + kRecordAlign - 1) / kRecordAlign * kRecordAlign;
+}
+
+// Record size of an event with the given element counts
+constexpr std::size_t event_record_size(std::size_t bids, std::size_t asks, std::size_t trades,
+                                        std::size_t partial_fills, std::size_t mm_fills) {
+    return sizeof(RecordHeader) + sizeof(EventHeader) + (bids + asks) * sizeof(Level) + trades * sizeof(Trade) +
+           partial_fills * sizeof(PartialFill) + mm_fills * sizeof(Fill);
+}
+
+inline int64_t to_nanos(std::chrono::system_clock::time_point ts) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+}
+
+inline std::chrono::system_clock::time_point from_nanos(int64_t ns) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+} // namespace binary_capture
+
+#endif // BINARY_CAPTURE_H
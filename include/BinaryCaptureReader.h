@@ -0,0 +1,514 @@
+#ifndef BINARY_CAPTURE_READER_H
+#define BINARY_CAPTURE_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../MarketDataEvent.h"
+#include "BinaryCapture.h"
+#include "InstrumentRegistry.h"
+#include "MappedFile.h"
+#include "Span.h"
+
+// Reads a binary capture (include/BinaryCapture.h) straight out of a memory
+// map. For a snapshot next_view() returns spans over the record's arrays in
+// place, so scanning snapshots touches each byte once and decodes nothing;
+// a delta is applied to the symbol's book kept by the reader and the view
+// points at that. next() copies an event into a MarketDataEvent, reusing its
+// capacity. Consumed pages are released every kReleaseBytes as in
+// ReplaySource. A bad header or a truncated or inconsistent record throws
+// std::runtime_error.
+class BinaryCaptureReader {
+public:
+    static constexpr std::size_t kReleaseBytes = 16u << 20;
+    static constexpr uint64_t kMaxDeltaLevels = 1u << 16;  // per side; more means a corrupt delta
+
+    struct EventView {
+        const binary_capture::EventHeader* header = nullptr;
+        InstrumentId instrument_id = kNoInstrument;
+        Span<const binary_capture::Level> bids;
+        Span<const binary_capture::Level> asks;
+        Span<const binary_capture::Trade> trades;
+        Span<const binary_capture::PartialFill> partial_fills;
+        Span<const binary_capture::Fill> mm_fills;
+    };
+
+    // False if the file cannot be mapped; throws if it is not a capture this
+    // build can read
+    bool open(const std::string& path) {
+        pos_ = 0;
+        released_ = 0;
+        record_number_ = 0;
+        symbols_.clear();
+        states_.clear();
+        delta_left_ = 0;
+        if (!file_.open(path)) {
+            return false;
+        }
+        check_header();
+        pos_ = sizeof(binary_capture::FileHeader);
+        return true;
+    }
+
+    bool is_open() const { return file_.is_open(); }
+
+    // Continues from a sequence index seek point: the record at `offset`,
+    // with events_before events ahead of it. Symbol records before the point
+    // are read from symbol_offsets, also from the index. Throws if any of
+    // them is not a symbol record, as when the index belongs to another file.
+    void seek(uint64_t offset, std::size_t events_before, const std::vector<uint64_t>& symbol_offsets) {
+        namespace bc = binary_capture;
+        if (offset < sizeof(bc::FileHeader) || offset > file_.size()) {
+            fail("Seek point out of range", offset);
+        }
+        symbols_.clear();
+        states_.clear();
+        delta_left_ = 0;
+        for (uint64_t at : symbol_offsets) {
+            if (at >= offset) {
+                break;
+            }
+            bc::RecordHeader record{};
+            if (at < sizeof(bc::FileHeader) || file_.size() - at < sizeof(record)) {
+                fail("Not a symbol record", at);
+            }
+            std::memcpy(&record, file_.data() + at, sizeof(record));
+            if (record.type != bc::kSymbolRecord || record.size < sizeof(record) || record.size > file_.size() - at) {
+                fail("Not a symbol record", at);
+            }
+            read_symbol(file_.data() + at + sizeof(record), record.size - sizeof(record), at);
+        }
+        pos_ = static_cast<std::size_t>(offset);
+        record_number_ = events_before;
+    }
+
+    // True if an event remains
+    bool has_next() const {
+        namespace bc = binary_capture;
+        if (delta_left_ > 0) {
+            return true;
+        }
+        std::size_t pos = pos_;
+        while (file_.size() - pos >= sizeof(bc::RecordHeader)) {
+            bc::RecordHeader header;
+            std::memcpy(&header, file_.data() + pos, sizeof(header));
+            if (header.type == bc::kEventRecord) {
+                return true;
+            }
+            if (header.size < sizeof(header) || header.size > file_.size() - pos) {
+                return true;  // let next() report the damage
+            }
+            if (header.type == bc::kDeltaBlockRecord) {
+                bc::DeltaBlock block{};
+                if (header.size < sizeof(header) + sizeof(block)) {
+                    return true;
+                }
+                std::memcpy(&block, file_.data() + pos + sizeof(header), sizeof(block));
+                if (block.count > 0) {
+                    return true;
+                }
+            }
+            pos += header.size;
+        }
+        return false;
+    }
+
+    // Points `view` at the next event; false at end of file. A delta's view
+    // is valid until the next call.
+    bool next_view(EventView& view) {
+        namespace bc = binary_capture;
+        const char* data = file_.data();
+        for (;;) {
+            if (delta_left_ > 0) {
+                apply_delta(view);
+                return true;
+            }
+            if (pos_ >= file_.size()) {
+                return false;
+            }
+            const std::size_t start = pos_;
+            if (file_.size() - start < sizeof(bc::RecordHeader)) {
+                fail("Truncated capture record", start);
+            }
+            const auto* record = reinterpret_cast<const bc::RecordHeader*>(data + start);
+            if (record->size < sizeof(bc::RecordHeader) || record->size % bc::kRecordAlign != 0 ||
+                record->size > file_.size() - start) {
+                fail("Truncated capture record", start);
+            }
+            pos_ = start + record->size;
+            const char* body = data + start + sizeof(bc::RecordHeader);
+            const std::size_t body_size = record->size - sizeof(bc::RecordHeader);
+
+            if (record->type == bc::kSymbolRecord) {
+                read_symbol(body, body_size, start);
+                continue;
+            }
+            if (record->type == bc::kDeltaBlockRecord) {
+                open_block(body, body_size, start);
+                continue;
+            }
+            if (record->type != bc::kEventRecord) {
+                continue;  // a newer writer's record type
+            }
+
+            if (body_size < sizeof(bc::EventHeader)) {
+                fail("Corrupt event record", start);
+            }
+            const auto* header = reinterpret_cast<const bc::EventHeader*>(body);
+            const std::size_t expected = bc::padded(bc::event_record_size(
+                header->bid_count, header->ask_count, header->trade_count, header->partial_fill_count,
+                header->mm_fill_count));
+            if (expected != record->size) {
+                fail("Corrupt event record", start);
+            }
+            view.header = header;
+            view.instrument_id = symbol(header->symbol, start);
+            const char* p = body + sizeof(bc::EventHeader);
+            view.bids = take<bc::Level>(p, header->bid_count);
+            view.asks = take<bc::Level>(p, header->ask_count);
+            view.trades = take<bc::Trade>(p, header->trade_count);
+            view.partial_fills = take<bc::PartialFill>(p, header->partial_fill_count);
+            view.mm_fills = take<bc::Fill>(p, header->mm_fill_count);
+            for (const auto& fill : view.mm_fills) {
+                symbol(fill.symbol, start);
+            }
+            // Copied into the symbol's book only if a delta follows
+            SymbolState& state = states_[header->symbol];
+            state.delta.reset(*header);
+            state.snapshot_bids = view.bids;
+            state.snapshot_asks = view.asks;
+            state.pending = true;
+            ++record_number_;
+            maybe_release(start);
+            return true;
+        }
+    }
+
+    // Decodes the next event into `event`; false at end of file
+    bool next(MarketDataEvent& event) {
+        EventView view;
+        if (!next_view(view)) {
+            return false;
+        }
+        decode(view, event);
+        return true;
+    }
+
+    // 1-based index of the last event returned
+    std::size_t record_number() const { return record_number_; }
+    std::size_t bytes_consumed() const { return pos_; }
+    std::size_t size() const { return file_.size(); }
+
+    void decode(const EventView& view, MarketDataEvent& event) {
+        namespace bc = binary_capture;
+        const bc::EventHeader& h = *view.header;
+        event.instrument_id = view.instrument_id;
+        event.sequence_number = h.sequence_number;
+        event.timestamp = bc::from_nanos(h.timestamp_ns);
+        event.best_bid_price = h.best_bid_price;
+        event.best_ask_price = h.best_ask_price;
+        event.best_bid_size = h.best_bid_size;
+        event.best_ask_size = h.best_ask_size;
+        decode_levels(view.bids, event.bid_levels);
+        decode_levels(view.asks, event.ask_levels);
+        event.trades.clear();
+        event.trades.reserve(view.trades.size());
+        for (const auto& t : view.trades) {
+            event.trades.push_back(Trade{t.side == 0 ? Side::BUY : Side::SELL, t.price, t.size, t.trade_id,
+                                        bc::from_nanos(t.timestamp_ns)});
+        }
+        event.partial_fills.clear();
+        event.partial_fills.reserve(view.partial_fills.size());
+        for (const auto& f : view.partial_fills) {
+            event.partial_fills.push_back(PartialFillEvent{f.order_id, f.price, f.filled_size, f.remaining_size,
+                                                           bc::from_nanos(f.timestamp_ns)});
+        }
+        event.mm_fills.clear();
+        event.mm_fills.reserve(view.mm_fills.size());
+        for (const auto& f : view.mm_fills) {
+            // The symbol was validated when the record was read
+            event.mm_fills.push_back(FillEvent{f.order_id, f.trade_id, f.side == 0 ? Side::BUY : Side::SELL,
+                                               symbols_[f.symbol], f.price, f.fill_qty, f.leaves_qty,
+                                               bc::from_nanos(f.timestamp_ns)});
+        }
+    }
+
+private:
+    struct SymbolState {
+        binary_capture::DeltaState delta;
+        Span<const binary_capture::Level> snapshot_bids;  // last snapshot, not yet copied into delta
+        Span<const binary_capture::Level> snapshot_asks;
+        bool pending = false;
+    };
+
+    void check_header() const {
+        namespace bc = binary_capture;
+        bc::FileHeader header{};
+        if (file_.size() < sizeof(header)) {
+            throw std::runtime_error("Not a binary capture (too short)");
+        }
+        std::memcpy(&header, file_.data(), sizeof(header));
+        if (std::memcmp(header.magic, bc::kMagic, sizeof(bc::kMagic)) != 0) {
+            throw std::runtime_error("Not a binary capture (bad magic; version 1 logs have no depth and cannot "
+                                     "be replayed)");
+        }
+        if (header.version < bc::kMinVersion || header.version > bc::kVersion) {
+            throw std::runtime_error("Unsupported binary capture version " + std::to_string(header.version));
+        }
+        const bc::FileHeader expected = bc::make_file_header();
+        if (header.byte_order != expected.byte_order || header.header_size != expected.header_size ||
+            header.event_header_size != expected.event_header_size || header.level_size != expected.level_size ||
+            header.trade_size != expected.trade_size || header.partial_fill_size != expected.partial_fill_size ||
+            header.fill_size != expected.fill_size || header.record_align != expected.record_align) {
+            throw std::runtime_error("Binary capture layout does not match this build");
+        }
+    }
+
+    void read_symbol(const char* body, std::size_t body_size, std::size_t offset) {
+        binary_capture::SymbolRecord record;
+        if (body_size < sizeof(record)) {
+            fail("Corrupt symbol record", offset);
+        }
+        std::memcpy(&record, body, sizeof(record));
+        if (record.length > body_size - sizeof(record) || record.symbol > symbols_.size()) {
+            fail("Corrupt symbol record", offset);
+        }
+        const InstrumentId id =
+            InstrumentRegistry::global().intern(std::string(body + sizeof(record), record.length));
+        if (record.symbol == symbols_.size()) {
+            symbols_.push_back(id);
+            states_.emplace_back();
+        } else {
+            symbols_[record.symbol] = id;
+        }
+    }
+
+    InstrumentId symbol(uint32_t file_id, std::size_t offset) const {
+        if (file_id >= symbols_.size()) {
+            fail("Unknown symbol id " + std::to_string(file_id), offset);
+        }
+        return symbols_[file_id];
+    }
+
+    void open_block(const char* body, std::size_t body_size, std::size_t offset) {
+        binary_capture::DeltaBlock block;
+        if (body_size < sizeof(block)) {
+            fail("Corrupt delta block", offset);
+        }
+        std::memcpy(&block, body, sizeof(block));
+        if (block.bytes > body_size - sizeof(block)) {
+            fail("Corrupt delta block", offset);
+        }
+        delta_pos_ = reinterpret_cast<const uint8_t*>(body + sizeof(block));
+        delta_end_ = delta_pos_ + block.bytes;
+        delta_left_ = block.count;
+        block_offset_ = offset;
+        maybe_release(offset);
+    }
+
+    // Decodes the next delta of the open block (see
+    // BinaryLogger::encode_delta) onto its symbol's book
+    void apply_delta(EventView& view) {
+        namespace bc = binary_capture;
+        const uint64_t file_id = read_varint();
+        view.instrument_id = symbol(static_cast<uint32_t>(file_id), block_offset_);
+        SymbolState& state = states_[file_id];
+        if (!state.delta.primed) {
+            fail("Delta before snapshot", block_offset_);
+        }
+        if (state.pending) {
+            state.delta.bids.assign(state.snapshot_bids.begin(), state.snapshot_bids.end());
+            state.delta.asks.assign(state.snapshot_asks.begin(), state.snapshot_asks.end());
+            state.pending = false;
+        }
+        bc::DeltaState& d = state.delta;
+        bc::EventHeader& last = d.last;
+
+        const uint8_t flags = static_cast<uint8_t>(read_byte());
+        last.sequence_number += 1 + read_signed();
+        d.ts_step += read_signed();
+        last.timestamp_ns += d.ts_step;
+        uint64_t bid_count = d.bids.size();
+        uint64_t ask_count = d.asks.size();
+        if (flags & bc::kLevelCounts) {
+            bid_count = read_varint();
+            ask_count = read_varint();
+            if (bid_count > kMaxDeltaLevels || ask_count > kMaxDeltaLevels) {
+                fail("Corrupt delta block", block_offset_);
+            }
+        }
+        apply_side(d.bids, bid_count);
+        apply_side(d.asks, ask_count);
+
+        if (flags & bc::kExplicitBestBid) {
+            last.best_bid_price += read_signed();
+            last.best_bid_size += static_cast<int32_t>(read_signed());
+        } else {
+            last.best_bid_price = d.bids.empty() ? 0 : d.bids[0].price;
+            last.best_bid_size = d.bids.empty() ? 0 : d.bids[0].size;
+        }
+        if (flags & bc::kExplicitBestAsk) {
+            last.best_ask_price += read_signed();
+            last.best_ask_size += static_cast<int32_t>(read_signed());
+        } else {
+            last.best_ask_price = d.asks.empty() ? 0 : d.asks[0].price;
+            last.best_ask_size = d.asks.empty() ? 0 : d.asks[0].size;
+        }
+
+        const int64_t anchor = last.best_bid_price;
+        const int64_t ts = last.timestamp_ns;
+        trades_.resize(flags & bc::kHasTrades ? read_count() : 0);
+        for (auto& t : trades_) {
+            t = bc::Trade{};
+            t.side = static_cast<uint8_t>(read_byte());
+            t.price = anchor + read_signed();
+            t.size = static_cast<int32_t>(read_signed());
+            t.trade_id = d.last_trade_id += static_cast<uint64_t>(read_signed());
+            t.timestamp_ns = ts + read_signed();
+        }
+        partial_fills_.resize(flags & bc::kHasPartialFills ? read_count() : 0);
+        for (auto& f : partial_fills_) {
+            f.order_id = d.last_order_id += static_cast<uint64_t>(read_signed());
+            f.price = anchor + read_signed();
+            f.filled_size = static_cast<int32_t>(read_signed());
+            f.remaining_size = static_cast<int32_t>(read_signed());
+            f.timestamp_ns = ts + read_signed();
+        }
+        mm_fills_.resize(flags & bc::kHasMmFills ? read_count() : 0);
+        for (auto& f : mm_fills_) {
+            f = bc::Fill{};
+            f.order_id = d.last_order_id += static_cast<uint64_t>(read_signed());
+            f.trade_id = d.last_trade_id += static_cast<uint64_t>(read_signed());
+            f.side = static_cast<uint8_t>(read_byte());
+            f.symbol = static_cast<uint32_t>(read_varint());
+            symbol(f.symbol, block_offset_);
+            f.price = anchor + read_signed();
+            f.fill_qty = static_cast<int32_t>(read_signed());
+            f.leaves_qty = static_cast<int32_t>(read_signed());
+            f.timestamp_ns = ts + read_signed();
+        }
+
+        if (--delta_left_ == 0 && delta_pos_ != delta_end_) {
+            fail("Corrupt delta block", block_offset_);
+        }
+        ++d.since_snapshot;
+
+        header_ = last;
+        header_.symbol = static_cast<uint32_t>(file_id);
+        header_.bid_count = static_cast<uint32_t>(d.bids.size());
+        header_.ask_count = static_cast<uint32_t>(d.asks.size());
+        header_.trade_count = static_cast<uint32_t>(trades_.size());
+        header_.partial_fill_count = static_cast<uint32_t>(partial_fills_.size());
+        header_.mm_fill_count = static_cast<uint32_t>(mm_fills_.size());
+        view.header = &header_;
+        view.bids = Span<const bc::Level>(d.bids.data(), d.bids.size());
+        view.asks = Span<const bc::Level>(d.asks.data(), d.asks.size());
+        view.trades = Span<const bc::Trade>(trades_.data(), trades_.size());
+        view.partial_fills = Span<const bc::PartialFill>(partial_fills_.data(), partial_fills_.size());
+        view.mm_fills = Span<const bc::Fill>(mm_fills_.data(), mm_fills_.size());
+        ++record_number_;
+    }
+
+    // Resizes one side to `count` levels (new ones zero) and applies its
+    // changed levels
+    void apply_side(std::vector<binary_capture::Level>& levels, uint64_t count) {
+        namespace bc = binary_capture;
+        levels.resize(count);
+        const uint64_t changed = read_varint();
+        uint64_t index = 0;
+        int64_t move = 0;
+        for (uint64_t k = 0; k < changed; ++k) {
+            const uint64_t word = read_varint();
+            index += word >> bc::kLevelFlagBits;
+            if (index >= levels.size()) {
+                fail("Corrupt delta block", block_offset_);
+            }
+            bc::Level& level = levels[index++];
+            move += read_signed();
+            level.price += move;
+            level.size += static_cast<int32_t>(read_signed());
+            if (word & bc::kLevelOrderId) {
+                level.order_id += static_cast<uint64_t>(read_signed());
+            }
+            if (word & bc::kLevelTimestamp) {
+                level.timestamp_ns += read_signed();
+            }
+        }
+    }
+
+    uint64_t read_varint() {
+        uint64_t v;
+        if (!binary_capture::get_varint(delta_pos_, delta_end_, v)) {
+            fail("Corrupt delta block", block_offset_);
+        }
+        return v;
+    }
+
+    int64_t read_signed() { return binary_capture::unzigzag(read_varint()); }
+
+    uint8_t read_byte() {
+        if (delta_pos_ == delta_end_) {
+            fail("Corrupt delta block", block_offset_);
+        }
+        return *delta_pos_++;
+    }
+
+    // An element count, each element taking at least one byte per field
+    std::size_t read_count() {
+        const uint64_t n = read_varint();
+        if (n > static_cast<uint64_t>(delta_end_ - delta_pos_)) {
+            fail("Corrupt delta block", block_offset_);
+        }
+        return static_cast<std::size_t>(n);
+    }
+
+    template <typename T>
+    static Span<const T> take(const char*& p, std::size_t count) {
+        Span<const T> span(reinterpret_cast<const T*>(p), count);
+        p += count * sizeof(T);
+        return span;
+    }
+
+    static void decode_levels(Span<const binary_capture::Level> in, LevelList& out) {
+        out.clear();
+        out.reserve(in.size());
+        for (const auto& l : in) {
+            out.emplace_back(l.price, l.size, l.order_id, binary_capture::from_nanos(l.timestamp_ns));
+        }
+    }
+
+    void maybe_release(std::size_t record_start) {
+        if (record_start - released_ >= kReleaseBytes) {
+            file_.release(record_start);
+            released_ = record_start;
+        }
+    }
+
+    [[noreturn]] static void fail(const std::string& what, std::size_t offset) {
+        throw std::runtime_error(what + " at byte " + std::to_string(offset));
+    }
+
+    MappedFile file_;
+    std::size_t pos_ = 0;
+    std::size_t released_ = 0;
+    std::size_t record_number_ = 0;
+    std::vector<InstrumentId> symbols_;  // file symbol id -> registry id
+    std::vector<SymbolState> states_;    // by file symbol id
+
+    // Open delta block
+    const uint8_t* delta_pos_ = nullptr;
+    const uint8_t* delta_end_ = nullptr;
+    uint32_t delta_left_ = 0;
+    std::size_t block_offset_ = 0;
+
+    // The last delta's event, which its view points at
+    binary_capture::EventHeader header_{};
+    std::vector<binary_capture::Trade> trades_;
+    std::vector<binary_capture::PartialFill> partial_fills_;
+    std::vector<binary_capture::Fill> mm_fills_;
+};
+
+#endif // BINARY_CAPTURE_READER_H
@@ -4,65 +4,384 @@
 #include <cstdint>
 #include <cstring>
 #include <fstream>
-#include <chrono>
+#include <string>
+#include <vector>
 #include "../MarketDataEvent.h"
+#include "BinaryCapture.h"
+#include "InstrumentRegistry.h"
+#include "SequenceIndex.h"
 
+// Writes events in the binary capture format (include/BinaryCapture.h):
+// full book depth, trades, partial fills and MM fills, replayable with
+// --replay-binary. Each symbol gets a full snapshot every snapshot_interval
+// events and deltas in between, gathered into delta blocks of about
+// kDeltaBlockBytes; an interval of 1 writes snapshots only. Every
+// index_interval events all symbols are snapshotted afresh and the point is
+// recorded in the sequence index at <path>.idx (include/SequenceIndex.h), so
+// replay can start there. Records are built in a buffer that goes to the
+// file in kWriteBytes writes.
 class BinaryLogger {
 public:
-    explicit BinaryLogger(const std::string& path)
-        : out_(path, std::ios::binary | std::ios::trunc) {}
+    static constexpr std::size_t kWriteBytes = 1u << 20;
+    static constexpr std::size_t kDeltaBlockBytes = 64u << 10;
+    static constexpr uint32_t kDefaultSnapshotInterval = 1000;
 
-    bool is_open() const { return out_.is_open(); }
+    // An index_interval of 0 writes no index
+    explicit BinaryLogger(const std::string& path, uint32_t snapshot_interval = kDefaultSnapshotInterval,
+                          uint32_t index_interval = sequence_index::kDefaultInterval)
+        : out_(path, std::ios::binary | std::ios::trunc),
+          snapshot_interval_(snapshot_interval == 0 ? 1 : snapshot_interval),
+          index_interval_(index_interval) {
+        if (index_interval > 0 && out_.is_open()) {
+            index_.open(sequence_index::path_for(path), index_interval);
+        }
+        buf_.reserve(kWriteBytes + 4096);
+        const binary_capture::FileHeader header = binary_capture::make_file_header();
+        append(&header, sizeof(header));
+    }
+
+    ~BinaryLogger() { flush(); }
+
+    BinaryLogger(const BinaryLogger&) = delete;
+    BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+    bool is_open() const { return out_.is_open() && (!index_wanted() || index_.is_open()); }
 
     void log_event(const MarketDataEvent& ev) {
-        // Build record into buffer, then write total_len prefix + payload.
-        buf_.clear();
-
-        // Reserve space for total_len (filled in at the end)
-        append<uint32_t>(0);
-
-        append<int64_t>(ev.sequence_number);
-        int64_t ts_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            ev.timestamp.time_since_epoch()).count();
-        append<int64_t>(ts_ns);
-        append<double>(ev.best_bid_price);
-        append<double>(ev.best_ask_price);
-        append<int32_t>(ev.best_bid_size);
-        append<int32_t>(ev.best_ask_size);
-        append<uint16_t>(static_cast<uint16_t>(ev.trades.size()));
-        append<uint16_t>(static_cast<uint16_t>(ev.partial_fills.size()));
+        const uint32_t symbol = symbol_for(ev.instrument_id);
+        for (const auto& f : ev.mm_fills) {
+            symbol_for(f.instrument_id);  // symbol records go before the event
+        }
+        if (index_.is_open()) {
+            if (index_.due()) {
+                // Every symbol's next event is a snapshot, so replay can start here
+                for (auto& s : states_) {
+                    s.primed = false;
+                }
+                flush_deltas();
+                index_.add_point(position(), ev.sequence_number, binary_capture::to_nanos(ev.timestamp));
+            }
+            index_.count_event();
+        }
+        binary_capture::DeltaState& state = states_[symbol];
+        if (state.primed && state.since_snapshot + 1 < snapshot_interval_) {
+            encode_delta(ev, symbol, state);
+            ++state.since_snapshot;
+            ++delta_count_;
+            if (deltas_.size() >= kDeltaBlockBytes) {
+                flush_deltas();
+            }
+            return;
+        }
+        flush_deltas();  // records stay in event order
+        write_snapshot(ev, symbol, state);
+    }
 
-        for (const auto& t : ev.trades) {
-            append<uint8_t>(t.aggressor_side == Side::BUY ? 1 : 0);
-            append<double>(t.price);
-            append<int32_t>(t.size);
-            append<uint64_t>(t.trade_id);
+    void flush() {
+        flush_deltas();
+        if (!buf_.empty()) {
+            out_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+            written_ += buf_.size();
+            buf_.clear();
+        }
+        out_.flush();
+        if (index_.is_open()) {
+            index_.flush();
         }
+    }
 
+private:
+    std::ofstream out_;
+    std::vector<char> buf_;
+    std::vector<uint32_t> symbols_;  // registry id -> file symbol id + 1, 0 = not yet written
+    uint32_t next_symbol_ = 0;
+    uint32_t snapshot_interval_;
+    uint32_t index_interval_;
+    std::vector<binary_capture::DeltaState> states_;  // by file symbol id
+    std::vector<uint8_t> deltas_;                     // pending delta block payload
+    uint32_t delta_count_ = 0;
+    std::vector<uint8_t> side_scratch_;
+    SequenceIndexWriter index_;
+    uint64_t written_ = 0;  // bytes handed to out_
+
+    bool index_wanted() const { return index_interval_ > 0; }
+
+    // File offset of the next record
+    uint64_t position() const { return written_ + buf_.size(); }
+
+    static binary_capture::Level to_wire(const OrderLevel& l) {
+        binary_capture::Level level{};
+        level.price = l.price;
+        level.order_id = l.order_id;
+        level.timestamp_ns = binary_capture::to_nanos(l.timestamp);
+        level.size = l.size;
+        return level;
+    }
+
+    void write_snapshot(const MarketDataEvent& ev, uint32_t symbol, binary_capture::DeltaState& state) {
+        namespace bc = binary_capture;
+
+        bc::EventHeader header{};
+        header.sequence_number = ev.sequence_number;
+        header.timestamp_ns = bc::to_nanos(ev.timestamp);
+        header.best_bid_price = ev.best_bid_price;
+        header.best_ask_price = ev.best_ask_price;
+        header.best_bid_size = ev.best_bid_size;
+        header.best_ask_size = ev.best_ask_size;
+        header.symbol = symbol;
+        header.bid_count = static_cast<uint32_t>(ev.bid_levels.size());
+        header.ask_count = static_cast<uint32_t>(ev.ask_levels.size());
+        header.trade_count = static_cast<uint32_t>(ev.trades.size());
+        header.partial_fill_count = static_cast<uint32_t>(ev.partial_fills.size());
+        header.mm_fill_count = static_cast<uint32_t>(ev.mm_fills.size());
+
+        const std::size_t size = bc::event_record_size(ev.bid_levels.size(), ev.ask_levels.size(), ev.trades.size(),
+                                                       ev.partial_fills.size(), ev.mm_fills.size());
+        begin_record(bc::kEventRecord, size);
+        append(&header, sizeof(header));
+        state.bids.clear();
+        state.asks.clear();
+        for (const auto& l : ev.bid_levels) {
+            state.bids.push_back(to_wire(l));
+        }
+        for (const auto& l : ev.ask_levels) {
+            state.asks.push_back(to_wire(l));
+        }
+        append(state.bids.data(), state.bids.size() * sizeof(bc::Level));
+        append(state.asks.data(), state.asks.size() * sizeof(bc::Level));
+        for (const auto& t : ev.trades) {
+            bc::Trade trade{};
+            trade.price = t.price;
+            trade.trade_id = t.trade_id;
+            trade.timestamp_ns = bc::to_nanos(t.timestamp);
+            trade.size = t.size;
+            trade.side = t.aggressor_side == Side::BUY ? 0 : 1;
+            append(&trade, sizeof(trade));
+        }
         for (const auto& f : ev.partial_fills) {
-            append<uint64_t>(f.order_id);
-            append<double>(f.price);
-            append<int32_t>(f.filled_size);
-            append<int32_t>(f.remaining_size);
+            bc::PartialFill fill{};
+            fill.order_id = f.order_id;
+            fill.price = f.price;
+            fill.timestamp_ns = bc::to_nanos(f.timestamp);
+            fill.filled_size = f.filled_size;
+            fill.remaining_size = f.remaining_size;
+            append(&fill, sizeof(fill));
+        }
+        for (const auto& f : ev.mm_fills) {
+            bc::Fill fill{};
+            fill.order_id = f.order_id;
+            fill.trade_id = f.trade_id;
+            fill.price = f.price;
+            fill.timestamp_ns = bc::to_nanos(f.timestamp);
+            fill.fill_qty = f.fill_qty;
+            fill.leaves_qty = f.leaves_qty;
+            fill.symbol = symbol_for(f.instrument_id);
+            fill.side = f.side == Side::BUY ? 0 : 1;
+            append(&fill, sizeof(fill));
+        }
+        end_record();
+        state.reset(header);
+    }
+
+    // Appends the delta of `ev` against the symbol's previous event:
+    //
+    //   symbol, flags, seq - prev_seq - 1, ts step - prev ts step,
+    //   [bid count, ask count], bid level changes, ask level changes,
+    //   [best bid price/size change], [best ask ...], [trades], [partial fills], [mm fills]
+    //
+    // with every integer a varint (signed ones zigzagged). Bracketed parts
+    // are present when their DeltaFlags bit is set.
+    void encode_delta(const MarketDataEvent& ev, uint32_t symbol, binary_capture::DeltaState& state) {
+        namespace bc = binary_capture;
+        bc::EventHeader& last = state.last;
+        std::vector<uint8_t>& d = deltas_;
+
+        bc::put_varint(d, symbol);
+        const std::size_t flags_at = d.size();
+        d.push_back(0);
+        uint8_t flags = 0;
+        bc::put_signed(d, ev.sequence_number - last.sequence_number - 1);
+        const int64_t ts = bc::to_nanos(ev.timestamp);
+        const int64_t step = ts - last.timestamp_ns;
+        bc::put_signed(d, step - state.ts_step);
+        state.ts_step = step;
+
+        if (ev.bid_levels.size() != state.bids.size() || ev.ask_levels.size() != state.asks.size()) {
+            flags |= bc::kLevelCounts;
+            bc::put_varint(d, ev.bid_levels.size());
+            bc::put_varint(d, ev.ask_levels.size());
+        }
+        encode_side(ev.bid_levels, state.bids);
+        encode_side(ev.ask_levels, state.asks);
+
+        const bool implicit_bid = state.bids.empty()
+            ? ev.best_bid_price == 0 && ev.best_bid_size == 0
+            : ev.best_bid_price == state.bids[0].price && ev.best_bid_size == state.bids[0].size;
+        if (!implicit_bid) {
+            flags |= bc::kExplicitBestBid;
+            bc::put_signed(d, ev.best_bid_price - last.best_bid_price);
+            bc::put_signed(d, static_cast<int64_t>(ev.best_bid_size) - last.best_bid_size);
+        }
+        const bool implicit_ask = state.asks.empty()
+            ? ev.best_ask_price == 0 && ev.best_ask_size == 0
+            : ev.best_ask_price == state.asks[0].price && ev.best_ask_size == state.asks[0].size;
+        if (!implicit_ask) {
+            flags |= bc::kExplicitBestAsk;
+            bc::put_signed(d, ev.best_ask_price - last.best_ask_price);
+            bc::put_signed(d, static_cast<int64_t>(ev.best_ask_size) - last.best_ask_size);
         }
 
-        // Patch total_len at the start
-        uint32_t total_len = static_cast<uint32_t>(buf_.size());
-        std::memcpy(buf_.data(), &total_len, sizeof(total_len));
+        // Trade and fill prices are relative to the best bid, times to the event
+        const int64_t anchor = ev.best_bid_price;
+        if (!ev.trades.empty()) {
+            flags |= bc::kHasTrades;
+            bc::put_varint(d, ev.trades.size());
+            for (const auto& t : ev.trades) {
+                d.push_back(t.aggressor_side == Side::BUY ? 0 : 1);
+                bc::put_signed(d, t.price - anchor);
+                bc::put_signed(d, t.size);
+                bc::put_signed(d, bc::diff(t.trade_id, state.last_trade_id));
+                bc::put_signed(d, bc::to_nanos(t.timestamp) - ts);
+                state.last_trade_id = t.trade_id;
+            }
+        }
+        if (!ev.partial_fills.empty()) {
+            flags |= bc::kHasPartialFills;
+            bc::put_varint(d, ev.partial_fills.size());
+            for (const auto& f : ev.partial_fills) {
+                bc::put_signed(d, bc::diff(f.order_id, state.last_order_id));
+                bc::put_signed(d, f.price - anchor);
+                bc::put_signed(d, f.filled_size);
+                bc::put_signed(d, f.remaining_size);
+                bc::put_signed(d, bc::to_nanos(f.timestamp) - ts);
+                state.last_order_id = f.order_id;
+            }
+        }
+        if (!ev.mm_fills.empty()) {
+            flags |= bc::kHasMmFills;
+            bc::put_varint(d, ev.mm_fills.size());
+            for (const auto& f : ev.mm_fills) {
+                bc::put_signed(d, bc::diff(f.order_id, state.last_order_id));
+                bc::put_signed(d, bc::diff(f.trade_id, state.last_trade_id));
+                d.push_back(f.side == Side::BUY ? 0 : 1);
+                bc::put_varint(d, symbols_[f.instrument_id] - 1);
+                bc::put_signed(d, f.price - anchor);
+                bc::put_signed(d, f.fill_qty);
+                bc::put_signed(d, f.leaves_qty);
+                bc::put_signed(d, bc::to_nanos(f.timestamp) - ts);
+                state.last_order_id = f.order_id;
+                state.last_trade_id = f.trade_id;
+            }
+        }
+        d[flags_at] = flags;
 
-        out_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+        last.sequence_number = ev.sequence_number;
+        last.timestamp_ns = ts;
+        last.best_bid_price = ev.best_bid_price;
+        last.best_ask_price = ev.best_ask_price;
+        last.best_bid_size = ev.best_bid_size;
+        last.best_ask_size = ev.best_ask_size;
     }
 
-    void flush() { out_.flush(); }
+    // Changed levels of one side as (index gap << 2 | LevelFlags), price
+    // change relative to the previous changed level's, size change, then the
+    // flagged order id and timestamp changes; levels past the previous depth
+    // are diffed against zero
+    void encode_side(const LevelList& levels, std::vector<binary_capture::Level>& prev) {
+        namespace bc = binary_capture;
+        std::vector<uint8_t>& s = side_scratch_;
+        s.clear();
+        uint64_t changed = 0;
+        int64_t last_index = -1;
+        int64_t last_move = 0;
+        const std::size_t old_size = prev.size();
+        prev.resize(levels.size());
+        for (std::size_t i = 0; i < levels.size(); ++i) {
+            const bc::Level now = to_wire(levels[i]);
+            const bc::Level was = i < old_size ? prev[i] : bc::Level{};
+            prev[i] = now;
+            if (now.price == was.price && now.size == was.size && now.order_id == was.order_id &&
+                now.timestamp_ns == was.timestamp_ns) {
+                continue;
+            }
+            const uint64_t level_flags = (now.order_id != was.order_id ? bc::kLevelOrderId : 0) |
+                                         (now.timestamp_ns != was.timestamp_ns ? bc::kLevelTimestamp : 0);
+            const uint64_t gap = static_cast<uint64_t>(static_cast<int64_t>(i) - last_index - 1);
+            bc::put_varint(s, gap << bc::kLevelFlagBits | level_flags);
+            const int64_t move = now.price - was.price;
+            bc::put_signed(s, move - last_move);
+            bc::put_signed(s, static_cast<int64_t>(now.size) - was.size);
+            if (level_flags & bc::kLevelOrderId) {
+                bc::put_signed(s, bc::diff(now.order_id, was.order_id));
+            }
+            if (level_flags & bc::kLevelTimestamp) {
+                bc::put_signed(s, now.timestamp_ns - was.timestamp_ns);
+            }
+            last_move = move;
+            last_index = static_cast<int64_t>(i);
+            ++changed;
+        }
+        bc::put_varint(deltas_, changed);
+        deltas_.insert(deltas_.end(), s.begin(), s.end());
+    }
 
-private:
-    std::ofstream out_;
-    std::vector<char> buf_;
+    // Emits the pending deltas as one delta block record
+    void flush_deltas() {
+        if (delta_count_ == 0) {
+            return;
+        }
+        const binary_capture::DeltaBlock block{delta_count_, static_cast<uint32_t>(deltas_.size())};
+        begin_record(binary_capture::kDeltaBlockRecord,
+                     sizeof(binary_capture::RecordHeader) + sizeof(block) + deltas_.size());
+        append(&block, sizeof(block));
+        append(deltas_.data(), deltas_.size());
+        end_record();
+        deltas_.clear();
+        delta_count_ = 0;
+    }
 
-    template <typename T>
-    void append(T value) {
-        const char* p = reinterpret_cast<const char*>(&value);
-        buf_.insert(buf_.end(), p, p + sizeof(T));
+    void append(const void* data, std::size_t size) {
+        const char* p = static_cast<const char*>(data);
+        buf_.insert(buf_.end(), p, p + size);
+    }
+
+    void begin_record(uint32_t type, std::size_t body_and_header) {
+        const binary_capture::RecordHeader header{
+            static_cast<uint32_t>(binary_capture::padded(body_and_header)), type};
+        append(&header, sizeof(header));
+    }
+
+    // Pads the record and hands full buffers to the file
+    void end_record() {
+        buf_.resize(binary_capture::padded(buf_.size()), '\0');
+        if (buf_.size() >= kWriteBytes) {
+            out_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+            written_ += buf_.size();
+            buf_.clear();
+        }
+    }
+
+    // File-local id of an instrument, writing its symbol record on first use
+    uint32_t symbol_for(InstrumentId id) {
+        if (id >= symbols_.size()) {
+            symbols_.resize(id + 1, 0);
+        }
+        if (symbols_[id] == 0) {
+            flush_deltas();  // records stay in event order
+            if (index_.is_open()) {
+                index_.add_symbol(position());
+            }
+            const std::string& name = InstrumentRegistry::global().name(id);
+            const binary_capture::SymbolRecord record{next_symbol_, static_cast<uint32_t>(name.size())};
+            begin_record(binary_capture::kSymbolRecord,
+                         sizeof(binary_capture::RecordHeader) + sizeof(record) + name.size());
+            append(&record, sizeof(record));
+            append(name.data(), name.size());
+            end_record();
+            symbols_[id] = ++next_symbol_;
+            states_.emplace_back();
+        }
+        return symbols_[id] - 1;
     }
 };
 
@@ -0,0 +1,485 @@
+#ifndef COLUMN_STORE_H
+#define COLUMN_STORE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+#include "../MarketDataEvent.h"
+#include "BinaryCapture.h"
+#include "MappedFile.h"
+#include "Span.h"
+
+// Columnar export of the event stream for analytics scans.
+//
+// A store is a directory holding one file per column. The events table has
+// a row per event (timestamp_ns, sequence, bid_price, ask_price, bid_size,
+// ask_size); the trades table has a row per trade (trade_timestamp_ns,
+// trade_sequence, trade_price, trade_size, trade_side), trade_sequence
+// being the sequence number of the event that carried it. Prices are ticks,
+// timestamps nanoseconds since the epoch.
+//
+// A column file is a ColumnHeader, the values as one packed little-endian
+// array from byte kDataOffset, then one BlockStats (min and max) per
+// block_rows values. The whole file is mapped and the values used in place.
+// The header is rewritten with the row count when the writer closes, so a
+// store whose writer died reads as empty rather than half written.
+namespace column_store {
+
+constexpr char kMagic[8] = {'M', 'M', 'C', 'O', 'L', 'U', 'M', 'N'};
+constexpr uint16_t kVersion = 1;
+constexpr uint32_t kDefaultBlockRows = 65536;
+constexpr uint64_t kDataOffset = 64;
+
+enum ValueType : uint16_t {
+    kInt64 = 1,
+    kInt32 = 2,
+    kUInt8 = 3
+};
+
+struct ColumnHeader {
+    char magic[8];
+    uint16_t version;
+    uint16_t value_type;
+    uint32_t block_rows;
+    uint64_t rows;
+    uint64_t stats_offset;  // BlockStats array, ceil(rows / block_rows) entries
+    char reserved[32];
+};
+
+struct BlockStats {
+    int64_t min;
+    int64_t max;
+};
+
+static_assert(sizeof(ColumnHeader) == kDataOffset, "column layout");
+static_assert(sizeof(BlockStats) == 16, "column layout");
+
+template <typename T>
+struct ValueTraits;
+template <>
+struct ValueTraits<int64_t> {
+    static constexpr ValueType kType = kInt64;
+};
+template <>
+struct ValueTraits<int32_t> {
+    static constexpr ValueType kType = kInt32;
+};
+template <>
+struct ValueTraits<uint8_t> {
+    static constexpr ValueType kType = kUInt8;
+};
+
+inline std::string column_path(const std::string& dir, const std::string& name) {
+    return dir + "/" + name + ".col";
+}
+
+// Appends one column, a block at a time
+template <typename T>
+class ColumnWriter {
+public:
+    bool open(const std::string& path, uint32_t block_rows) {
+        out_.open(path, std::ios::binary | std::ios::trunc);
+        if (!out_) {
+            return false;
+        }
+        block_rows_ = block_rows == 0 ? 1 : block_rows;
+        rows_ = 0;
+        block_.clear();
+        block_.reserve(block_rows_);
+        stats_.clear();
+        write_header(0, 0);  // rows stay 0 until close()
+        out_.flush();
+        return static_cast<bool>(out_);
+    }
+
+    void append(T value) {
+        block_.push_back(value);
+        if (block_.size() == block_rows_) {
+            flush_block();
+        }
+    }
+
+    // Writes the last block, the stats and the final header
+    bool close() {
+        if (!out_.is_open()) {
+            return true;
+        }
+        flush_block();
+        const uint64_t data_end = kDataOffset + rows_ * sizeof(T);
+        const uint64_t stats_offset = binary_capture::padded(data_end);
+        const char zeros[binary_capture::kRecordAlign] = {};
+        out_.write(zeros, static_cast<std::streamsize>(stats_offset - data_end));
+        out_.write(reinterpret_cast<const char*>(stats_.data()),
+                   static_cast<std::streamsize>(stats_.size() * sizeof(BlockStats)));
+        out_.seekp(0);
+        write_header(rows_, stats_offset);
+        const bool ok = static_cast<bool>(out_);
+        out_.close();
+        return ok;
+    }
+
+private:
+    void write_header(uint64_t rows, uint64_t stats_offset) {
+        ColumnHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(header.magic));
+        header.version = kVersion;
+        header.value_type = ValueTraits<T>::kType;
+        header.block_rows = block_rows_;
+        header.rows = rows;
+        header.stats_offset = stats_offset;
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    void flush_block() {
+        if (block_.empty()) {
+            return;
+        }
+        const auto [lo, hi] = std::minmax_element(block_.begin(), block_.end());
+        stats_.push_back(BlockStats{static_cast<int64_t>(*lo), static_cast<int64_t>(*hi)});
+        out_.write(reinterpret_cast<const char*>(block_.data()), static_cast<std::streamsize>(block_.size() * sizeof(T)));
+        rows_ += block_.size();
+        block_.clear();
+    }
+
+    std::ofstream out_;
+    uint32_t block_rows_ = kDefaultBlockRows;
+    uint64_t rows_ = 0;
+    std::vector<T> block_;
+    std::vector<BlockStats> stats_;
+};
+
+} // namespace column_store
+
+// Exports events into a column store directory, created if missing. Top of
+// book goes to the events table and every trade to the trades table; depth
+// and fills stay in the binary capture.
+class ColumnStoreWriter {
+public:
+    ColumnStoreWriter() = default;
+    ~ColumnStoreWriter() { close(); }
+
+    ColumnStoreWriter(const ColumnStoreWriter&) = delete;
+    ColumnStoreWriter& operator=(const ColumnStoreWriter&) = delete;
+
+    // False if the directory or a column file cannot be created
+    bool open(const std::string& dir, uint32_t block_rows = column_store::kDefaultBlockRows) {
+        if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+        using column_store::column_path;
+        return timestamp_.open(column_path(dir, "timestamp_ns"), block_rows) &&
+               sequence_.open(column_path(dir, "sequence"), block_rows) &&
+               bid_price_.open(column_path(dir, "bid_price"), block_rows) &&
+               ask_price_.open(column_path(dir, "ask_price"), block_rows) &&
+               bid_size_.open(column_path(dir, "bid_size"), block_rows) &&
+               ask_size_.open(column_path(dir, "ask_size"), block_rows) &&
+               trade_timestamp_.open(column_path(dir, "trade_timestamp_ns"), block_rows) &&
+               trade_sequence_.open(column_path(dir, "trade_sequence"), block_rows) &&
+               trade_price_.open(column_path(dir, "trade_price"), block_rows) &&
+               trade_size_.open(column_path(dir, "trade_size"), block_rows) &&
+               trade_side_.open(column_path(dir, "trade_side"), block_rows);
+    }
+
+    void append(const MarketDataEvent& event) {
+        timestamp_.append(binary_capture::to_nanos(event.timestamp));
+        sequence_.append(event.sequence_number);
+        bid_price_.append(event.best_bid_price);
+        ask_price_.append(event.best_ask_price);
+        bid_size_.append(event.best_bid_size);
+        ask_size_.append(event.best_ask_size);
+        for (const auto& trade : event.trades) {
+            trade_timestamp_.append(binary_capture::to_nanos(trade.timestamp));
+            trade_sequence_.append(event.sequence_number);
+            trade_price_.append(trade.price);
+            trade_size_.append(trade.size);
+            trade_side_.append(trade.aggressor_side == Side::BUY ? 0 : 1);
+        }
+    }
+
+    // Finishes every column; false if any write failed
+    bool close() {
+        bool ok = timestamp_.close();
+        ok = sequence_.close() && ok;
+        ok = bid_price_.close() && ok;
+        ok = ask_price_.close() && ok;
+        ok = bid_size_.close() && ok;
+        ok = ask_size_.close() && ok;
+        ok = trade_timestamp_.close() && ok;
+        ok = trade_sequence_.close() && ok;
+        ok = trade_price_.close() && ok;
+        ok = trade_size_.close() && ok;
+        ok = trade_side_.close() && ok;
+        return ok;
+    }
+
+private:
+    column_store::ColumnWriter<int64_t> timestamp_;
+    column_store::ColumnWriter<int64_t> sequence_;
+    column_store::ColumnWriter<int64_t> bid_price_;
+    column_store::ColumnWriter<int64_t> ask_price_;
+    column_store::ColumnWriter<int32_t> bid_size_;
+    column_store::ColumnWriter<int32_t> ask_size_;
+    column_store::ColumnWriter<int64_t> trade_timestamp_;
+    column_store::ColumnWriter<int64_t> trade_sequence_;
+    column_store::ColumnWriter<int64_t> trade_price_;
+    column_store::ColumnWriter<int32_t> trade_size_;
+    column_store::ColumnWriter<uint8_t> trade_side_;
+};
+
+// One mapped column: the values in place and their block stats
+template <typename T>
+class Column {
+public:
+    // Throws if the file is missing, not a column, or not of type T
+    explicit Column(const std::string& path) : file_(std::make_unique<MappedFile>()) {
+        namespace cs = column_store;
+        if (!file_->open(path)) {
+            throw std::runtime_error("Cannot open column " + path);
+        }
+        cs::ColumnHeader header{};
+        if (file_->size() < sizeof(header)) {
+            throw std::runtime_error("Not a column file (too short): " + path);
+        }
+        std::memcpy(&header, file_->data(), sizeof(header));
+        if (std::memcmp(header.magic, cs::kMagic, sizeof(cs::kMagic)) != 0 || header.version != cs::kVersion) {
+            throw std::runtime_error("Not a column file: " + path);
+        }
+        if (header.value_type != cs::ValueTraits<T>::kType) {
+            throw std::runtime_error("Column " + path + " has value type " + std::to_string(header.value_type));
+        }
+        const uint64_t blocks = header.block_rows == 0 ? 0 : (header.rows + header.block_rows - 1) / header.block_rows;
+        if (header.rows > 0 && (header.block_rows == 0 || header.stats_offset < cs::kDataOffset + header.rows * sizeof(T) ||
+                                header.stats_offset + blocks * sizeof(cs::BlockStats) > file_->size())) {
+            throw std::runtime_error("Corrupt column file: " + path);
+        }
+        block_rows_ = header.block_rows;
+        values_ = Span<const T>(reinterpret_cast<const T*>(file_->data() + cs::kDataOffset), header.rows);
+        stats_ = Span<const cs::BlockStats>(
+            reinterpret_cast<const cs::BlockStats*>(file_->data() + header.stats_offset), blocks);
+    }
+
+    std::size_t rows() const { return values_.size(); }
+    std::size_t block_rows() const { return block_rows_; }
+    std::size_t blocks() const { return stats_.size(); }
+    Span<const T> values() const { return values_; }
+    const column_store::BlockStats& stats(std::size_t block) const { return stats_[block]; }
+
+private:
+    std::unique_ptr<MappedFile> file_;
+    std::size_t block_rows_ = 0;
+    Span<const T> values_;
+    Span<const column_store::BlockStats> stats_;
+};
+
+// A column store directory opened for scanning
+class ColumnStore {
+public:
+    explicit ColumnStore(std::string dir) : dir_(std::move(dir)) {}
+
+    template <typename T>
+    Column<T> column(const std::string& name) const {
+        return Column<T>(column_store::column_path(dir_, name));
+    }
+
+    const std::string& dir() const { return dir_; }
+
+private:
+    std::string dir_;
+};
+
+// Aggregations over a row range of mapped columns. Blocks that the stats
+// settle are not read: min/max take whole blocks from the stats, and
+// count_between and sum_where_equal skip blocks whose range cannot match
+// and count or sum blocks that match entirely. The loops over the rest are
+// plain branch-free passes over contiguous arrays with wide accumulators,
+// which the compiler vectorizes.
+namespace column_scan {
+
+struct RowRange {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::size_t size() const { return end - begin; }
+    bool empty() const { return end == begin; }
+};
+
+template <typename T>
+RowRange all(const Column<T>& column) {
+    return RowRange{0, column.rows()};
+}
+
+// Calls fn(block, begin, end, whole) for each block overlapping `range`,
+// `whole` telling whether the range covers the block entirely
+template <typename T, typename Fn>
+void for_each_block(const Column<T>& column, RowRange range, Fn&& fn) {
+    const std::size_t block_rows = column.block_rows();
+    for (std::size_t begin = range.begin; begin < range.end;) {
+        const std::size_t block = begin / block_rows;
+        const std::size_t block_end = std::min((block + 1) * block_rows, column.rows());
+        const std::size_t end = std::min(block_end, range.end);
+        fn(block, begin, end, begin == block * block_rows && end == block_end);
+        begin = end;
+    }
+}
+
+// Rows of a non-decreasing column (timestamps, sequence numbers) whose value
+// is in [lo, hi]: a binary search over the block stats, then within the two
+// edge blocks
+template <typename T>
+RowRange rows_between(const Column<T>& sorted, int64_t lo, int64_t hi) {
+    const Span<const T> v = sorted.values();
+    auto first_at_least = [&](int64_t x) {
+        std::size_t a = 0;
+        std::size_t b = sorted.blocks();
+        while (a < b) {  // first block whose max >= x
+            const std::size_t mid = (a + b) / 2;
+            if (sorted.stats(mid).max < x) {
+                a = mid + 1;
+            } else {
+                b = mid;
+            }
+        }
+        if (a == sorted.blocks()) {
+            return sorted.rows();
+        }
+        const T* begin = v.data() + a * sorted.block_rows();
+        const T* end = v.data() + std::min((a + 1) * sorted.block_rows(), sorted.rows());
+        return static_cast<std::size_t>(
+            std::lower_bound(begin, end, x, [](T value, int64_t key) { return value < key; }) - v.data());
+    };
+    if (lo > hi) {
+        return RowRange{};
+    }
+    const std::size_t begin = first_at_least(lo);
+    const std::size_t end = hi == std::numeric_limits<int64_t>::max() ? sorted.rows() : first_at_least(hi + 1);
+    return RowRange{begin, std::max(begin, end)};
+}
+
+template <typename T>
+int64_t sum(const Column<T>& column, RowRange range) {
+    const T* v = column.values().data();
+    int64_t total = 0;
+    for (std::size_t i = range.begin; i < range.end; ++i) {
+        total += v[i];
+    }
+    return total;
+}
+
+// Sum of a[i] - b[i], e.g. ask_price and bid_price for the total spread
+template <typename T>
+int64_t sum_diff(const Column<T>& a, const Column<T>& b, RowRange range) {
+    if (a.rows() != b.rows()) {
+        throw std::invalid_argument("sum_diff needs columns of one table");
+    }
+    const T* x = a.values().data();
+    const T* y = b.values().data();
+    int64_t total = 0;
+    for (std::size_t i = range.begin; i < range.end; ++i) {
+        total += static_cast<int64_t>(x[i]) - y[i];
+    }
+    return total;
+}
+
+// Smallest value in a non-empty range
+template <typename T>
+int64_t min(const Column<T>& column, RowRange range) {
+    int64_t best = std::numeric_limits<int64_t>::max();
+    for_each_block(column, range, [&](std::size_t block, std::size_t begin, std::size_t end, bool whole) {
+        if (whole) {
+            best = std::min(best, column.stats(block).min);
+            return;
+        }
+        const T* v = column.values().data();
+        T m = v[begin];
+        for (std::size_t i = begin; i < end; ++i) {
+            m = v[i] < m ? v[i] : m;
+        }
+        best = std::min<int64_t>(best, m);
+    });
+    return best;
+}
+
+// Largest value in a non-empty range
+template <typename T>
+int64_t max(const Column<T>& column, RowRange range) {
+    int64_t best = std::numeric_limits<int64_t>::min();
+    for_each_block(column, range, [&](std::size_t block, std::size_t begin, std::size_t end, bool whole) {
+        if (whole) {
+            best = std::max(best, column.stats(block).max);
+            return;
+        }
+        const T* v = column.values().data();
+        T m = v[begin];
+        for (std::size_t i = begin; i < end; ++i) {
+            m = v[i] > m ? v[i] : m;
+        }
+        best = std::max<int64_t>(best, m);
+    });
+    return best;
+}
+
+// Rows whose value is in [lo, hi]
+template <typename T>
+std::size_t count_between(const Column<T>& column, int64_t lo, int64_t hi, RowRange range) {
+    std::size_t count = 0;
+    for_each_block(column, range, [&](std::size_t block, std::size_t begin, std::size_t end, bool whole) {
+        const column_store::BlockStats& s = column.stats(block);
+        if (s.max < lo || s.min > hi) {
+            return;
+        }
+        if (whole && s.min >= lo && s.max <= hi) {
+            count += end - begin;
+            return;
+        }
+        const T* v = column.values().data();
+        std::size_t n = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            n += static_cast<std::size_t>(v[i] >= lo) & static_cast<std::size_t>(v[i] <= hi);
+        }
+        count += n;
+    });
+    return count;
+}
+
+// Sum of values[i] over the rows where keys[i] == key, e.g. trade_size by
+// trade_side
+template <typename V, typename K>
+int64_t sum_where_equal(const Column<V>& values, const Column<K>& keys, K key, RowRange range) {
+    if (values.rows() != keys.rows()) {
+        throw std::invalid_argument("sum_where_equal needs columns of one table");
+    }
+    int64_t total = 0;
+    for_each_block(keys, range, [&](std::size_t block, std::size_t begin, std::size_t end, bool) {
+        const column_store::BlockStats& s = keys.stats(block);
+        if (key < s.min || key > s.max) {
+            return;
+        }
+        const V* v = values.values().data();
+        if (s.min == s.max) {
+            for (std::size_t i = begin; i < end; ++i) {
+                total += v[i];
+            }
+            return;
+        }
+        const K* k = keys.values().data();
+        int64_t part = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            part += static_cast<int64_t>(v[i]) & -static_cast<int64_t>(k[i] == key);
+        }
+        total += part;
+    });
+    return total;
+}
+
+} // namespace column_scan
+
+#endif // COLUMN_STORE_H
@@ -0,0 +1,253 @@
+#ifndef EVENT_LOG_PARSER_H
+#define EVENT_LOG_PARSER_H
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include "../MarketDataEvent.h"
+#include "InstrumentRegistry.h"
+#include "Price.h"
+
+// Parser for one line of the text event log written by MarketSimulator:
+//
+//   seq|symbol|bid|ask|bid_size|ask_size|ts_ms|bid_levels|ask_levels|trades|partial_fills
+//
+// where timestamps are whole milliseconds, or ts_ms.nnnnnn with the
+// sub-millisecond nanoseconds when the clock ticks finer, and the list
+// fields are ';'-separated entries of ','-separated tokens.
+// Tokens are string_views into the line and numbers are decoded with
+// std::from_chars, so parsing makes no intermediate copies; lists are decoded
+// straight into the event's containers, which keep their capacity when the
+// same event is parsed into again. Malformed input throws std::runtime_error.
+class EventLogParser {
+public:
+    void parse(std::string_view line, MarketDataEvent& event) {
+        std::string_view fields[kFieldCount];
+        std::size_t count = 0;
+        for_each(line, '|', [&](std::string_view field) {
+            if (count == kFieldCount) {
+                throw std::runtime_error("Malformed replay log line");
+            }
+            fields[count++] = field;
+        });
+        if (count != kFieldCount) {
+            throw std::runtime_error("Malformed replay log line");
+        }
+
+        event.sequence_number = parse_number<int64_t>(fields[0]);
+        event.instrument_id = intern(fields[1]);
+        event.best_bid_price = parse_ticks(fields[2]);
+        event.best_ask_price = parse_ticks(fields[3]);
+        event.best_bid_size = parse_number<int>(fields[4]);
+        event.best_ask_size = parse_number<int>(fields[5]);
+        event.timestamp = parse_time(fields[6]);
+        parse_levels(fields[7], event.bid_levels);
+        parse_levels(fields[8], event.ask_levels);
+        parse_trades(fields[9], event.trades);
+        parse_partial_fills(fields[10], event.partial_fills);
+        event.mm_fills.clear();  // not part of the log
+    }
+
+    // Decimal price to ticks. Up to kPriceDecimals fractional digits (what the
+    // log writes) are converted exactly in integer arithmetic; longer inputs
+    // go through to_ticks(double) like any other price.
+    static Price parse_ticks(std::string_view tok) {
+        const char* p = tok.data();
+        const char* end = p + tok.size();
+        const bool negative = p != end && *p == '-';
+        p += negative ? 1 : 0;
+        if (p != end && *p == '-') {
+            throw_bad_number(tok);
+        }
+
+        int64_t whole = 0;
+        auto res = std::from_chars(p, end, whole);
+        if (res.ec != std::errc() && !(res.ec == std::errc::invalid_argument && p != end && *p == '.')) {
+            throw_bad_number(tok);
+        }
+        p = res.ec == std::errc() ? res.ptr : p;
+
+        int64_t frac = 0;
+        int digits = 0;
+        if (p != end && *p == '.') {
+            ++p;
+            for (; p != end && *p >= '0' && *p <= '9'; ++p, ++digits) {
+                if (digits == kPriceDecimals) {
+                    return to_ticks(parse_number<double>(tok));
+                }
+                frac = frac * 10 + (*p - '0');
+            }
+        }
+        const bool has_digits = res.ec == std::errc() || digits > 0;
+        if (p != end || !has_digits) {
+            throw_bad_number(tok);
+        }
+        for (int d = digits; d < kPriceDecimals; ++d) {
+            frac *= 10;
+        }
+        const Price ticks = whole * kTicksPerUnit + frac;
+        return negative ? -ticks : ticks;
+    }
+
+    template <typename T>
+    static T parse_number(std::string_view tok) {
+        T value{};
+        const char* end = tok.data() + tok.size();
+        std::from_chars_result res{};
+        if constexpr (std::is_floating_point<T>::value) {
+            res = parse_floating(tok, value);
+        } else {
+            res = std::from_chars(tok.data(), end, value);
+        }
+        if (res.ec != std::errc() || res.ptr != end || tok.empty()) {
+            throw_bad_number(tok);
+        }
+        return value;
+    }
+
+private:
+    static constexpr std::size_t kFieldCount = 11;
+
+    // Calls fn(token) for each delim-separated token of `s`, empty ones included
+    template <typename Fn>
+    static void for_each(std::string_view s, char delim, Fn&& fn) {
+        std::size_t start = 0;
+        for (;;) {
+            const std::size_t pos = s.find(delim, start);
+            if (pos == std::string_view::npos) {
+                fn(s.substr(start));
+                return;
+            }
+            fn(s.substr(start, pos - start));
+            start = pos + 1;
+        }
+    }
+
+    // Splits an entry into exactly N ','-separated tokens
+    template <std::size_t N>
+    static void split_entry(std::string_view entry, std::string_view (&tokens)[N], const char* what) {
+        std::size_t count = 0;
+        for_each(entry, ',', [&](std::string_view tok) {
+            if (count == N) {
+                throw std::runtime_error(what);
+            }
+            tokens[count++] = tok;
+        });
+        if (count != N) {
+            throw std::runtime_error(what);
+        }
+    }
+
+    static void parse_levels(std::string_view raw, LevelList& levels) {
+        levels.clear();
+        if (raw.empty()) {
+            return;
+        }
+        for_each(raw, ';', [&levels](std::string_view entry) {
+            if (entry.empty()) {
+                return;
+            }
+            std::string_view t[4];
+            split_entry(entry, t, "Malformed level entry");
+            levels.emplace_back(parse_ticks(t[0]), parse_number<int>(t[1]), parse_number<uint64_t>(t[2]),
+                                parse_time(t[3]));
+        });
+    }
+
+    static void parse_trades(std::string_view raw, TradeList& trades) {
+        trades.clear();
+        if (raw.empty()) {
+            return;
+        }
+        for_each(raw, ';', [&trades](std::string_view entry) {
+            if (entry.empty()) {
+                return;
+            }
+            std::string_view t[5];
+            split_entry(entry, t, "Malformed trade entry");
+            trades.push_back(Trade{t[0] == "BUY" ? Side::BUY : Side::SELL, parse_ticks(t[1]),
+                                   parse_number<int>(t[2]), parse_number<uint64_t>(t[3]),
+                                   parse_time(t[4])});
+        });
+    }
+
+    static void parse_partial_fills(std::string_view raw, PartialFillList& fills) {
+        fills.clear();
+        if (raw.empty()) {
+            return;
+        }
+        for_each(raw, ';', [&fills](std::string_view entry) {
+            if (entry.empty()) {
+                return;
+            }
+            std::string_view t[5];
+            split_entry(entry, t, "Malformed partial fill entry");
+            fills.push_back(PartialFillEvent{parse_number<uint64_t>(t[0]), parse_ticks(t[1]),
+                                             parse_number<int>(t[2]), parse_number<int>(t[3]),
+                                             parse_time(t[4])});
+        });
+    }
+
+    // A log normally carries one symbol, so the id is cached and the registry
+    // (which needs a std::string key) is only consulted when the symbol changes
+    InstrumentId intern(std::string_view symbol) {
+        if (symbol != last_symbol_ || last_id_ == kNoInstrument) {
+            last_symbol_.assign(symbol.data(), symbol.size());
+            last_id_ = InstrumentRegistry::global().intern(last_symbol_);
+        }
+        return last_id_;
+    }
+
+    // Milliseconds with an optional fraction of up to six digits (nanoseconds)
+    static std::chrono::system_clock::time_point parse_time(std::string_view tok) {
+        const std::size_t dot = tok.find('.');
+        const int64_t ms = parse_number<int64_t>(tok.substr(0, dot));
+        int64_t ns = 0;
+        if (dot != std::string_view::npos) {
+            const std::string_view frac = tok.substr(dot + 1);
+            if (frac.empty() || frac.size() > 6 || frac[0] < '0' || frac[0] > '9') {
+                throw_bad_number(tok);
+            }
+            ns = parse_number<int64_t>(frac);
+            for (std::size_t d = frac.size(); d < 6; ++d) {
+                ns *= 10;
+            }
+        }
+        return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::milliseconds(ms) + std::chrono::nanoseconds(ns)));
+    }
+
+    // Floating-point from_chars is missing from some standard libraries
+    // (libc++ before 20); fall back to strtod on a stack copy there
+    static std::from_chars_result parse_floating(std::string_view tok, double& value) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        return std::from_chars(tok.data(), tok.data() + tok.size(), value);
+#else
+        char buf[64];
+        if (tok.size() >= sizeof(buf)) {
+            return {tok.data(), std::errc::result_out_of_range};
+        }
+        std::memcpy(buf, tok.data(), tok.size());
+        buf[tok.size()] = '\0';
+        char* end = nullptr;
+        value = std::strtod(buf, &end);
+        return {tok.data() + (end - buf), end == buf ? std::errc::invalid_argument : std::errc()};
+#endif
+    }
+
+    [[noreturn]] static void throw_bad_number(std::string_view tok) {
+        throw std::runtime_error("Malformed number: '" + std::string(tok) + "'");
+    }
+
+    std::string last_symbol_;
+    InstrumentId last_id_ = kNoInstrument;
+};
+
+#endif // EVENT_LOG_PARSER_H
@@ -0,0 +1,80 @@
+#ifndef EVENT_SCHEDULER_H
+#define EVENT_SCHEDULER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Simulated time: nanoseconds since the system_clock epoch. Virtual time only
+// moves when the simulator advances it, never by sleeping.
+using SimTime = int64_t;
+
+inline SimTime to_sim_time(std::chrono::system_clock::time_point ts) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+}
+
+inline std::chrono::system_clock::time_point from_sim_time(SimTime t) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(t)));
+}
+
+// Min-heap of payloads keyed on simulated time. Entries due at the same time
+// run in the order they were scheduled, so a run is deterministic for a given
+// input sequence. The heap vector keeps its capacity, so a warmed-up
+// scheduler does not allocate.
+template <typename Payload>
+class EventScheduler {
+public:
+    void reserve(std::size_t n) { heap_.reserve(n); }
+
+    void schedule(SimTime at, const Payload& payload) {
+        heap_.push_back(Entry{at, next_seq_++, payload});
+        std::push_heap(heap_.begin(), heap_.end(), Later{});
+    }
+
+    bool empty() const { return heap_.empty(); }
+    std::size_t size() const { return heap_.size(); }
+
+    // Time of the earliest entry; only valid when !empty()
+    SimTime next_time() const { return heap_.front().time; }
+
+    // Pops every entry due at or before `until`, earliest first, and hands it
+    // to fn(time, payload). fn may schedule further entries; those run in the
+    // same call if they are also due. Returns the number of entries run.
+    template <typename Fn>
+    std::size_t run_until(SimTime until, Fn&& fn) {
+        std::size_t ran = 0;
+        while (!heap_.empty() && heap_.front().time <= until) {
+            std::pop_heap(heap_.begin(), heap_.end(), Later{});
+            Entry entry = std::move(heap_.back());
+            heap_.pop_back();
+            fn(entry.time, entry.payload);
+            ++ran;
+        }
+        return ran;
+    }
+
+    void clear() { heap_.clear(); }
+
+private:
+    struct Entry {
+        SimTime time;
+        uint64_t seq;
+        Payload payload;
+    };
+
+    // std heap functions build a max-heap; invert so the earliest entry is on top
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.time != b.time ? a.time > b.time : a.seq > b.seq;
+        }
+    };
+
+    std::vector<Entry> heap_;
+    uint64_t next_seq_ = 0;
+};
+
+#endif // EVENT_SCHEDULER_H
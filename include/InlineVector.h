@@ -0,0 +1,178 @@
+#ifndef INLINE_VECTOR_H
+#define INLINE_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Vector with room for N elements inside the object itself. Up to N elements
+// live in the inline buffer, so a struct of InlineVectors is one contiguous
+// block and copying it touches no allocator. Past N it spills to the heap
+// like std::vector. Once spilled it keeps the heap block across clear(), so a
+// reused container does not bounce between the two.
+template <typename T, std::size_t N>
+class InlineVector {
+    static_assert(N > 0, "InlineVector needs a non-zero inline capacity");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_type inline_capacity = N;
+
+    InlineVector() noexcept = default;
+
+    InlineVector(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+
+    InlineVector(const InlineVector& other) { assign(other.begin(), other.end()); }
+
+    InlineVector(InlineVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        take(std::move(other));
+    }
+
+    InlineVector& operator=(const InlineVector& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    InlineVector& operator=(InlineVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            clear();
+            release_heap();
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    ~InlineVector() {
+        clear();
+        release_heap();
+    }
+
+    // Replaces the contents, reusing current capacity when it fits
+    template <typename It>
+    void assign(It first, It last) {
+        clear();
+        reserve(static_cast<size_type>(std::distance(first, last)));
+        for (; first != last; ++first) {
+            ::new (static_cast<void*>(data_ + size_)) T(*first);
+            ++size_;
+        }
+    }
+
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+    bool empty() const noexcept { return size_ == 0; }
+    bool is_inline() const noexcept { return data_ == inline_data(); }
+
+    T* data() noexcept { return data_; }
+    const T* data() const noexcept { return data_; }
+    iterator begin() noexcept { return data_; }
+    iterator end() noexcept { return data_ + size_; }
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+
+    T& operator[](size_type i) noexcept { return data_[i]; }
+    const T& operator[](size_type i) const noexcept { return data_[i]; }
+    T& front() noexcept { return data_[0]; }
+    const T& front() const noexcept { return data_[0]; }
+    T& back() noexcept { return data_[size_ - 1]; }
+    const T& back() const noexcept { return data_[size_ - 1]; }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            // Construct first: args may alias an element that grow() moves
+            T tmp(std::forward<Args>(args)...);
+            grow(capacity_ * 2);
+            ::new (static_cast<void*>(data_ + size_)) T(std::move(tmp));
+        } else {
+            ::new (static_cast<void*>(data_ + size_)) T(std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    void pop_back() noexcept { data_[--size_].~T(); }
+
+    void clear() noexcept {
+        destroy_range(data_, data_ + size_);
+        size_ = 0;
+    }
+
+    void reserve(size_type n) {
+        if (n > capacity_) {
+            grow(std::max(n, capacity_ * 2));
+        }
+    }
+
+private:
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    T* data_ = inline_data();
+    size_type size_ = 0;
+    size_type capacity_ = N;
+
+    T* inline_data() noexcept { return reinterpret_cast<T*>(inline_); }
+    const T* inline_data() const noexcept { return reinterpret_cast<const T*>(inline_); }
+
+    static void destroy_range(T* first, T* last) noexcept {
+        if (!std::is_trivially_destructible<T>::value) {
+            for (; first != last; ++first) {
+                first->~T();
+            }
+        }
+    }
+
+    void grow(size_type new_capacity) {
+        T* fresh = static_cast<T*>(::operator new(new_capacity * sizeof(T), std::align_val_t(alignof(T))));
+        for (size_type i = 0; i < size_; ++i) {
+            ::new (static_cast<void*>(fresh + i)) T(std::move_if_noexcept(data_[i]));
+        }
+        destroy_range(data_, data_ + size_);
+        release_heap();
+        data_ = fresh;
+        capacity_ = new_capacity;
+    }
+
+    void release_heap() noexcept {
+        if (!is_inline()) {
+            ::operator delete(data_, std::align_val_t(alignof(T)));
+            data_ = inline_data();
+            capacity_ = N;
+        }
+    }
+
+    // Precondition: *this is empty and inline
+    void take(InlineVector&& other) {
+        if (!other.is_inline()) {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inline_data();
+            other.size_ = 0;
+            other.capacity_ = N;
+            return;
+        }
+        for (size_type i = 0; i < other.size_; ++i) {
+            ::new (static_cast<void*>(data_ + i)) T(std::move(other.data_[i]));
+        }
+        size_ = other.size_;
+        other.clear();
+    }
+};
+
+#endif // INLINE_VECTOR_H
@@ -0,0 +1,68 @@
+#ifndef INSTRUMENT_REGISTRY_H
+#define INSTRUMENT_REGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Compact instrument handle carried by events, orders and fills. Symbols are
+// interned once (config load, replay parse) and resolved back to a name only
+// where text leaves the process: event logs, reports, JSON.
+using InstrumentId = uint32_t;
+constexpr InstrumentId kNoInstrument = 0;
+
+// Process-wide symbol <-> id table. Ids are dense, start at 1 and are never
+// reused; id 0 maps to the empty name. Names live in a deque so references
+// returned by name() stay valid while other threads intern new symbols.
+class InstrumentRegistry {
+public:
+    static InstrumentRegistry& global() {
+        static InstrumentRegistry registry;
+        return registry;
+    }
+
+    InstrumentRegistry() { names_.emplace_back(); }
+    InstrumentRegistry(const InstrumentRegistry&) = delete;
+    InstrumentRegistry& operator=(const InstrumentRegistry&) = delete;
+
+    // Id of `symbol`, assigning the next free id on first sight
+    InstrumentId intern(const std::string& symbol) {
+        if (symbol.empty()) return kNoInstrument;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(symbol);
+        if (it != ids_.end()) return it->second;
+        const auto id = static_cast<InstrumentId>(names_.size());
+        names_.push_back(symbol);
+        ids_.emplace(symbol, id);
+        return id;
+    }
+
+    // Id of an already interned symbol, or kNoInstrument
+    InstrumentId find(const std::string& symbol) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(symbol);
+        return it == ids_.end() ? kNoInstrument : it->second;
+    }
+
+    // Symbol for `id`; empty for kNoInstrument or an unknown id
+    const std::string& name(InstrumentId id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return id < names_.size() ? names_[id] : names_[kNoInstrument];
+    }
+
+    // Number of interned symbols (excluding kNoInstrument)
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_.size() - 1;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::deque<std::string> names_;
+    std::unordered_map<std::string, InstrumentId> ids_;
+};
+
+#endif // INSTRUMENT_REGISTRY_H
@@ -0,0 +1,217 @@
+#ifndef LATENCY_MODEL_H
+#define LATENCY_MODEL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "RandomBatch.h"
+
+enum class LatencyDistribution { Constant, Uniform, LogNormal, Empirical };
+
+// One histogram bucket: latencies in [lo_ns, hi_ns) with relative weight
+struct LatencyBucket {
+    int64_t lo_ns = 0;
+    int64_t hi_ns = 0;
+    double weight = 0.0;
+};
+
+// Latency of one message path, in simulated nanoseconds. The default is a
+// constant zero, which never draws from the RNG.
+struct LatencyModel {
+    LatencyDistribution distribution = LatencyDistribution::Constant;
+    int64_t value_ns = 0;   // Constant: the latency; Uniform: lower bound; LogNormal: median
+    int64_t max_ns = 0;     // Uniform: upper bound (inclusive)
+    double sigma = 0.0;     // LogNormal: standard deviation of ln(latency)
+    std::vector<LatencyBucket> buckets;  // Empirical
+
+    static LatencyModel constant(int64_t ns) {
+        LatencyModel m;
+        m.value_ns = ns;
+        return m;
+    }
+    static LatencyModel uniform(int64_t lo_ns, int64_t hi_ns) {
+        LatencyModel m;
+        m.distribution = LatencyDistribution::Uniform;
+        m.value_ns = lo_ns;
+        m.max_ns = hi_ns;
+        return m;
+    }
+    static LatencyModel lognormal(int64_t median_ns, double sigma) {
+        LatencyModel m;
+        m.distribution = LatencyDistribution::LogNormal;
+        m.value_ns = median_ns;
+        m.sigma = sigma;
+        return m;
+    }
+    static LatencyModel empirical(std::vector<LatencyBucket> buckets) {
+        LatencyModel m;
+        m.distribution = LatencyDistribution::Empirical;
+        m.buckets = std::move(buckets);
+        return m;
+    }
+
+    bool is_zero() const { return distribution == LatencyDistribution::Constant && value_ns == 0; }
+
+    // Throws std::invalid_argument on negative, inverted or empty parameters
+    void validate() const {
+        switch (distribution) {
+            case LatencyDistribution::Constant:
+                if (value_ns < 0) throw std::invalid_argument("constant latency must be >= 0");
+                break;
+            case LatencyDistribution::Uniform:
+                if (value_ns < 0 || max_ns < value_ns) throw std::invalid_argument("uniform latency needs 0 <= lo <= hi");
+                break;
+            case LatencyDistribution::LogNormal:
+                if (value_ns <= 0 || sigma < 0.0) throw std::invalid_argument("lognormal latency needs median > 0 and sigma >= 0");
+                break;
+            case LatencyDistribution::Empirical: {
+                double total = 0.0;
+                for (const auto& b : buckets) {
+                    if (b.lo_ns < 0 || b.hi_ns < b.lo_ns || b.weight < 0.0) {
+                        throw std::invalid_argument("empirical latency bucket needs 0 <= lo <= hi and weight >= 0");
+                    }
+                    total += b.weight;
+                }
+                if (total <= 0.0) throw std::invalid_argument("empirical latency needs a bucket with positive weight");
+                break;
+            }
+        }
+    }
+};
+
+// Draws latencies from a LatencyModel. Empirical buckets are picked by
+// cumulative weight, then a point is drawn uniformly inside the bucket.
+// Draws map raw 32-bit words (random_batch::next_*), so a seeded stream gives
+// the same latencies with any standard library.
+class LatencySampler {
+public:
+    LatencySampler() = default;
+    explicit LatencySampler(const LatencyModel& model) : model_(model) {
+        model_.validate();
+        double running = 0.0;
+        for (const auto& b : model_.buckets) {
+            running += b.weight;
+            cumulative_.push_back(running);
+        }
+    }
+
+    bool is_zero() const { return model_.is_zero(); }
+
+    template <typename Rng>
+    int64_t sample(Rng& rng) const {
+        switch (model_.distribution) {
+            case LatencyDistribution::Constant:
+                return model_.value_ns;
+            case LatencyDistribution::Uniform:
+                return uniform_int(rng, model_.value_ns, model_.max_ns);
+            case LatencyDistribution::LogNormal: {
+                const double z = random_batch::next_normal(rng, 0.0, model_.sigma);
+                return static_cast<int64_t>(std::llround(static_cast<double>(model_.value_ns) * std::exp(z)));
+            }
+            case LatencyDistribution::Empirical: {
+                const double u = random_batch::next_uniform(rng, 0.0, cumulative_.back());
+                std::size_t i = static_cast<std::size_t>(
+                    std::upper_bound(cumulative_.begin(), cumulative_.end(), u) - cumulative_.begin());
+                i = std::min(i, cumulative_.size() - 1);
+                const LatencyBucket& b = model_.buckets[i];
+                return b.hi_ns > b.lo_ns ? uniform_int(rng, b.lo_ns, b.hi_ns - 1) : b.lo_ns;
+            }
+        }
+        return 0;
+    }
+
+private:
+    // [lo, hi] from one word; spans past 2^32 ns (~4.3 s) are spaced accordingly
+    template <typename Rng>
+    static int64_t uniform_int(Rng& rng, int64_t lo, int64_t hi) {
+        const double span = static_cast<double>(hi - lo) + 1.0;
+        return std::min(hi, lo + static_cast<int64_t>(random_batch::next_uniform(rng, 0.0, span)));
+    }
+
+    LatencyModel model_;
+    std::vector<double> cumulative_;
+};
+
+namespace latency_detail {
+
+inline std::vector<std::string> split(const std::string& s, char delim) {
+    std::vector<std::string> out;
+    std::size_t start = 0;
+    for (std::size_t pos = s.find(delim); pos != std::string::npos; pos = s.find(delim, start)) {
+        out.push_back(s.substr(start, pos - start));
+        start = pos + 1;
+    }
+    out.push_back(s.substr(start));
+    return out;
+}
+
+// "250", "250ns", "10us", "2ms" -> nanoseconds
+inline int64_t parse_duration_ns(const std::string& text) {
+    std::size_t used = 0;
+    double value = std::stod(text, &used);
+    const std::string unit = text.substr(used);
+    double scale = 1.0;
+    if (unit.empty() || unit == "ns") {
+        scale = 1.0;
+    } else if (unit == "us") {
+        scale = 1e3;
+    } else if (unit == "ms") {
+        scale = 1e6;
+    } else {
+        throw std::invalid_argument("unknown latency unit: " + text);
+    }
+    return static_cast<int64_t>(std::llround(value * scale));
+}
+
+} // namespace latency_detail
+
+// Parses a CLI latency spec:
+//   const:<d>                     e.g. const:10us
+//   uniform:<lo>:<hi>             e.g. uniform:5us:15us
+//   lognormal:<median>:<sigma>    e.g. lognormal:20us:0.5
+//   empirical:<lo>-<hi>=<w>,...   e.g. empirical:0us-10us=0.9,10us-100us=0.1
+// A bare duration ("10us") is shorthand for const.
+inline LatencyModel parse_latency_model(const std::string& spec) {
+    using latency_detail::parse_duration_ns;
+    using latency_detail::split;
+
+    const std::size_t colon = spec.find(':');
+    const std::string kind = colon == std::string::npos ? "const" : spec.substr(0, colon);
+    const std::string args = colon == std::string::npos ? spec : spec.substr(colon + 1);
+    const auto parts = split(args, ':');
+
+    LatencyModel model;
+    try {
+        if (kind == "const" && parts.size() == 1) {
+            model = LatencyModel::constant(parse_duration_ns(parts[0]));
+        } else if (kind == "uniform" && parts.size() == 2) {
+            model = LatencyModel::uniform(parse_duration_ns(parts[0]), parse_duration_ns(parts[1]));
+        } else if (kind == "lognormal" && parts.size() == 2) {
+            model = LatencyModel::lognormal(parse_duration_ns(parts[0]), std::stod(parts[1]));
+        } else if (kind == "empirical" && parts.size() == 1) {
+            std::vector<LatencyBucket> buckets;
+            for (const auto& entry : split(parts[0], ',')) {
+                const auto range_weight = split(entry, '=');
+                const auto range = split(range_weight.at(0), '-');
+                if (range_weight.size() != 2 || range.size() != 2) {
+                    throw std::invalid_argument("bad bucket");
+                }
+                buckets.push_back(LatencyBucket{parse_duration_ns(range[0]), parse_duration_ns(range[1]),
+                                                std::stod(range_weight[1])});
+            }
+            model = LatencyModel::empirical(std::move(buckets));
+        } else {
+            throw std::invalid_argument("bad spec");
+        }
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Invalid latency spec: " + spec);
+    }
+    model.validate();
+    return model;
+}
+
+#endif // LATENCY_MODEL_H
@@ -0,0 +1,112 @@
+#ifndef LEVEL_BITMAP_H
+#define LEVEL_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Two-level occupancy bitmap over a fixed index range. Each bit in words_
+// marks an occupied slot; each bit in summary_ marks a non-zero word, so a
+// zero summary bit skips one empty 64-slot word and a zero summary word skips
+// 4096 slots. A search finishes with one ctz/clz on the target word.
+class LevelBitmap {
+public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    explicit LevelBitmap(std::size_t bits = 0) { resize(bits); }
+
+    // Clears every bit
+    void resize(std::size_t bits) {
+        size_ = bits;
+        count_ = 0;
+        words_.assign((bits + 63) / 64, 0);
+        summary_.assign((words_.size() + 63) / 64, 0);
+    }
+
+    std::size_t size() const { return size_; }
+    std::size_t count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    bool test(std::size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1ULL; }
+
+    void set(std::size_t i) {
+        const std::size_t w = i >> 6;
+        const uint64_t bit = 1ULL << (i & 63);
+        if (words_[w] & bit) return;
+        if (words_[w] == 0) {
+            summary_[w >> 6] |= 1ULL << (w & 63);
+        }
+        words_[w] |= bit;
+        ++count_;
+    }
+
+    void reset(std::size_t i) {
+        const std::size_t w = i >> 6;
+        const uint64_t bit = 1ULL << (i & 63);
+        if (!(words_[w] & bit)) return;
+        words_[w] &= ~bit;
+        if (words_[w] == 0) {
+            summary_[w >> 6] &= ~(1ULL << (w & 63));
+        }
+        --count_;
+    }
+
+    std::size_t find_first() const { return size_ == 0 ? npos : next_set(0); }
+    std::size_t find_last() const { return size_ == 0 ? npos : prev_set(size_ - 1); }
+
+    // Smallest set index >= i, or npos
+    std::size_t next_set(std::size_t i) const {
+        if (i >= size_) return npos;
+        std::size_t w = i >> 6;
+        uint64_t word = words_[w] & (~0ULL << (i & 63));
+        if (word) return (w << 6) + ctz(word);
+
+        ++w;
+        if (w >= words_.size()) return npos;
+        std::size_t s = w >> 6;
+        uint64_t sum = summary_[s] & (~0ULL << (w & 63));
+        while (!sum) {
+            if (++s >= summary_.size()) return npos;
+            sum = summary_[s];
+        }
+        w = (s << 6) + ctz(sum);
+        return (w << 6) + ctz(words_[w]);
+    }
+
+    // Largest set index <= i, or npos
+    std::size_t prev_set(std::size_t i) const {
+        if (size_ == 0) return npos;
+        if (i >= size_) i = size_ - 1;
+        std::size_t w = i >> 6;
+        uint64_t word = words_[w] & mask_through(i & 63);
+        if (word) return (w << 6) + 63 - clz(word);
+
+        if (w == 0) return npos;
+        --w;
+        std::size_t s = w >> 6;
+        uint64_t sum = summary_[s] & mask_through(w & 63);
+        while (!sum) {
+            if (s == 0) return npos;
+            sum = summary_[--s];
+        }
+        w = (s << 6) + 63 - clz(sum);
+        return (w << 6) + 63 - clz(words_[w]);
+    }
+
+private:
+    std::vector<uint64_t> words_;
+    std::vector<uint64_t> summary_;
+    std::size_t size_ = 0;
+    std::size_t count_ = 0;
+
+    static unsigned ctz(uint64_t x) { return static_cast<unsigned>(__builtin_ctzll(x)); }
+    static unsigned clz(uint64_t x) { return static_cast<unsigned>(__builtin_clzll(x)); }
+
+    // Bits 0..bit inclusive
+    static uint64_t mask_through(std::size_t bit) {
+        return bit == 63 ? ~0ULL : ((1ULL << (bit + 1)) - 1);
+    }
+};
+
+#endif // LEVEL_BITMAP_H
@@ -0,0 +1,168 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Fixed-size block allocator backed by slabs and an intrusive free list.
+// Slabs are only returned to the heap when the pool is destroyed, so once the
+// pool is sized for the working set, allocate/deallocate never touch malloc.
+class FixedBlockPool {
+public:
+    FixedBlockPool(std::size_t block_size, std::size_t block_align, std::size_t blocks_per_slab = 256)
+        : block_align_(block_align < alignof(FreeNode) ? alignof(FreeNode) : block_align),
+          blocks_per_slab_(blocks_per_slab == 0 ? 1 : blocks_per_slab) {
+        std::size_t size = block_size < sizeof(FreeNode) ? sizeof(FreeNode) : block_size;
+        block_size_ = (size + block_align_ - 1) / block_align_ * block_align_;
+    }
+
+    ~FixedBlockPool() {
+        for (void* slab : slabs_) {
+            ::operator delete(slab, std::align_val_t(block_align_));
+        }
+    }
+
+    FixedBlockPool(const FixedBlockPool&) = delete;
+    FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+    void* allocate() {
+        if (!free_list_) {
+            add_slab(blocks_per_slab_);
+        }
+        FreeNode* node = free_list_;
+        free_list_ = node->next;
+        ++in_use_;
+        return node;
+    }
+
+    void deallocate(void* p) noexcept {
+        auto* node = static_cast<FreeNode*>(p);
+        node->next = free_list_;
+        free_list_ = node;
+        --in_use_;
+    }
+
+    // Grow so that at least `blocks` can be outstanding without another slab
+    void reserve(std::size_t blocks) {
+        if (blocks > capacity_) {
+            add_slab(blocks - capacity_);
+        }
+    }
+
+    std::size_t block_size() const { return block_size_; }
+    std::size_t block_align() const { return block_align_; }
+    std::size_t capacity() const { return capacity_; }
+    std::size_t in_use() const { return in_use_; }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    std::size_t block_size_ = 0;
+    std::size_t block_align_;
+    std::size_t blocks_per_slab_;
+    FreeNode* free_list_ = nullptr;
+    std::vector<void*> slabs_;
+    std::size_t capacity_ = 0;
+    std::size_t in_use_ = 0;
+
+    void add_slab(std::size_t blocks) {
+        char* slab = static_cast<char*>(::operator new(blocks * block_size_, std::align_val_t(block_align_)));
+        slabs_.push_back(slab);
+        // Thread blocks onto the free list in address order
+        for (std::size_t i = blocks; i-- > 0;) {
+            auto* node = reinterpret_cast<FreeNode*>(slab + i * block_size_);
+            node->next = free_list_;
+            free_list_ = node;
+        }
+        capacity_ += blocks;
+    }
+};
+
+// Typed front-end for pooled objects with an owner-managed lifetime
+template <typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(std::size_t blocks_per_slab = 256)
+        : pool_(sizeof(T), alignof(T), blocks_per_slab) {}
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        void* p = pool_.allocate();
+        try {
+            return new (p) T(std::forward<Args>(args)...);
+        } catch (...) {
+            pool_.deallocate(p);
+            throw;
+        }
+    }
+
+    void destroy(T* obj) noexcept {
+        obj->~T();
+        pool_.deallocate(obj);
+    }
+
+    void reserve(std::size_t count) { pool_.reserve(count); }
+    std::size_t capacity() const { return pool_.capacity(); }
+    std::size_t in_use() const { return pool_.in_use(); }
+
+private:
+    FixedBlockPool pool_;
+};
+
+// Block size that fits one node of a std::map / std::unordered_map holding
+// Value: the value plus up to four pointer-sized header words (red-black
+// tree links + color, or hash chain link + cached hash).
+template <typename Value>
+constexpr std::size_t node_block_size() {
+    return sizeof(Value) + 4 * sizeof(void*);
+}
+
+// Std-compatible allocator that serves single-node allocations from a shared
+// FixedBlockPool. Multi-element requests (hash bucket arrays) and nodes too
+// large for the pool fall through to std::allocator.
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    explicit PoolAllocator(FixedBlockPool* pool) noexcept : pool_(pool) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool_(other.pool()) {}
+
+    T* allocate(std::size_t n) {
+        if (fits_pool(n)) {
+            return static_cast<T*>(pool_->allocate());
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if (fits_pool(n)) {
+            pool_->deallocate(p);
+            return;
+        }
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    FixedBlockPool* pool() const noexcept { return pool_; }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept { return pool_ == other.pool(); }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept { return pool_ != other.pool(); }
+
+private:
+    FixedBlockPool* pool_;
+
+    bool fits_pool(std::size_t n) const noexcept {
+        return n == 1 && sizeof(T) <= pool_->block_size() && alignof(T) <= pool_->block_align();
+    }
+};
+
+#endif // OBJECT_POOL_H
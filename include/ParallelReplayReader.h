@@ -0,0 +1,271 @@
+#ifndef PARALLEL_REPLAY_READER_H
+#define PARALLEL_REPLAY_READER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../MarketDataEvent.h"
+#include "EventLogParser.h"
+#include "MappedFile.h"
+
+// Parses a mapped text event log on a pool of worker threads and hands the
+// events back in file order.
+//
+// The file is cut into chunks of about chunk_bytes, each ending on a newline.
+// Workers claim chunks in order and parse each into one of 2 x threads
+// preallocated slots; chunk c uses slot c % slots and waits until the
+// consumer has released chunk c - slots. That bounds memory to the slot ring
+// whatever the log size, and since each slot's events are parsed in place,
+// a warmed-up ring does not allocate. A parse error is recorded with its line
+// and rethrown by next() once every event before it has been delivered, so
+// failures surface at the same point as in sequential replay.
+class ParallelReplayReader {
+public:
+    static constexpr std::size_t kDefaultChunkBytes = 1u << 20;
+    static constexpr std::size_t kReleaseBytes = 16u << 20;
+
+    ParallelReplayReader() = default;
+    ~ParallelReplayReader() { close(); }
+
+    ParallelReplayReader(const ParallelReplayReader&) = delete;
+    ParallelReplayReader& operator=(const ParallelReplayReader&) = delete;
+
+    // Maps `path` and starts `threads` workers (at least 1). Reading starts
+    // at byte start_offset, the start of line lines_before + 1. False if the
+    // file cannot be mapped.
+    bool open(const std::string& path, std::size_t threads, std::size_t chunk_bytes = kDefaultChunkBytes,
+              std::size_t start_offset = 0, std::size_t lines_before = 0) {
+        close();
+        if (!file_.open(path)) {
+            return false;
+        }
+        threads = threads == 0 ? 1 : threads;
+        chunk_bytes_ = chunk_bytes == 0 ? 1 : chunk_bytes;
+        slots_ = std::vector<Slot>(2 * threads);
+        stop_ = false;
+        next_chunk_ = 0;
+        start_offset_ = start_offset < file_.size() ? start_offset : file_.size();
+        next_offset_ = start_offset_;
+        total_chunks_ = kUnknown;
+        consumed_ = 0;
+        current_ = nullptr;
+        cursor_ = 0;
+        line_base_ = lines_before;
+        line_number_ = lines_before;
+        released_ = 0;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+        workers_.clear();
+        slots_.clear();
+        file_.close();
+    }
+
+    bool is_open() const { return file_.is_open(); }
+    std::size_t size() const { return file_.size(); }
+
+    // True if the log holds at least one non-blank line
+    bool has_next() const {
+        for (std::size_t p = start_offset_; p < file_.size(); ++p) {
+            if (file_.data()[p] != '\n') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Copies the next event into `event`; false at end of file. Rethrows the
+    // parse error of the next line if it was malformed. Copying rather than
+    // moving leaves the slot its lists' capacity, and `event` keeps its own,
+    // so deep books do not allocate on either side once warmed up.
+    bool next(MarketDataEvent& event) {
+        for (;;) {
+            if (current_ != nullptr && cursor_ < current_->count) {
+                line_number_ = line_base_ + current_->lines[cursor_];
+                event = current_->events[cursor_++];
+                return true;
+            }
+            if (current_ != nullptr && current_->error) {
+                line_number_ = line_base_ + current_->error_line;
+                std::rethrow_exception(current_->error);
+            }
+            if (!advance()) {
+                return false;
+            }
+        }
+    }
+
+    // 1-based line number of the last event returned or the line that failed
+    std::size_t line_number() const { return line_number_; }
+
+private:
+    static constexpr std::size_t kUnknown = static_cast<std::size_t>(-1);
+
+    struct Slot {
+        std::size_t chunk = kUnknown;  // chunk held, once ready
+        bool ready = false;
+        std::size_t begin = 0;          // file offset of the chunk
+        std::vector<MarketDataEvent> events;
+        std::vector<std::size_t> lines;  // 1-based line within the chunk per event
+        std::size_t count = 0;
+        std::size_t line_count = 0;      // lines in the chunk, blank ones included
+        std::exception_ptr error;
+        std::size_t error_line = 0;
+    };
+
+    void worker_loop() {
+        EventLogParser parser;
+        for (;;) {
+            std::size_t chunk, begin, end;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                // Chunk next_chunk_ may only reuse its slot once the consumer is
+                // done with the chunk that held it before
+                work_cv_.wait(lock, [this] {
+                    return stop_ || next_offset_ >= file_.size() || next_chunk_ < consumed_ + slots_.size();
+                });
+                if (stop_ || next_offset_ >= file_.size()) {
+                    return;
+                }
+                chunk = next_chunk_++;
+                begin = next_offset_;
+                end = chunk_end(begin);
+                next_offset_ = end;
+                if (end >= file_.size()) {
+                    total_chunks_ = chunk + 1;
+                    ready_cv_.notify_all();
+                }
+            }
+
+            Slot& slot = slots_[chunk % slots_.size()];
+            parse_chunk(parser, slot, begin, end);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                slot.chunk = chunk;
+                slot.ready = true;
+            }
+            ready_cv_.notify_all();
+        }
+    }
+
+    // End of the chunk starting at `begin`: just past the first newline at or
+    // after begin + chunk_bytes_, or end of file
+    std::size_t chunk_end(std::size_t begin) const {
+        const std::size_t size = file_.size();
+        if (size - begin <= chunk_bytes_) {
+            return size;
+        }
+        const char* data = file_.data();
+        const std::size_t from = begin + chunk_bytes_ - 1;
+        const void* nl = std::memchr(data + from, '\n', size - from);
+        return nl != nullptr ? static_cast<std::size_t>(static_cast<const char*>(nl) - data) + 1 : size;
+    }
+
+    // Parses the lines in [begin, end_offset) into the slot, stopping at the
+    // first malformed one
+    void parse_chunk(EventLogParser& parser, Slot& slot, std::size_t begin, std::size_t end_offset) const {
+        const char* data = file_.data();
+        slot.begin = begin;
+        slot.count = 0;
+        slot.line_count = 0;
+        slot.error = nullptr;
+        std::size_t pos = begin;
+        while (pos < end_offset) {
+            const void* nl = std::memchr(data + pos, '\n', end_offset - pos);
+            const std::size_t end = nl != nullptr ? static_cast<std::size_t>(static_cast<const char*>(nl) - data)
+                                                  : end_offset;
+            const std::size_t start = pos;
+            pos = nl != nullptr ? end + 1 : end_offset;
+            ++slot.line_count;
+            if (end == start) {
+                continue;
+            }
+            if (slot.count == slot.events.size()) {
+                slot.events.emplace_back();
+                slot.lines.emplace_back();
+            }
+            try {
+                parser.parse(std::string_view(data + start, end - start), slot.events[slot.count]);
+            } catch (...) {
+                slot.error = std::current_exception();
+                slot.error_line = slot.line_count;
+                return;  // lines after a bad one are never delivered
+            }
+            slot.lines[slot.count++] = slot.line_count;
+        }
+    }
+
+    // Releases the current chunk and waits for the next one in file order;
+    // false once every chunk has been consumed
+    bool advance() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (current_ != nullptr) {
+            line_base_ += current_->line_count;
+            current_->ready = false;
+            current_ = nullptr;
+            ++consumed_;
+            work_cv_.notify_all();
+        }
+        Slot& slot = slots_[consumed_ % slots_.size()];
+        ready_cv_.wait(lock, [&] {
+            return (slot.ready && slot.chunk == consumed_) || consumed_ == total_chunks_ ||
+                   start_offset_ == file_.size();
+        });
+        if (consumed_ == total_chunks_ || start_offset_ == file_.size()) {
+            return false;
+        }
+        current_ = &slot;
+        cursor_ = 0;
+
+        // Every chunk before this one has been handed out
+        if (slot.begin - released_ >= kReleaseBytes) {
+            file_.release(slot.begin);
+            released_ = slot.begin;
+        }
+        return true;
+    }
+
+    MappedFile file_;
+    std::size_t chunk_bytes_ = kDefaultChunkBytes;
+    std::size_t start_offset_ = 0;
+    std::vector<Slot> slots_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;   // workers: a slot was released, or stop
+    std::condition_variable ready_cv_;  // consumer: a chunk was parsed, or the last one was claimed
+    bool stop_ = false;
+    std::size_t next_chunk_ = 0;
+    std::size_t next_offset_ = 0;
+    std::size_t total_chunks_ = kUnknown;
+    std::size_t consumed_ = 0;
+
+    // Consumer side only
+    Slot* current_ = nullptr;
+    std::size_t cursor_ = 0;
+    std::size_t line_base_ = 0;
+    std::size_t line_number_ = 0;
+    std::size_t released_ = 0;
+};
+
+#endif // PARALLEL_REPLAY_READER_H
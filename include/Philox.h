@@ -0,0 +1,81 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3", SC'11). Output is a pure function of a
+// 128-bit counter and a 64-bit key, so any (key, counter) block can be
+// produced on any thread without touching shared state.
+struct Philox4x32 {
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static constexpr uint32_t kMul0 = 0xD2511F53u;
+    static constexpr uint32_t kMul1 = 0xCD9E8D57u;
+    static constexpr uint32_t kWeyl0 = 0x9E3779B9u;
+    static constexpr uint32_t kWeyl1 = 0xBB67AE85u;
+    static constexpr int kRounds = 10;
+
+    static Counter block(Counter ctr, Key key) {
+        for (int r = 0; r < kRounds; ++r) {
+            const uint64_t p0 = static_cast<uint64_t>(kMul0) * ctr[0];
+            const uint64_t p1 = static_cast<uint64_t>(kMul1) * ctr[2];
+            ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(p1),
+                   static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(p0)};
+            key[0] += kWeyl0;
+            key[1] += kWeyl1;
+        }
+        return ctr;
+    }
+};
+
+// UniformRandomBitGenerator over one substream of a Philox key. The counter
+// is (index lo, index hi, stream, block): `stream` separates independent
+// consumers (mid noise, book updates, trades, ...) and `index` is typically
+// the event number, so draws for event n of one stream never depend on how
+// many values were drawn for other events or streams. The whole state is
+// 48 bytes, against 2.5 KB for std::mt19937.
+class PhiloxStream {
+public:
+    using result_type = uint32_t;
+
+    PhiloxStream() = default;
+    explicit PhiloxStream(uint64_t key, uint32_t stream = 0, uint64_t index = 0) : key_{
+        static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)} {
+        reset(stream, index);
+    }
+
+    // Key from a run seed and a per-instrument discriminator
+    static uint64_t make_key(uint32_t seed, uint32_t instrument) {
+        return static_cast<uint64_t>(seed) | (static_cast<uint64_t>(instrument) << 32);
+    }
+
+    // Moves to the start of substream (stream, index)
+    void reset(uint32_t stream, uint64_t index) {
+        ctr_ = {static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), stream, 0};
+        pos_ = 4;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        if (pos_ == 4) {
+            out_ = Philox4x32::block(ctr_, key_);
+            ++ctr_[3];
+            pos_ = 0;
+        }
+        return out_[pos_++];
+    }
+
+private:
+    Philox4x32::Key key_{};
+    Philox4x32::Counter ctr_{};
+    Philox4x32::Counter out_{};
+    unsigned pos_ = 4;
+};
+
+#endif // PHILOX_H
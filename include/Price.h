@@ -0,0 +1,27 @@
+#ifndef PRICE_H
+#define PRICE_H
+
+#include <cmath>
+#include <cstdint>
+
+// Fixed-point price: an integer count of the instrument's minimum tick.
+// Matching and market data carry Price so comparisons are exact and levels
+// can be indexed directly; doubles appear only at the edges (strategy math,
+// accounting, text log, JSON, reports).
+using Price = int64_t;
+
+// Instrument tick-size definition. All simulated instruments currently share
+// one tick of 0.0001.
+constexpr int64_t kTicksPerUnit = 10000;
+constexpr double kTickSize = 1.0 / static_cast<double>(kTicksPerUnit);
+constexpr int kPriceDecimals = 4;  // digits needed to print a tick exactly
+
+inline Price to_ticks(double price) {
+    return static_cast<Price>(std::llround(price * static_cast<double>(kTicksPerUnit)));
+}
+
+inline double from_ticks(Price ticks) {
+    return static_cast<double>(ticks) / static_cast<double>(kTicksPerUnit);
+}
+
+#endif // PRICE_H
@@ -0,0 +1,85 @@
+#ifndef REPLAY_SOURCE_H
+#define REPLAY_SOURCE_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include "MappedFile.h"
+
+// Streams the lines of a text event log straight out of a memory map.
+// Nothing is read ahead: each next_line() call scans to the next newline and
+// returns a view into the mapping, so startup is constant time and, with
+// consumed pages released every kReleaseBytes, resident memory stays bounded
+// for logs of any size. Blank lines are skipped, as the loader used to.
+class ReplaySource {
+public:
+    static constexpr std::size_t kReleaseBytes = 16u << 20;
+
+    bool open(const std::string& path) {
+        pos_ = 0;
+        released_ = 0;
+        line_number_ = 0;
+        return file_.open(path);
+    }
+
+    bool is_open() const { return file_.is_open(); }
+
+    // Continues from byte `offset`, the start of line lines_before + 1 (a
+    // sequence index seek point)
+    void seek(std::size_t offset, std::size_t lines_before) {
+        pos_ = offset < file_.size() ? offset : file_.size();
+        line_number_ = lines_before;
+    }
+
+    // True if any non-blank line remains
+    bool has_next() const {
+        for (std::size_t p = pos_; p < file_.size(); ++p) {
+            if (file_.data()[p] != '\n') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Points `line`/`len` at the next non-blank line (without its newline);
+    // false at end of file. The view is valid until the next call.
+    bool next_line(const char*& line, std::size_t& len) {
+        const char* data = file_.data();
+        const std::size_t size = file_.size();
+        while (pos_ < size) {
+            const void* nl = std::memchr(data + pos_, '\n', size - pos_);
+            const std::size_t end = nl != nullptr ? static_cast<std::size_t>(static_cast<const char*>(nl) - data) : size;
+            const std::size_t start = pos_;
+            pos_ = nl != nullptr ? end + 1 : size;
+            ++line_number_;
+            if (end > start) {
+                maybe_release(start);
+                line = data + start;
+                len = end - start;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 1-based line number of the last line returned
+    std::size_t line_number() const { return line_number_; }
+    std::size_t bytes_consumed() const { return pos_; }
+    std::size_t size() const { return file_.size(); }
+
+private:
+    // Pages wholly before the current line are never read again
+    void maybe_release(std::size_t line_start) {
+        if (line_start - released_ >= kReleaseBytes) {
+            file_.release(line_start);
+            released_ = line_start;
+        }
+    }
+
+    MappedFile file_;
+    std::size_t pos_ = 0;
+    std::size_t released_ = 0;
+    std::size_t line_number_ = 0;
+};
+
+#endif // REPLAY_SOURCE_H
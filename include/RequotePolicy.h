@@ -0,0 +1,46 @@
+#ifndef REQUOTE_POLICY_H
+#define REQUOTE_POLICY_H
+
+#include "../Order.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+struct RequoteConfig {
+    // A live quote within these tolerances of the new decision is left alone
+    int64_t price_tolerance_ticks = 0;
+    int size_tolerance = 0;
+    // A quote placed or amended less than this long ago is left alone (0 disables)
+    double min_quote_lifetime_ms = 0.0;
+    // When false, changes go out as cancel + new (venues without amend support)
+    bool allow_amend = true;
+};
+
+enum class RequoteAction { None, New, Amend, CancelNew };
+
+// Decide what to send for one side given the live order (nullptr if none)
+// and the newly desired price/size.
+inline RequoteAction decide_requote(const Order* live, Price price, int qty,
+                                    std::chrono::system_clock::time_point now,
+                                    const RequoteConfig& cfg) {
+    if (!live) {
+        return RequoteAction::New;
+    }
+
+    bool price_ok = std::llabs(price - live->price) <= cfg.price_tolerance_ticks;
+    bool size_ok = std::abs(qty - live->leaves_qty) <= cfg.size_tolerance;
+    if (price_ok && size_ok) {
+        return RequoteAction::None;
+    }
+
+    if (cfg.min_quote_lifetime_ms > 0.0) {
+        auto age = std::chrono::duration<double, std::milli>(now - live->updated_at);
+        if (age.count() < cfg.min_quote_lifetime_ms) {
+            return RequoteAction::None;
+        }
+    }
+
+    return cfg.allow_amend ? RequoteAction::Amend : RequoteAction::CancelNew;
+}
+
+#endif // REQUOTE_POLICY_H
@@ -4,8 +4,8 @@
 #include "Accounting.h"
 #include "../MarketDataEvent.h"
 #include <vector>
-#include <deque>
 #include <chrono>
+#include <cstddef>
 
 enum class RiskState { Normal, Warning, Breached, KillSwitch };
 
@@ -42,6 +42,62 @@ struct RiskConfig {
     int max_quote_size = 100;
 };
 
+// Sliding window of (timestamp, count) entries on a growable ring buffer.
+// Unlike a std::deque, steady-state record/expire cycles reuse the same
+// storage. A batch is one entry, and pushes at the newest timestamp merge.
+class RateWindow {
+public:
+    using time_point = std::chrono::system_clock::time_point;
+
+    void push(time_point ts, std::size_t count = 1) {
+        if (count == 0) return;
+        total_ += count;
+        if (size_ > 0) {
+            Entry& newest = buf_[(head_ + size_ - 1) % buf_.size()];
+            if (newest.ts == ts) {
+                newest.count += count;
+                return;
+            }
+        }
+        if (size_ == buf_.size()) {
+            grow();
+        }
+        buf_[(head_ + size_) % buf_.size()] = Entry{ts, count};
+        ++size_;
+    }
+
+    void expire_before(time_point cutoff) {
+        while (size_ > 0 && buf_[head_].ts < cutoff) {
+            total_ -= buf_[head_].count;
+            head_ = (head_ + 1) % buf_.size();
+            --size_;
+        }
+    }
+
+    // Events in the window (sum of counts)
+    std::size_t total() const { return total_; }
+
+private:
+    struct Entry {
+        time_point ts;
+        std::size_t count;
+    };
+
+    std::vector<Entry> buf_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    std::size_t total_ = 0;
+
+    void grow() {
+        std::vector<Entry> next(buf_.empty() ? 64 : buf_.size() * 2);
+        for (std::size_t i = 0; i < size_; ++i) {
+            next[i] = buf_[(head_ + i) % buf_.size()];
+        }
+        buf_.swap(next);
+        head_ = 0;
+    }
+};
+
 class RiskManager {
 public:
     explicit RiskManager(const RiskConfig& cfg = RiskConfig{});
@@ -51,8 +107,10 @@ public:
     void engage_kill_switch();
     void reset_kill_switch();
 
-    void record_quote(std::chrono::system_clock::time_point ts);
-    void record_cancel(std::chrono::system_clock::time_point ts);
+    void record_quote(std::chrono::system_clock::time_point ts, std::size_t count = 1);
+    void record_cancel(std::chrono::system_clock::time_point ts, std::size_t count = 1);
+    // An amend is a single order-entry message and counts once against the quote rate
+    void record_replace(std::chrono::system_clock::time_point ts);
 
     bool is_quoting_allowed() const;
     RiskState current_state() const;
@@ -70,8 +128,8 @@ private:
     double drawdown_ = 0.0;
     bool hwm_initialized_ = false;
 
-    std::deque<std::chrono::system_clock::time_point> quote_timestamps_;
-    std::deque<std::chrono::system_clock::time_point> cancel_timestamps_;
+    RateWindow quote_timestamps_;
+    RateWindow cancel_timestamps_;
 
     std::chrono::system_clock::time_point breach_timestamp_;
     bool breach_timestamp_set_ = false;
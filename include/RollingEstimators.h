@@ -52,7 +52,9 @@ class RollingOFI {
 public:
     explicit RollingOFI(size_t window = 50) : window_(window) {}
 
-    void on_trades(const std::vector<Trade>& trades) {
+    // Any range of Trade: an event's TradeList or a plain vector
+    template <typename TradeRange>
+    void on_trades(const TradeRange& trades) {
         for (const auto& t : trades) {
             double signed_vol = (t.aggressor_side == Side::BUY) ?
                 static_cast<double>(t.size) : -static_cast<double>(t.size);
@@ -0,0 +1,200 @@
+#ifndef SEQUENCE_INDEX_H
+#define SEQUENCE_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Sparse sidecar index of a text event log or binary capture, written next
+// to it as <log>.idx. Every `interval` events the writer records a seek
+// point: the byte offset of an event replay can start at, with that event's
+// sequence number, timestamp and the number of events before it. In a
+// capture a seek point is a snapshot of every symbol (BinaryLogger forces
+// one), and the index also records the offset of each symbol record so a
+// reader that starts mid-file still knows the names. Sequence numbers and
+// timestamps never decrease along a log, so finding where to start is a
+// binary search over the points; replay then skips at most `interval`
+// events to reach the exact start.
+//
+// The file is an IndexHeader followed by IndexEntry records, appended as the
+// log is written. A partial trailing entry (a writer that died) is ignored.
+namespace sequence_index {
+
+constexpr char kMagic[8] = {'M', 'M', 'S', 'E', 'Q', 'I', 'D', 'X'};
+constexpr uint16_t kVersion = 1;
+constexpr uint32_t kDefaultInterval = 4096;
+
+enum EntryKind : uint32_t {
+    kSeekPoint = 1,
+    kSymbol = 2  // offset of a capture symbol record; the other fields are unused
+};
+
+struct IndexHeader {
+    char magic[8];
+    uint16_t version;
+    uint16_t entry_size;
+    uint32_t interval;
+};
+
+struct IndexEntry {
+    uint64_t offset;
+    int64_t sequence_number;
+    int64_t timestamp_ns;
+    uint64_t event_number;  // events before this one
+    uint32_t kind;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(IndexHeader) == 16, "index layout");
+static_assert(sizeof(IndexEntry) == 40, "index layout");
+
+inline std::string path_for(const std::string& log_path) {
+    return log_path + ".idx";
+}
+
+} // namespace sequence_index
+
+// Appends seek points while a log is written. The log writer calls
+// count_event() per event and, when due() says so, add_point() with the
+// offset the event starts at. Entries are buffered and written every
+// kFlushEntries, on flush() and on destruction.
+class SequenceIndexWriter {
+public:
+    static constexpr std::size_t kFlushEntries = 1024;
+
+    SequenceIndexWriter() = default;
+    ~SequenceIndexWriter() { flush(); }
+
+    SequenceIndexWriter(const SequenceIndexWriter&) = delete;
+    SequenceIndexWriter& operator=(const SequenceIndexWriter&) = delete;
+
+    // False if `path` cannot be created
+    bool open(const std::string& path, uint32_t interval = sequence_index::kDefaultInterval) {
+        out_.open(path, std::ios::binary | std::ios::trunc);
+        if (!out_) {
+            return false;
+        }
+        interval_ = interval == 0 ? 1 : interval;
+        events_ = 0;
+        next_point_ = 0;
+        sequence_index::IndexHeader header{};
+        std::memcpy(header.magic, sequence_index::kMagic, sizeof(header.magic));
+        header.version = sequence_index::kVersion;
+        header.entry_size = sizeof(sequence_index::IndexEntry);
+        header.interval = interval_;
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return true;
+    }
+
+    bool is_open() const { return out_.is_open(); }
+
+    // True if the next event should start a seek point
+    bool due() const { return events_ >= next_point_; }
+
+    void add_point(uint64_t offset, int64_t sequence_number, int64_t timestamp_ns) {
+        entries_.push_back(
+            sequence_index::IndexEntry{offset, sequence_number, timestamp_ns, events_, sequence_index::kSeekPoint, 0});
+        next_point_ = events_ + interval_;
+        if (entries_.size() >= kFlushEntries) {
+            flush();
+        }
+    }
+
+    void add_symbol(uint64_t offset) {
+        entries_.push_back(sequence_index::IndexEntry{offset, 0, 0, 0, sequence_index::kSymbol, 0});
+    }
+
+    void count_event() {
+        ++events_;
+    }
+
+    void flush() {
+        if (!entries_.empty()) {
+            out_.write(reinterpret_cast<const char*>(entries_.data()),
+                       static_cast<std::streamsize>(entries_.size() * sizeof(sequence_index::IndexEntry)));
+            entries_.clear();
+        }
+        out_.flush();
+    }
+
+private:
+    std::ofstream out_;
+    uint32_t interval_ = sequence_index::kDefaultInterval;
+    uint64_t events_ = 0;
+    uint64_t next_point_ = 0;
+    std::vector<sequence_index::IndexEntry> entries_;
+};
+
+// Loaded index with binary searches for a replay start
+class SequenceIndex {
+public:
+    // False if there is no index at `path`; throws if it is not one
+    bool load(const std::string& path) {
+        namespace si = sequence_index;
+        points_.clear();
+        symbols_.clear();
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return false;
+        }
+        const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        si::IndexHeader header{};
+        if (bytes.size() < sizeof(header)) {
+            throw std::runtime_error("Not a sequence index (too short): " + path);
+        }
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, si::kMagic, sizeof(si::kMagic)) != 0) {
+            throw std::runtime_error("Not a sequence index (bad magic): " + path);
+        }
+        if (header.version != si::kVersion || header.entry_size != sizeof(si::IndexEntry)) {
+            throw std::runtime_error("Unsupported sequence index version " + std::to_string(header.version) + ": " +
+                                     path);
+        }
+        interval_ = header.interval;
+        for (std::size_t pos = sizeof(header); bytes.size() - pos >= sizeof(si::IndexEntry);
+             pos += sizeof(si::IndexEntry)) {
+            si::IndexEntry entry;
+            std::memcpy(&entry, bytes.data() + pos, sizeof(entry));
+            if (entry.kind == si::kSeekPoint) {
+                points_.push_back(entry);
+            } else if (entry.kind == si::kSymbol) {
+                symbols_.push_back(entry.offset);
+            }
+        }
+        return true;
+    }
+
+    // Last seek point at or before sequence number `seq`; nullptr if the
+    // log has to be read from the start
+    const sequence_index::IndexEntry* point_for_sequence(int64_t seq) const {
+        auto it = std::upper_bound(points_.begin(), points_.end(), seq,
+                                   [](int64_t s, const sequence_index::IndexEntry& e) { return s < e.sequence_number; });
+        return it == points_.begin() ? nullptr : &*(it - 1);
+    }
+
+    // Last seek point strictly before time `ts_ns`, so that no event at
+    // ts_ns itself is skipped; nullptr if the log has to be read from the
+    // start
+    const sequence_index::IndexEntry* point_for_time(int64_t ts_ns) const {
+        auto it = std::lower_bound(points_.begin(), points_.end(), ts_ns,
+                                   [](const sequence_index::IndexEntry& e, int64_t t) { return e.timestamp_ns < t; });
+        return it == points_.begin() ? nullptr : &*(it - 1);
+    }
+
+    const std::vector<sequence_index::IndexEntry>& points() const { return points_; }
+    const std::vector<uint64_t>& symbol_offsets() const { return symbols_; }
+    uint32_t interval() const { return interval_; }
+
+private:
+    std::vector<sequence_index::IndexEntry> points_;
+    std::vector<uint64_t> symbols_;  // capture symbol record offsets, in file order
+    uint32_t interval_ = 0;
+};
+
+#endif // SEQUENCE_INDEX_H
@@ -1,26 +1,55 @@
 #ifndef SIMULATION_CONFIG_H
 #define SIMULATION_CONFIG_H
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include "LatencyModel.h"
+
+// Upper bound on SimulationConfig::book_depth
+constexpr std::size_t kMaxBookDepth = 10000;
 
 enum class SimulationMode {
     Simulate,
     Replay
 };
 
+enum class ReplayFormat {
+    Text,   // --event-log output
+    Binary  // --binary-log capture
+};
+
 struct SimulationConfig {
     std::string instrument = "XYZ";
     double initial_price = 100.0;
     double spread = 0.1;
     double volatility = 0.5;
-    int latency_ms = 10;
+    int latency_ms = 10;  // simulated exchange -> MM market data latency (virtual time, no sleeping)
     int iterations = 1000;
     uint32_t seed = 42;
     std::string event_log_path;
     std::string replay_log_path;
     SimulationMode mode = SimulationMode::Simulate;
     bool quiet = false;
+    std::size_t max_resting_orders = 1024;  // pre-sizes MatchingEngine node pools
+    std::size_t ladder_half_width_ticks = 0;  // > 0: dense tick ladder around initial_price
+    uint64_t tick_interval_ns = 1000000;  // simulated exchange time between generated ticks
+    std::size_t book_depth = 5;  // synthetic book levels per side, 1..kMaxBookDepth
+    std::size_t replay_threads = 1;  // > 1: parse the replay log in chunks on this many threads
+    ReplayFormat replay_format = ReplayFormat::Text;  // Binary ignores replay_threads
+    // Replay from the first event at or after this sequence number or time
+    // (ns since the epoch), found through the log's sequence index when it
+    // has one; 0 = from the start. At most one may be set.
+    int64_t replay_start_sequence = 0;
+    int64_t replay_start_time_ns = 0;
+
+    // Per-path simulated latencies, sampled per message. feed_latency is added
+    // on top of latency_ms; cancels use cancel_latency, adds and replaces use
+    // order_latency; fill reports use ack_latency.
+    LatencyModel feed_latency;
+    LatencyModel order_latency;
+    LatencyModel cancel_latency;
+    LatencyModel ack_latency;
 };
 
 #endif // SIMULATION_CONFIG_H
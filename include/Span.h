@@ -0,0 +1,50 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Minimal non-owning view over contiguous elements (C++17 stand-in for
+// std::span). Used for batch APIs so callers can pass vectors, arrays or a
+// pointer + count without copying.
+template <typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+
+    constexpr Span() noexcept = default;
+    constexpr Span(T* data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+    template <std::size_t N>
+    constexpr Span(T (&arr)[N]) noexcept : data_(arr), size_(N) {}
+
+    template <std::size_t N>
+    constexpr Span(std::array<value_type, N>& arr) noexcept : data_(arr.data()), size_(N) {}
+
+    template <std::size_t N, typename U = T, typename = std::enable_if_t<std::is_const<U>::value>>
+    constexpr Span(const std::array<value_type, N>& arr) noexcept : data_(arr.data()), size_(N) {}
+
+    Span(std::vector<value_type>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+
+    template <typename U = T, typename = std::enable_if_t<std::is_const<U>::value>>
+    Span(const std::vector<value_type>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr T& operator[](std::size_t i) const noexcept { return data_[i]; }
+    constexpr iterator begin() const noexcept { return data_; }
+    constexpr iterator end() const noexcept { return data_ + size_; }
+
+    constexpr Span first(std::size_t count) const noexcept { return Span(data_, count); }
+
+private:
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+#endif // SPAN_H
@@ -9,9 +9,9 @@ struct StrategySnapshot {
     double best_bid = 0.0;
     double best_ask = 0.0;
     double mid_price = 0.0;
-    std::vector<OrderLevel> bid_levels;
-    std::vector<OrderLevel> ask_levels;
-    std::vector<Trade> trades;
+    LevelList bid_levels;
+    LevelList ask_levels;
+    TradeList trades;
     int position = 0;
     int max_position = 1000;
     std::chrono::system_clock::time_point timestamp;
@@ -1,10 +1,13 @@
+#include <algorithm>
 #include <csignal>
+#include <cstdarg>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <ctime>
 #include <exception>
 #include <iomanip>
 #include <iostream>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include "MarketSimulator.h"
@@ -13,6 +16,7 @@
 #include "include/HeuristicStrategy.h"
 #include "strategies/AvellanedaStoikovStrategy.h"
 #include "include/BinaryLogger.h"
+#include "include/ColumnStore.h"
 
 using namespace std;
 
@@ -44,6 +48,38 @@ SimulationMode parse_mode(const std::string& value) {
     throw std::invalid_argument("Invalid --mode value: " + value + " (expected simulate|replay)");
 }
 
+// --start-time: epoch milliseconds, or a UTC time as
+// YYYY-MM-DDTHH:MM:SS[.fraction][Z]; returns ns since the epoch
+int64_t parse_start_time(const std::string& value) {
+    if (!value.empty() && value.find_first_not_of("0123456789") == std::string::npos) {
+        return std::stoll(value) * 1000000;
+    }
+    std::tm tm{};
+    int consumed = 0;
+    if (std::sscanf(value.c_str(), "%4d-%2d-%2dT%2d:%2d:%2d%n", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &tm.tm_hour,
+                    &tm.tm_min, &tm.tm_sec, &consumed) != 6) {
+        throw std::invalid_argument("Invalid --start-time value: " + value +
+                                    " (expected epoch ms or YYYY-MM-DDTHH:MM:SS[.fff])");
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    int64_t ns = static_cast<int64_t>(timegm(&tm)) * 1000000000;
+    std::size_t pos = static_cast<std::size_t>(consumed);
+    if (pos < value.size() && value[pos] == '.') {
+        int64_t scale = 100000000;
+        for (++pos; pos < value.size() && value[pos] >= '0' && value[pos] <= '9'; ++pos, scale /= 10) {
+            ns += (value[pos] - '0') * scale;
+        }
+    }
+    if (pos < value.size() && value[pos] == 'Z') {
+        ++pos;
+    }
+    if (pos != value.size()) {
+        throw std::invalid_argument("Invalid --start-time value: " + value);
+    }
+    return ns;
+}
+
 void print_usage() {
     std::cout << "Usage: ./market_maker_simulator [options]\n"
               << "Options:\n"
@@ -51,10 +87,30 @@ void print_usage() {
               << "  --strategy <name>   heuristic|avellaneda-stoikov (default: heuristic)\n"
               << "  --seed <n>          RNG seed (default: 42)\n"
               << "  --iterations <n>    Number of events to process (default: 1000)\n"
-              << "  --latency-ms <n>    Per-event latency in ms (default: 10)\n"
+              << "  --latency-ms <n>    Simulated market data latency in ms (default: 10)\n"
+              << "  --feed-latency <spec>   Extra market data latency on top of --latency-ms (default: 0)\n"
+              << "  --order-latency <spec>  Order entry / amend latency (default: 0)\n"
+              << "  --cancel-latency <spec> Cancel latency (default: 0)\n"
+              << "  --ack-latency <spec>    Fill report latency (default: 0)\n"
+              << "                      spec: <d> | const:<d> | uniform:<lo>:<hi> | lognormal:<median>:<sigma>\n"
+              << "                            | empirical:<lo>-<hi>=<w>,...  with <d> like 250ns, 10us, 2ms\n"
+              << "  --tick-interval <d> Simulated exchange time between ticks (default: 1ms)\n"
               << "  --event-log <path>  Write generated events to log file\n"
               << "  --replay <path>     Compatibility alias for --mode replay + replay path\n"
-              << "  --binary-log <path> Write events in compact binary format\n"
+              << "  --replay-threads <n> Parse the replay log on n threads (default: 1)\n"
+              << "  --replay-binary <path> Replay a --binary-log capture (implies --mode replay)\n"
+              << "  --start-seq <n>     Replay from sequence number n, seeking through the log's .idx\n"
+              << "  --start-time <t>    Replay from time t: epoch ms or UTC YYYY-MM-DDTHH:MM:SS[.fff]\n"
+              << "  --binary-log <path> Write a full-depth binary capture of every event\n"
+              << "  --column-store <dir> Export top of book and trades as mmappable column files\n"
+              << "  --capture-snapshot-interval <n> Full snapshot every n events per symbol in the\n"
+              << "                      binary capture, deltas in between; 1 = snapshots only (default: 1000)\n"
+              << "  --requote-ticks <n> Leave quotes within n ticks of the target alone (default: 0)\n"
+              << "  --requote-size <n>  Leave quotes within n shares of the target alone (default: 0)\n"
+              << "  --min-quote-life-ms <n> Minimum time a quote rests before it is changed (default: 0)\n"
+              << "  --no-amend          Requote with cancel + new instead of amend\n"
+              << "  --ladder-ticks <n>  Use a dense tick-ladder book spanning +/- n ticks (default: 0 = map book)\n"
+              << "  --book-depth <n>    Synthetic book levels per side, 1..10000 (default: 5)\n"
               << "  --quiet             Suppress per-event output\n"
               << "  --help              Show this help text\n";
 }
@@ -69,6 +125,9 @@ bool read_arg_value(int argc, char* argv[], int& i, std::string& out) {
 
 std::string strategy_name = "heuristic";
 std::string binary_log_path;
+std::string column_store_path;
+uint32_t capture_snapshot_interval = BinaryLogger::kDefaultSnapshotInterval;
+RequoteConfig requote_cfg;
 
 SimulationConfig parse_args(int argc, char* argv[]) {
     SimulationConfig config;
@@ -104,6 +163,30 @@ SimulationConfig parse_args(int argc, char* argv[]) {
                 throw std::invalid_argument("--latency-ms requires a value");
             }
             config.latency_ms = std::stoi(value);
+        } else if (arg == "--feed-latency" || arg == "--order-latency" || arg == "--cancel-latency" ||
+                   arg == "--ack-latency") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument(arg + " requires a value");
+            }
+            LatencyModel model = parse_latency_model(value);
+            if (arg == "--feed-latency") {
+                config.feed_latency = model;
+            } else if (arg == "--order-latency") {
+                config.order_latency = model;
+            } else if (arg == "--cancel-latency") {
+                config.cancel_latency = model;
+            } else {
+                config.ack_latency = model;
+            }
+        } else if (arg == "--tick-interval") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--tick-interval requires a value");
+            }
+            int64_t ns = latency_detail::parse_duration_ns(value);
+            if (ns <= 0) {
+                throw std::invalid_argument("--tick-interval must be > 0");
+            }
+            config.tick_interval_ns = static_cast<uint64_t>(ns);
         } else if (arg == "--event-log") {
             if (!read_arg_value(argc, argv, i, value)) {
                 throw std::invalid_argument("--event-log requires a value");
@@ -115,11 +198,70 @@ SimulationConfig parse_args(int argc, char* argv[]) {
             }
             config.replay_log_path = value;
             config.mode = SimulationMode::Replay;
+        } else if (arg == "--replay-binary") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--replay-binary requires a value");
+            }
+            config.replay_log_path = value;
+            config.replay_format = ReplayFormat::Binary;
+            config.mode = SimulationMode::Replay;
+        } else if (arg == "--start-seq") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--start-seq requires a value");
+            }
+            config.replay_start_sequence = std::stoll(value);
+        } else if (arg == "--start-time") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--start-time requires a value");
+            }
+            config.replay_start_time_ns = parse_start_time(value);
         } else if (arg == "--binary-log") {
             if (!read_arg_value(argc, argv, i, value)) {
                 throw std::invalid_argument("--binary-log requires a value");
             }
             binary_log_path = value;
+        } else if (arg == "--column-store") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--column-store requires a value");
+            }
+            column_store_path = value;
+        } else if (arg == "--capture-snapshot-interval") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--capture-snapshot-interval requires a value");
+            }
+            capture_snapshot_interval = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--requote-ticks") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--requote-ticks requires a value");
+            }
+            requote_cfg.price_tolerance_ticks = std::stoll(value);
+        } else if (arg == "--requote-size") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--requote-size requires a value");
+            }
+            requote_cfg.size_tolerance = std::stoi(value);
+        } else if (arg == "--min-quote-life-ms") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--min-quote-life-ms requires a value");
+            }
+            requote_cfg.min_quote_lifetime_ms = std::stod(value);
+        } else if (arg == "--ladder-ticks") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--ladder-ticks requires a value");
+            }
+            config.ladder_half_width_ticks = static_cast<std::size_t>(std::stoull(value));
+        } else if (arg == "--book-depth") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--book-depth requires a value");
+            }
+            config.book_depth = static_cast<std::size_t>(std::stoull(value));
+        } else if (arg == "--replay-threads") {
+            if (!read_arg_value(argc, argv, i, value)) {
+                throw std::invalid_argument("--replay-threads requires a value");
+            }
+            config.replay_threads = static_cast<std::size_t>(std::stoull(value));
+        } else if (arg == "--no-amend") {
+            requote_cfg.allow_amend = false;
         } else if (arg == "--quiet") {
             config.quiet = true;
         } else if (arg == "--help") {
@@ -132,14 +274,28 @@ SimulationConfig parse_args(int argc, char* argv[]) {
     return config;
 }
 
-uint64_t update_fnv1a(uint64_t hash, const std::string& data) {
+uint64_t update_fnv1a(uint64_t hash, const char* data, std::size_t len) {
     constexpr uint64_t kPrime = 1099511628211ULL;
-    for (unsigned char ch : data) {
-        hash ^= ch;
+    for (std::size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
         hash *= kPrime;
     }
     return hash;
 }
+
+// FNV-1a is streaming, so folding each formatted field in turn gives the same
+// checksum as hashing the concatenated fingerprint, without building a string.
+uint64_t update_fnv1a_fmt(uint64_t hash, const char* fmt, ...) {
+    char buf[128];
+    va_list args;
+    va_start(args, fmt);
+    int len = std::vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (len < 0) {
+        return hash;
+    }
+    return update_fnv1a(hash, buf, std::min(static_cast<std::size_t>(len), sizeof(buf) - 1));
+}
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -175,6 +331,14 @@ int main(int argc, char* argv[]) {
         std::cerr << "--replay provided while mode is simulate; use --mode replay\n";
         return 1;
     }
+    if (config.mode == SimulationMode::Simulate && (config.replay_start_sequence > 0 || config.replay_start_time_ns > 0)) {
+        std::cerr << "--start-seq and --start-time need --mode replay\n";
+        return 1;
+    }
+    if (config.replay_start_sequence > 0 && config.replay_start_time_ns > 0) {
+        std::cerr << "--start-seq and --start-time cannot be combined\n";
+        return 1;
+    }
 
     try {
         MarketSimulator simulator(config);
@@ -186,17 +350,25 @@ int main(int argc, char* argv[]) {
             strategy = std::make_unique<HeuristicStrategy>();
         }
         RiskConfig risk_cfg;
-        MarketMaker mm(risk_cfg, std::move(strategy));
+        MarketMaker mm(risk_cfg, std::move(strategy), requote_cfg);
 
         // Optional binary logger
         std::unique_ptr<BinaryLogger> bin_logger;
         if (!binary_log_path.empty()) {
-            bin_logger = std::make_unique<BinaryLogger>(binary_log_path);
+            bin_logger = std::make_unique<BinaryLogger>(binary_log_path, capture_snapshot_interval);
             if (!bin_logger->is_open()) {
                 std::cerr << "Failed to open binary log: " << binary_log_path << "\n";
                 return 1;
             }
         }
+        std::unique_ptr<ColumnStoreWriter> column_store;
+        if (!column_store_path.empty()) {
+            column_store = std::make_unique<ColumnStoreWriter>();
+            if (!column_store->open(column_store_path)) {
+                std::cerr << "Failed to open column store: " << column_store_path << "\n";
+                return 1;
+            }
+        }
 
         int processed = 0;
         int64_t last_sequence = 0;
@@ -208,10 +380,11 @@ int main(int argc, char* argv[]) {
         int64_t total_mm_fill_count = 0;
         uint64_t checksum = 1469598103934665603ULL;
 
+        // Reused across iterations so the steady-state loop does not allocate
+        MarketDataEvent md;
         while (running && processed < config.iterations) {
-            MarketDataEvent md;
             try {
-                md = simulator.generate_event();
+                simulator.generate_event(md);
             } catch (const std::out_of_range&) {
                 break;
             }
@@ -223,45 +396,50 @@ int main(int argc, char* argv[]) {
             if (bin_logger) {
                 bin_logger->log_event(md);
             }
+            if (column_store) {
+                column_store->append(md);
+            }
 
             ++processed;
             last_sequence = md.sequence_number;
-            sum_bid += md.best_bid_price;
-            sum_ask += md.best_ask_price;
+            sum_bid += from_ticks(md.best_bid_price);
+            sum_ask += from_ticks(md.best_ask_price);
 
-            std::ostringstream event_fp;
-            event_fp << md.sequence_number << "|"
-                     << std::fixed << std::setprecision(6)
-                     << md.best_bid_price << "|"
-                     << md.best_ask_price << "|"
-                     << md.best_bid_size << "|"
-                     << md.best_ask_size;
+            // Fingerprint: seq|bid|ask|bid_size|ask_size then |T:... per trade and |F:... per partial fill
+            checksum = update_fnv1a_fmt(checksum, "%lld|%.6f|%.6f|%d|%d",
+                                        static_cast<long long>(md.sequence_number),
+                                        from_ticks(md.best_bid_price), from_ticks(md.best_ask_price),
+                                        md.best_bid_size, md.best_ask_size);
 
             for (const auto& trade : md.trades) {
                 total_trade_volume += trade.size;
-                event_fp << "|T:" << (trade.aggressor_side == Side::BUY ? "BUY" : "SELL")
-                         << ":" << std::fixed << std::setprecision(6)
-                         << trade.price << ":" << trade.size;
+                checksum = update_fnv1a_fmt(checksum, "|T:%s:%.6f:%d",
+                                            trade.aggressor_side == Side::BUY ? "BUY" : "SELL",
+                                            from_ticks(trade.price), trade.size);
             }
             for (const auto& fill : md.partial_fills) {
                 total_partial_fill_volume += fill.filled_size;
-                event_fp << "|F:" << fill.order_id << ":" << std::fixed << std::setprecision(6)
-                         << fill.price << ":" << fill.filled_size << ":" << fill.remaining_size;
+                checksum = update_fnv1a_fmt(checksum, "|F:%llu:%.6f:%d:%d",
+                                            static_cast<unsigned long long>(fill.order_id),
+                                            from_ticks(fill.price), fill.filled_size, fill.remaining_size);
             }
             for (const auto& fill : md.mm_fills) {
                 total_mm_fill_volume += fill.fill_qty;
                 ++total_mm_fill_count;
             }
-            checksum = update_fnv1a(checksum, event_fp.str());
 
             if (!config.quiet && (processed <= 5 || processed % 100 == 0)) {
                 std::cout << "Event " << md.sequence_number
-                          << " bid=" << std::fixed << std::setprecision(4) << md.best_bid_price
-                          << " ask=" << md.best_ask_price
+                          << " bid=" << std::fixed << std::setprecision(4) << from_ticks(md.best_bid_price)
+                          << " ask=" << from_ticks(md.best_ask_price)
                           << " trades=" << md.trades.size()
                           << " mm_fills=" << md.mm_fills.size() << "\n";
             }
         }
+        if (column_store && !column_store->close()) {
+            std::cerr << "Failed writing column store: " << column_store_path << "\n";
+            return 1;
+        }
 
         const double avg_bid = processed == 0 ? 0.0 : (sum_bid / processed);
         const double avg_ask = processed == 0 ? 0.0 : (sum_ask / processed);
@@ -0,0 +1,337 @@
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <new>
+#include <string>
+#include "MarketMaker.h"
+#include "MarketSimulator.h"
+#include "MatchingEngine.h"
+#include "include/EventLogParser.h"
+#include "include/ParallelReplayReader.h"
+#include "include/SimulationConfig.h"
+
+// Global allocation counter: every operator new in this binary goes through
+// here, so a zero count over a window proves the window never reached malloc.
+// Atomic because replay worker threads allocate too.
+namespace {
+std::atomic<bool> g_counting{false};
+std::atomic<std::size_t> g_allocations{0};
+
+void* counted_alloc(std::size_t size) {
+    if (g_counting) {
+        ++g_allocations;
+    }
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* counted_aligned_alloc(std::size_t size, std::align_val_t align) {
+    if (g_counting) {
+        ++g_allocations;
+    }
+    std::size_t alignment = static_cast<std::size_t>(align);
+    std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+    if (void* p = std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+struct AllocationScope {
+    AllocationScope() {
+        g_allocations = 0;
+        g_counting = true;
+    }
+    ~AllocationScope() { g_counting = false; }
+    std::size_t count() const { return g_allocations; }
+};
+
+auto make_ts(int ms) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
+}
+
+// 1. Warmed-up add/cancel/fill cycle in the engine never allocates
+void test_engine_cycle_zero_alloc() {
+    MatchingEngine engine(64);
+
+    auto populate_and_cancel = [&engine](uint64_t base_id, int ts) {
+        for (uint64_t i = 0; i < 16; ++i) {
+            Price offset = static_cast<Price>(i % 4) * 100;
+            engine.add_order(Order(base_id + i, Side::BUY, to_ticks(99.99) - offset, 5, make_ts(ts)));
+            engine.add_order(Order(base_id + 100 + i, Side::SELL, to_ticks(100.01) + offset, 5, make_ts(ts)));
+        }
+        for (uint64_t i = 0; i < 16; i += 2) {
+            engine.cancel_order(base_id + i);
+        }
+    };
+
+    // Sweep everything left so each round starts from an empty book. The fill
+    // vectors returned here are the caller's allocation, so they stay outside
+    // the counted scope.
+    auto sweep = [&engine](uint64_t trade_id, int ts) {
+        auto buy_fills = engine.match_incoming_order(Side::BUY, to_ticks(200.0), 1000, trade_id, make_ts(ts));
+        auto sell_fills = engine.match_incoming_order(Side::SELL, to_ticks(1.0), 1000, trade_id + 1, make_ts(ts));
+        return buy_fills.size() + sell_fills.size();
+    };
+
+    populate_and_cancel(1000, 1);
+    sweep(1, 2);
+    assert(engine.resting_order_count() == 0);
+
+    for (int round = 0; round < 10; ++round) {
+        uint64_t base = 10000 + static_cast<uint64_t>(round) * 1000;
+        {
+            AllocationScope scope;
+            populate_and_cancel(base, round);
+            assert(scope.count() == 0);
+        }
+        assert(sweep(base, round) == 24);
+        assert(engine.resting_order_count() == 0);
+    }
+
+    std::cout << "PASS: test_engine_cycle_zero_alloc\n";
+}
+
+// 2. Streaming fills through a callback or a reused buffer never allocates
+void test_fill_sink_zero_alloc() {
+    MatchingEngine engine(64);
+    std::vector<FillEvent> buffer;
+    buffer.reserve(64);
+
+    auto populate = [&engine](uint64_t base_id, int ts) {
+        for (uint64_t i = 0; i < 16; ++i) {
+            engine.add_order(Order(base_id + i, Side::SELL, to_ticks(100.01) + static_cast<Price>(i % 4), 5, make_ts(ts)));
+        }
+    };
+
+    populate(1, 0);
+    buffer.clear();
+    engine.match_incoming_order(Side::BUY, to_ticks(200.0), 1000, 1, make_ts(0), buffer);
+
+    for (int round = 0; round < 10; ++round) {
+        uint64_t base = 1000 + static_cast<uint64_t>(round) * 100;
+        AllocationScope scope;
+        populate(base, round);
+        int filled = 0;
+        engine.match_incoming_order_with(Side::BUY, to_ticks(200.0), 40, base, make_ts(round),
+                                         [&filled](const FillEvent& f) { filled += f.fill_qty; });
+        buffer.clear();
+        std::size_t appended = engine.match_incoming_order(Side::BUY, to_ticks(200.0), 1000, base + 1,
+                                                           make_ts(round), buffer);
+        assert(scope.count() == 0);
+        assert(filled == 40);
+        assert(appended == 8);
+        assert(engine.resting_order_count() == 0);
+    }
+
+    std::cout << "PASS: test_fill_sink_zero_alloc\n";
+}
+
+// 3. Steady-state event generation plus MarketMaker quoting (cancel + requote
+// + fills) never allocates once the reused event has grown to its working size
+void test_market_maker_steady_state_zero_alloc() {
+    SimulationConfig config;
+    config.seed = 42;
+    config.latency_ms = 0;
+    config.quiet = true;
+    config.max_resting_orders = 64;
+
+    // Loose limits keep the maker quoting for the whole run
+    RiskConfig risk_cfg;
+    risk_cfg.max_net_position = 1000000;
+    risk_cfg.max_notional_exposure = 1e12;
+    risk_cfg.max_drawdown = 1e12;
+
+    MarketSimulator simulator(config);
+    MarketMaker mm(risk_cfg);
+
+    // Silence per-fill logging without changing what the hot path does
+    std::cout.setstate(std::ios::failbit);
+
+    MarketDataEvent md;
+    for (int i = 0; i < 3000; ++i) {
+        simulator.generate_event(md);
+        mm.on_market_data(md, simulator);
+    }
+
+    const int fills_before = mm.get_total_fills();
+    std::size_t quoted_events = 0;
+    std::size_t allocations = 0;
+    for (int i = 0; i < 5000; ++i) {
+        {
+            AllocationScope scope;
+            simulator.generate_event(md);
+            mm.on_market_data(md, simulator);
+            allocations += scope.count();
+        }
+        if (simulator.get_matching_engine().resting_order_count() > 0) {
+            ++quoted_events;
+        }
+    }
+
+    std::cout.clear();
+
+    assert(mm.get_risk_state() == RiskState::Normal || mm.get_risk_state() == RiskState::Warning);
+    assert(quoted_events > 0);
+    assert(mm.get_total_fills() > fills_before);
+    if (allocations != 0) {
+        std::cerr << "steady-state on_market_data allocated " << allocations << " times\n";
+    }
+    assert(allocations == 0);
+
+    std::cout << "PASS: test_market_maker_steady_state_zero_alloc (fills="
+              << (mm.get_total_fills() - fills_before) << ")\n";
+}
+
+// 4. Events within inline capacity copy without allocating; overflow spills
+// to the heap and survives copy, move and clear
+void test_inline_event_lists() {
+    const auto ts = make_ts(0);
+    MarketDataEvent md;
+    for (int i = 1; i <= 5; ++i) {
+        md.bid_levels.emplace_back(to_ticks(100.0) - i, i, static_cast<uint64_t>(i), ts);
+        md.ask_levels.emplace_back(to_ticks(100.0) + i, i, static_cast<uint64_t>(10 + i), ts);
+    }
+    md.trades.push_back(Trade{Side::BUY, to_ticks(100.0), 2, 1, ts});
+
+    {
+        AllocationScope scope;
+        MarketDataEvent copy(md);
+        MarketDataEvent assigned;
+        assigned = copy;
+        MarketDataEvent moved(std::move(copy));
+        assert(scope.count() == 0);
+        assert(assigned.bid_levels.size() == 5 && moved.ask_levels[4].order_id == 15);
+        assert(moved.trades.size() == 1 && moved.trades[0].size == 2);
+    }
+
+    FillList fills;
+    for (int i = 0; i < static_cast<int>(kInlineFills) * 3; ++i) {
+        fills.push_back(FillEvent{static_cast<uint64_t>(i), 0, Side::BUY, kNoInstrument, to_ticks(1.0), i, 0, ts});
+    }
+    assert(!fills.is_inline() && fills.size() == kInlineFills * 3);
+    FillList copy(fills);
+    FillList moved(std::move(fills));
+    assert(fills.empty() && fills.is_inline());
+    for (std::size_t i = 0; i < moved.size(); ++i) {
+        assert(moved[i].order_id == i && copy[i].fill_qty == static_cast<int>(i));
+    }
+
+    // A spilled list keeps its heap block, so refilling it does not allocate
+    const std::size_t capacity = moved.capacity();
+    moved.clear();
+    {
+        AllocationScope scope;
+        for (std::size_t i = 0; i < capacity; ++i) {
+            moved.push_back(copy[i % copy.size()]);
+        }
+        assert(scope.count() == 0);
+    }
+
+    std::cout << "PASS: test_inline_event_lists\n";
+}
+
+// 5. Replay lines decode into a reused event without allocating, including
+// levels that spill past the inline capacity once the event has grown
+void test_log_parse_zero_alloc() {
+    const std::string small =
+        "7|XYZ|99.9500|100.0500|3|4|1700000000007|99.9500,3,1,1700000000001;99.9000,5,2,1700000000002|"
+        "100.0500,4,3,1700000000003|BUY,100.0500,2,9,1700000000007|5,99.9500,1,2,1700000000007";
+    std::string deep = "8|XYZ|99.9500|100.0500|3|4|1700000000008|";
+    for (int i = 0; i < 40; ++i) {
+        deep += (i ? ";" : "") + std::to_string(99.95 - i * 0.05).substr(0, 6) + ",1," + std::to_string(i) + ",1700000000008";
+    }
+    deep += "|100.0500,4,3,1700000000003||";
+
+    EventLogParser parser;
+    MarketDataEvent md;
+    parser.parse(deep, md);  // grows bid_levels to its heap capacity
+    parser.parse(small, md);
+    {
+        AllocationScope scope;
+        for (int i = 0; i < 100; ++i) {
+            parser.parse(i % 2 == 0 ? deep : small, md);
+        }
+        assert(scope.count() == 0);
+    }
+    assert(md.sequence_number == 7 && md.bid_levels.size() == 2 && md.trades.size() == 1);
+    assert(md.best_ask_price == 1000500 && md.partial_fills[0].remaining_size == 2);
+
+    std::cout << "PASS: test_log_parse_zero_alloc\n";
+}
+
+// 6. The parallel replay reader hands out deep-book events without
+// allocating once every slot has been filled: neither the consumer's event
+// nor the slot it is copied from gives up its heap capacity
+void test_parallel_replay_deep_book_zero_alloc() {
+    // Equal-length lines, so every chunk holds the same number of events
+    const std::string path = "/tmp/market_sim_alloc_deep_replay.log";
+    {
+        std::ofstream out(path, std::ios::trunc);
+        for (int seq = 10000; seq < 30000; ++seq) {
+            out << seq << "|XYZ|99.9500|100.0500|3|4|1700000000007|";
+            for (int level = 10; level < 30; ++level) {
+                out << (level > 10 ? ";" : "") << "99.9500,1," << level << ",1700000000001";
+            }
+            out << "|100.0500,4,3,1700000000003|BUY,100.0500,2,9,1700000000007|\n";
+        }
+    }
+
+    ParallelReplayReader reader;
+    const bool opened = reader.open(path, 2, 16 * 1024);
+    assert(opened);
+    MarketDataEvent md;
+    int events = 0;
+    for (; events < 2000; ++events) {  // about 16 chunks: each of the 4 slots used several times
+        const bool got = reader.next(md);
+        assert(got);
+    }
+    {
+        AllocationScope scope;
+        while (reader.next(md)) {
+            ++events;
+        }
+        assert(scope.count() == 0);
+    }
+    assert(events == 20000 && md.sequence_number == 29999 && md.bid_levels.size() == 20);
+    reader.close();
+    std::remove(path.c_str());
+
+    std::cout << "PASS: test_parallel_replay_deep_book_zero_alloc\n";
+}
+
+} // namespace
+
+int main() {
+    test_engine_cycle_zero_alloc();
+    test_fill_sink_zero_alloc();
+    test_market_maker_steady_state_zero_alloc();
+    test_inline_event_lists();
+    test_log_parse_zero_alloc();
+    test_parallel_replay_deep_book_zero_alloc();
+
+    std::cout << "\nAll allocation tests passed.\n";
+    return 0;
+}
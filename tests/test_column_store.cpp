@@ -0,0 +1,260 @@
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "MarketSimulator.h"
+#include "include/ColumnStore.h"
+#include "include/SimulationConfig.h"
+
+namespace {
+
+namespace cs = column_store;
+namespace scan = column_scan;
+
+const std::string kDir = "/tmp/market_sim_column_store";
+constexpr uint32_t kBlockRows = 64;  // small blocks so ranges cross many edges
+
+const char* const kColumns[] = {"timestamp_ns", "sequence", "bid_price", "ask_price",
+                                "bid_size", "ask_size", "trade_timestamp_ns", "trade_sequence",
+                                "trade_price", "trade_size", "trade_side"};
+
+void remove_store() {
+    for (const char* name : kColumns) {
+        std::remove(cs::column_path(kDir, name).c_str());
+    }
+    std::remove(kDir.c_str());
+}
+
+std::vector<MarketDataEvent> generate(int count) {
+    SimulationConfig config;
+    config.latency_ms = 0;
+    MarketSimulator simulator(config);
+    std::vector<MarketDataEvent> events(count);
+    for (auto& md : events) {
+        simulator.generate_event(md);
+    }
+    return events;
+}
+
+void write_store(const std::vector<MarketDataEvent>& events) {
+    ColumnStoreWriter writer;
+    const bool opened = writer.open(kDir, kBlockRows);
+    assert(opened);
+    for (const auto& md : events) {
+        writer.append(md);
+    }
+    const bool closed = writer.close();
+    assert(closed);
+}
+
+// Ranges that start and end inside, on and across block edges
+std::vector<scan::RowRange> ranges(std::size_t rows) {
+    std::vector<scan::RowRange> out = {{0, rows}, {0, 1}, {rows - 1, rows}, {5, 6}};
+    for (std::size_t begin : {std::size_t{0}, std::size_t{1}, std::size_t{kBlockRows - 1}, std::size_t{kBlockRows},
+                              std::size_t{3 * kBlockRows + 7}}) {
+        for (std::size_t end : {begin + 1, begin + kBlockRows, begin + 5 * kBlockRows + 3, rows}) {
+            if (end <= rows) {
+                out.push_back(scan::RowRange{begin, end});
+            }
+        }
+    }
+    return out;
+}
+
+// 1. Columns hold the events' top of book and every trade, in order
+void test_round_trip(const std::vector<MarketDataEvent>& events) {
+    const ColumnStore store(kDir);
+    const auto ts = store.column<int64_t>("timestamp_ns");
+    const auto seq = store.column<int64_t>("sequence");
+    const auto bid = store.column<int64_t>("bid_price");
+    const auto ask = store.column<int64_t>("ask_price");
+    const auto bid_size = store.column<int32_t>("bid_size");
+    const auto ask_size = store.column<int32_t>("ask_size");
+    assert(ts.rows() == events.size() && ask_size.rows() == events.size());
+    assert(ts.block_rows() == kBlockRows);
+    assert(ts.blocks() == (events.size() + kBlockRows - 1) / kBlockRows);
+
+    std::size_t trades = 0;
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const MarketDataEvent& md = events[i];
+        assert(ts.values()[i] == binary_capture::to_nanos(md.timestamp));
+        assert(seq.values()[i] == md.sequence_number);
+        assert(bid.values()[i] == md.best_bid_price);
+        assert(ask.values()[i] == md.best_ask_price);
+        assert(bid_size.values()[i] == md.best_bid_size);
+        assert(ask_size.values()[i] == md.best_ask_size);
+        trades += md.trades.size();
+    }
+    assert(trades > 0);
+
+    const auto trade_ts = store.column<int64_t>("trade_timestamp_ns");
+    const auto trade_seq = store.column<int64_t>("trade_sequence");
+    const auto trade_price = store.column<int64_t>("trade_price");
+    const auto trade_size = store.column<int32_t>("trade_size");
+    const auto trade_side = store.column<uint8_t>("trade_side");
+    assert(trade_ts.rows() == trades && trade_side.rows() == trades);
+    std::size_t row = 0;
+    for (const auto& md : events) {
+        for (const auto& trade : md.trades) {
+            assert(trade_ts.values()[row] == binary_capture::to_nanos(trade.timestamp));
+            assert(trade_seq.values()[row] == md.sequence_number);
+            assert(trade_price.values()[row] == trade.price);
+            assert(trade_size.values()[row] == trade.size);
+            assert(trade_side.values()[row] == (trade.aggressor_side == Side::BUY ? 0 : 1));
+            ++row;
+        }
+    }
+
+    for (std::size_t b = 0; b < bid.blocks(); ++b) {
+        const std::size_t end = std::min((b + 1) * kBlockRows, bid.rows());
+        int64_t lo = std::numeric_limits<int64_t>::max();
+        int64_t hi = std::numeric_limits<int64_t>::min();
+        for (std::size_t i = b * kBlockRows; i < end; ++i) {
+            lo = std::min(lo, bid.values()[i]);
+            hi = std::max(hi, bid.values()[i]);
+        }
+        assert(bid.stats(b).min == lo && bid.stats(b).max == hi);
+    }
+    std::cout << "PASS: test_round_trip (" << events.size() << " events, " << trades << " trades)\n";
+}
+
+// 2. Every aggregation agrees with a plain loop, whatever the range
+void test_aggregations() {
+    const ColumnStore store(kDir);
+    const auto bid = store.column<int64_t>("bid_price");
+    const auto ask = store.column<int64_t>("ask_price");
+    const auto bid_size = store.column<int32_t>("bid_size");
+    const auto trade_size = store.column<int32_t>("trade_size");
+    const auto trade_side = store.column<uint8_t>("trade_side");
+
+    const int64_t mid = (scan::min(bid, scan::all(bid)) + scan::max(bid, scan::all(bid))) / 2;
+    for (const scan::RowRange r : ranges(bid.rows())) {
+        int64_t sum = 0, spread = 0, size = 0;
+        int64_t lo = std::numeric_limits<int64_t>::max();
+        int64_t hi = std::numeric_limits<int64_t>::min();
+        std::size_t below_mid = 0;
+        for (std::size_t i = r.begin; i < r.end; ++i) {
+            sum += bid.values()[i];
+            spread += ask.values()[i] - bid.values()[i];
+            size += bid_size.values()[i];
+            lo = std::min(lo, bid.values()[i]);
+            hi = std::max(hi, bid.values()[i]);
+            below_mid += bid.values()[i] <= mid;
+        }
+        assert(scan::sum(bid, r) == sum);
+        assert(scan::sum(bid_size, r) == size);
+        assert(scan::sum_diff(ask, bid, r) == spread);
+        assert(scan::min(bid, r) == lo && scan::max(bid, r) == hi);
+        assert(scan::count_between(bid, std::numeric_limits<int64_t>::min(), mid, r) == below_mid);
+        assert(scan::count_between(bid, lo, hi, r) == r.size());
+        assert(scan::count_between(bid, hi + 1, hi + 100, r) == 0);
+    }
+
+    for (const scan::RowRange r : ranges(trade_size.rows())) {
+        int64_t buys = 0, sells = 0;
+        for (std::size_t i = r.begin; i < r.end; ++i) {
+            (trade_side.values()[i] == 0 ? buys : sells) += trade_size.values()[i];
+        }
+        assert(scan::sum_where_equal(trade_size, trade_side, uint8_t{0}, r) == buys);
+        assert(scan::sum_where_equal(trade_size, trade_side, uint8_t{1}, r) == sells);
+        assert(scan::sum_where_equal(trade_size, trade_side, uint8_t{2}, r) == 0);
+    }
+
+    // Columns of different tables cannot be combined
+    const auto trade_price = store.column<int64_t>("trade_price");
+    assert(trade_price.rows() != bid.rows());
+    bool threw = false;
+    try {
+        scan::sum_diff(bid, trade_price, scan::all(trade_price));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "PASS: test_aggregations\n";
+}
+
+// 3. rows_between on the timestamp column finds the same rows as a scan
+void test_rows_between(const std::vector<MarketDataEvent>& events) {
+    const ColumnStore store(kDir);
+    const auto ts = store.column<int64_t>("timestamp_ns");
+    const int64_t first = ts.values()[0];
+    const int64_t last = ts.values()[ts.rows() - 1];
+    const int64_t step = (last - first) / 37 + 1;
+    for (int64_t lo = first - step; lo <= last + step; lo += step) {
+        for (int64_t hi : {lo, lo + step / 3, lo + 5 * step, std::numeric_limits<int64_t>::max()}) {
+            std::size_t begin = 0;
+            while (begin < events.size() && ts.values()[begin] < lo) {
+                ++begin;
+            }
+            std::size_t end = begin;
+            while (end < events.size() && ts.values()[end] <= hi) {
+                ++end;
+            }
+            const scan::RowRange r = scan::rows_between(ts, lo, hi);
+            assert(r.begin == begin && r.end == end);
+        }
+    }
+    assert(scan::rows_between(ts, last, first - 1).empty());
+    // An exact timestamp is found even when it opens a block
+    const int64_t edge = ts.values()[kBlockRows];
+    assert(scan::rows_between(ts, edge, edge).begin <= kBlockRows);
+    assert(scan::rows_between(ts, edge, edge).end > kBlockRows);
+    std::cout << "PASS: test_rows_between\n";
+}
+
+// 4. A wrong type or a missing column throws; an unclosed store is empty
+void test_errors() {
+    const ColumnStore store(kDir);
+    bool threw = false;
+    try {
+        store.column<int32_t>("bid_price");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        store.column<int64_t>("no_such_column");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    {
+        cs::ColumnWriter<int64_t> writer;
+        const bool opened = writer.open(cs::column_path(kDir, "bid_price"), kBlockRows);
+        assert(opened);
+        for (int i = 0; i < 1000; ++i) {
+            writer.append(i);
+        }
+        // Read before close(): the header still says 0 rows
+        const auto partial = store.column<int64_t>("bid_price");
+        assert(partial.rows() == 0 && partial.blocks() == 0);
+        const bool written = writer.close();
+        assert(written);
+    }
+    const auto closed = store.column<int64_t>("bid_price");
+    assert(closed.rows() == 1000 && scan::sum(closed, scan::all(closed)) == 999 * 1000 / 2);
+    std::cout << "PASS: test_errors\n";
+}
+
+} // namespace
+
+int main() {
+    remove_store();
+    const std::vector<MarketDataEvent> events = generate(2000);
+    write_store(events);
+
+    test_round_trip(events);
+    test_aggregations();
+    test_rows_between(events);
+    test_errors();
+
+    remove_store();
+    std::cout << "\nAll column store tests passed.\n";
+    return 0;
+}
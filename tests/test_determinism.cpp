@@ -1,14 +1,23 @@
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 #include "MarketSimulator.h"
+#include "include/AsyncEventLog.h"
+#include "include/BinaryCaptureReader.h"
+#include "include/BinaryLogger.h"
+#include "include/EventLogParser.h"
+#include "include/ParallelReplayReader.h"
+#include "include/SequenceIndex.h"
 #include "include/SimulationConfig.h"
 
 namespace {
@@ -37,17 +46,17 @@ std::string event_fingerprint(const MarketDataEvent& md) {
     std::ostringstream fp;
     fp << md.sequence_number << "|"
        << std::fixed << std::setprecision(6)
-       << md.best_bid_price << "|"
-       << md.best_ask_price << "|"
+       << from_ticks(md.best_bid_price) << "|"
+       << from_ticks(md.best_ask_price) << "|"
        << md.best_bid_size << "|"
        << md.best_ask_size;
     for (const auto& trade : md.trades) {
         fp << "|T:" << (trade.aggressor_side == Side::BUY ? "BUY" : "SELL") << ":"
-           << std::fixed << std::setprecision(6) << trade.price << ":" << trade.size;
+           << std::fixed << std::setprecision(6) << from_ticks(trade.price) << ":" << trade.size;
     }
     for (const auto& fill : md.partial_fills) {
         fp << "|F:" << fill.order_id << ":"
-           << std::fixed << std::setprecision(6) << fill.price << ":"
+           << std::fixed << std::setprecision(6) << from_ticks(fill.price) << ":"
            << fill.filled_size << ":" << fill.remaining_size;
     }
     return fp.str();
@@ -57,12 +66,8 @@ int64_t to_millis(const std::chrono::system_clock::time_point& ts) {
     return std::chrono::duration_cast<std::chrono::milliseconds>(ts.time_since_epoch()).count();
 }
 
-bool nearly_equal(double a, double b, double epsilon = 1e-12) {
-    return std::abs(a - b) <= epsilon;
-}
-
 void assert_order_level_equal(const OrderLevel& lhs, const OrderLevel& rhs) {
-    assert(nearly_equal(lhs.price, rhs.price));
+    assert(lhs.price == rhs.price);
     assert(lhs.size == rhs.size);
     assert(lhs.order_id == rhs.order_id);
     assert(to_millis(lhs.timestamp) == to_millis(rhs.timestamp));
@@ -70,7 +75,7 @@ void assert_order_level_equal(const OrderLevel& lhs, const OrderLevel& rhs) {
 
 void assert_trade_equal(const Trade& lhs, const Trade& rhs) {
     assert(lhs.aggressor_side == rhs.aggressor_side);
-    assert(nearly_equal(lhs.price, rhs.price));
+    assert(lhs.price == rhs.price);
     assert(lhs.size == rhs.size);
     assert(lhs.trade_id == rhs.trade_id);
     assert(to_millis(lhs.timestamp) == to_millis(rhs.timestamp));
@@ -78,16 +83,16 @@ void assert_trade_equal(const Trade& lhs, const Trade& rhs) {
 
 void assert_partial_fill_equal(const PartialFillEvent& lhs, const PartialFillEvent& rhs) {
     assert(lhs.order_id == rhs.order_id);
-    assert(nearly_equal(lhs.price, rhs.price));
+    assert(lhs.price == rhs.price);
     assert(lhs.filled_size == rhs.filled_size);
     assert(lhs.remaining_size == rhs.remaining_size);
     assert(to_millis(lhs.timestamp) == to_millis(rhs.timestamp));
 }
 
 void assert_event_equal(const MarketDataEvent& lhs, const MarketDataEvent& rhs) {
-    assert(lhs.instrument == rhs.instrument);
-    assert(nearly_equal(lhs.best_bid_price, rhs.best_bid_price));
-    assert(nearly_equal(lhs.best_ask_price, rhs.best_ask_price));
+    assert(lhs.instrument_id == rhs.instrument_id);
+    assert(lhs.best_bid_price == rhs.best_bid_price);
+    assert(lhs.best_ask_price == rhs.best_ask_price);
     assert(lhs.best_bid_size == rhs.best_bid_size);
     assert(lhs.best_ask_size == rhs.best_ask_size);
     assert(lhs.sequence_number == rhs.sequence_number);
@@ -130,8 +135,8 @@ RunCapture run_capture(const SimulationConfig& config, int events_to_process) {
 
         run.events.push_back(md);
         ++run.digest.processed;
-        sum_bid += md.best_bid_price;
-        sum_ask += md.best_ask_price;
+        sum_bid += from_ticks(md.best_bid_price);
+        sum_ask += from_ticks(md.best_ask_price);
         run.digest.checksum = update_fnv1a(run.digest.checksum, event_fingerprint(md));
     }
 
@@ -141,8 +146,536 @@ RunCapture run_capture(const SimulationConfig& config, int events_to_process) {
     }
     return run;
 }
+// A deep synthetic book keeps both sides sorted without a per-event sort,
+// and its jitter never lets a level reach its neighbour
+void check_deep_book() {
+    SimulationConfig deep;
+    deep.latency_ms = 0;
+    deep.book_depth = 2000;
+    deep.spread = 0.001;  // 5-tick spacing: tighter than the default jitter cap
+    MarketSimulator simulator(deep);
+    MarketDataEvent md;
+    for (int i = 0; i < 300; ++i) {
+        simulator.generate_event(md);
+        assert(md.bid_levels.size() == deep.book_depth && md.ask_levels.size() == deep.book_depth);
+        assert(md.best_bid_price < md.best_ask_price);
+        for (std::size_t k = 1; k < deep.book_depth; ++k) {
+            assert(md.bid_levels[k].price < md.bid_levels[k - 1].price);
+            assert(md.ask_levels[k].price > md.ask_levels[k - 1].price);
+        }
+    }
+
+    for (std::size_t bad : {std::size_t{0}, kMaxBookDepth + 1}) {
+        SimulationConfig invalid;
+        invalid.book_depth = bad;
+        bool threw = false;
+        try {
+            MarketSimulator rejected(invalid);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+}
+// Prices format exactly as std::fixed did for from_ticks(), and the async
+// writer puts every pushed event on disk in order even when the ring is tiny
+void check_async_event_log(const std::vector<MarketDataEvent>& generated) {
+    for (Price ticks : {Price{0}, Price{1}, Price{-1}, Price{9999}, Price{10000}, Price{-10001}, Price{1012345},
+                        Price{-999999999}, Price{123456789012}}) {
+        std::ostringstream expected;
+        expected << std::fixed << std::setprecision(kPriceDecimals) << from_ticks(ticks);
+        char buf[event_log::kMaxPriceChars];
+        const std::string formatted(buf, event_log::write_price(buf, ticks));
+        assert(formatted == expected.str());
+        assert(EventLogParser::parse_ticks(formatted) == ticks);
+    }
+
+    const std::string path = "/tmp/market_sim_async_event_log.log";
+    std::string expected;
+    {
+        AsyncEventLog log;
+        const bool opened = log.open(path, 2);
+        assert(opened);
+        for (int round = 0; round < 20; ++round) {
+            for (const auto& event : generated) {
+                log.push(event);
+                event_log::append_event(expected, event, InstrumentRegistry::global().name(event.instrument_id));
+            }
+        }
+        const bool closed = log.close();
+        assert(closed);
+    }
+    std::ifstream in(path, std::ios::binary);
+    const std::string written((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    assert(written == expected);
+    std::remove(path.c_str());
+    std::remove(sequence_index::path_for(path).c_str());
+}
+// A binary capture round-trips every field, nanosecond timestamps and MM
+// fills included, replays like the text log, and rejects other files and
+// truncated records
+void check_binary_capture(const std::vector<MarketDataEvent>& generated, const std::string& text_log) {
+    const std::string path = "/tmp/market_sim_determinism_capture.bin";
+    std::vector<MarketDataEvent> written = generated;
+    const InstrumentId other = InstrumentRegistry::global().intern("CAPTURE2");
+    written[3].mm_fills.push_back(FillEvent{11, 12, Side::SELL, other, 1012345, 3, 7, written[3].timestamp +
+                                            std::chrono::nanoseconds(123)});
+    written[3].bid_levels[0].timestamp += std::chrono::nanoseconds(456);
+    // Deltas have to carry depth changes, an empty side, a best price off the
+    // book, order id changes, trades, partial fills and sequence gaps
+    written[5].bid_levels.pop_back();
+    written[5].best_bid_size += 1;
+    written[6].ask_levels.clear();
+    written[8].bid_levels[1].order_id += 1000;
+    written[9].trades.push_back(Trade{Side::SELL, written[9].best_bid_price - 300, 4, 77, written[9].timestamp});
+    written[9].partial_fills.push_back(PartialFillEvent{99, written[9].best_ask_price, 2, 5, written[9].timestamp});
+    for (std::size_t i = 10; i < written.size(); ++i) {
+        written[i].sequence_number += 5;
+    }
+
+    auto write_capture = [&](const std::vector<MarketDataEvent>& events, uint32_t snapshot_interval) {
+        {
+            BinaryLogger logger(path, snapshot_interval);
+            assert(logger.is_open());
+            for (const auto& event : events) {
+                logger.log_event(event);
+            }
+        }
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        return static_cast<std::size_t>(in.tellg());
+    };
+    auto read_back = [&](const std::vector<MarketDataEvent>& events) {
+        BinaryCaptureReader reader;
+        const bool opened = reader.open(path);
+        assert(opened && reader.has_next());
+        MarketDataEvent md;
+        std::size_t count = 0;
+        while (reader.next(md)) {
+            const MarketDataEvent& expected = events[count++];
+            assert_event_equal(expected, md);
+            assert(md.timestamp == expected.timestamp);
+            assert(md.bid_levels[0].timestamp == expected.bid_levels[0].timestamp);
+            assert(md.mm_fills.size() == expected.mm_fills.size());
+            for (std::size_t i = 0; i < md.mm_fills.size(); ++i) {
+                const FillEvent& a = md.mm_fills[i];
+                const FillEvent& b = expected.mm_fills[i];
+                assert(a.order_id == b.order_id && a.trade_id == b.trade_id && a.side == b.side);
+                assert(a.instrument_id == b.instrument_id && a.price == b.price && a.fill_qty == b.fill_qty);
+                assert(a.leaves_qty == b.leaves_qty && a.timestamp == b.timestamp);
+            }
+            assert(reader.record_number() == count);
+        }
+        assert(count == events.size() && !reader.has_next());
+    };
+    for (uint32_t interval : {1u, 2u, 7u, BinaryLogger::kDefaultSnapshotInterval}) {
+        write_capture(written, interval);
+        read_back(written);
+    }
+
+    // Deltas make the capture several times smaller, and snapshot-only
+    // version 2 files still read
+    const std::size_t snapshots_only = write_capture(generated, 1);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        const uint16_t version = 2;
+        file.seekp(offsetof(binary_capture::FileHeader, version));
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+    read_back(generated);
+    const std::size_t with_deltas = write_capture(generated, BinaryLogger::kDefaultSnapshotInterval);
+    assert(with_deltas * 5 < snapshots_only);
+
+    SimulationConfig binary;
+    binary.mode = SimulationMode::Replay;
+    binary.replay_format = ReplayFormat::Binary;
+    binary.replay_log_path = path;
+    binary.replay_threads = 4;  // ignored for captures
+    SimulationConfig text = binary;
+    text.replay_format = ReplayFormat::Text;
+    text.replay_log_path = text_log;
+    MarketSimulator from_binary(binary);
+    MarketSimulator from_text(text);
+    MarketDataEvent a;
+    MarketDataEvent b;
+    for (std::size_t i = 0; i < generated.size(); ++i) {
+        from_binary.generate_event(a);
+        from_text.generate_event(b);
+        assert_event_equal(b, a);
+        assert(a.mm_fills.empty());
+    }
+
+    auto open_fails = [&](const std::string& file) {
+        SimulationConfig replay = binary;
+        replay.replay_log_path = file;
+        try {
+            MarketSimulator simulator(replay);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(open_fails(text_log));
+
+    std::ifstream in(path, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes.substr(0, bytes.size() - 8);
+    MarketSimulator truncated(binary);
+    bool threw = false;
+    try {
+        for (std::size_t i = 0; i < generated.size(); ++i) {
+            truncated.generate_event(a);
+        }
+    } catch (const std::runtime_error& e) {
+        threw = std::string(e.what()).find("Truncated") != std::string::npos;
+    }
+    assert(threw);
+    std::remove(path.c_str());
+    std::remove(sequence_index::path_for(path).c_str());
+}
+// Chunked parallel parsing hands back the same events, in order, whatever
+// the thread count and chunk size, and still reports bad lines and sequence
+// gaps at the right line
+void check_parallel_replay(const std::vector<MarketDataEvent>& generated, const std::string& log_path) {
+    for (std::size_t threads : {1u, 2u, 3u, 8u}) {
+        for (std::size_t chunk : {std::size_t{1}, std::size_t{997}, ParallelReplayReader::kDefaultChunkBytes}) {
+            ParallelReplayReader reader;
+            const bool opened = reader.open(log_path, threads, chunk);
+            assert(opened);
+            MarketDataEvent md;
+            std::size_t count = 0;
+            while (reader.next(md)) {
+                assert(count < generated.size());
+                assert_event_equal(generated[count], md);
+                assert(reader.line_number() == ++count);
+            }
+            assert(count == generated.size());
+        }
+    }
+
+    std::vector<std::string> lines;
+    {
+        std::ifstream in(log_path);
+        for (std::string line; std::getline(in, line);) {
+            lines.push_back(line);
+        }
+    }
+    const std::string edited_path = log_path + ".edited";
+    auto write_lines = [&](std::size_t skip, const char* replace_with) {
+        std::ofstream out(edited_path, std::ios::trunc);
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            if (i == skip) {
+                if (replace_with == nullptr) {
+                    continue;
+                }
+                out << replace_with << "\n";
+            } else {
+                out << lines[i] << "\n";
+            }
+        }
+    };
+    // Expects replay to match the log up to line `bad` and fail there
+    auto expect_failure_at = [&](std::size_t threads, std::size_t bad, const char* what) {
+        SimulationConfig replay;
+        replay.mode = SimulationMode::Replay;
+        replay.replay_log_path = edited_path;
+        replay.replay_threads = threads;
+        MarketSimulator simulator(replay);
+        MarketDataEvent md;
+        for (std::size_t i = 0; i + 1 < bad; ++i) {
+            simulator.generate_event(md);
+            assert_event_equal(generated[i], md);
+        }
+        bool threw = false;
+        try {
+            simulator.generate_event(md);
+        } catch (const std::runtime_error& e) {
+            const std::string msg = e.what();
+            threw = msg.find(":" + std::to_string(bad) + ":") != std::string::npos &&
+                    msg.find(what) != std::string::npos;
+        }
+        assert(threw);
+    };
+
+    const std::size_t dropped = lines.size() / 2;
+    write_lines(dropped, nullptr);
+    expect_failure_at(1, dropped + 1, "sequence gap");
+    expect_failure_at(4, dropped + 1, "sequence gap");
+
+    write_lines(dropped, "garbage");
+    expect_failure_at(1, dropped + 1, "Malformed");
+    expect_failure_at(4, dropped + 1, "Malformed");
+    std::remove(edited_path.c_str());
+
+    SimulationConfig replay;
+    replay.mode = SimulationMode::Replay;
+    replay.replay_log_path = log_path;
+    replay.replay_threads = 3;
+    MarketSimulator simulator(replay);
+    MarketDataEvent md;
+    for (const auto& expected : generated) {
+        simulator.generate_event(md);
+        assert_event_equal(expected, md);
+    }
+    bool exhausted = false;
+    try {
+        simulator.generate_event(md);
+    } catch (const std::out_of_range&) {
+        exhausted = true;
+    }
+    assert(exhausted);
+}
+// Replay can start at any sequence number or time, through the sequence
+// index or without one, from text logs (sequential and parallel) and from
+// captures whose seek points fall between symbol records and deltas
+void check_replay_start(const std::vector<MarketDataEvent>& generated) {
+    const std::string text_path = "/tmp/market_sim_determinism_seek.log";
+    const std::string capture_path = "/tmp/market_sim_determinism_seek.bin";
+    constexpr uint32_t kInterval = 16;
+    std::vector<MarketDataEvent> events = generated;
+    const InstrumentId second = InstrumentRegistry::global().intern("SEEK2");
+    for (std::size_t i = 40; i < events.size(); i += 3) {
+        events[i].instrument_id = second;  // first seen well after the first seek point
+    }
+    {
+        AsyncEventLog text;
+        const bool opened = text.open(text_path, AsyncEventLog::kDefaultCapacity, kInterval);
+        assert(opened);
+        BinaryLogger capture(capture_path, 7, kInterval);
+        assert(capture.is_open());
+        for (const auto& event : events) {
+            text.push(event);
+            capture.log_event(event);
+        }
+        const bool closed = text.close();
+        assert(closed);
+    }
+
+    SequenceIndex index;
+    bool loaded = index.load(sequence_index::path_for(text_path));
+    assert(loaded);
+    assert(index.points().size() == (events.size() + kInterval - 1) / kInterval);
+    const sequence_index::IndexEntry* point = index.point_for_sequence(events[40].sequence_number);
+    assert(point != nullptr && point->event_number == 32 && point->sequence_number == events[32].sequence_number);
+    assert(index.point_for_sequence(events[0].sequence_number - 1) == nullptr);
+    loaded = index.load(sequence_index::path_for(capture_path));
+    assert(loaded && index.symbol_offsets().size() == 2);
+
+    auto replay_from = [&](const std::string& path, ReplayFormat format, std::size_t threads, int64_t start_seq,
+                           int64_t start_ns, std::size_t first) {
+        SimulationConfig config;
+        config.mode = SimulationMode::Replay;
+        config.replay_log_path = path;
+        config.replay_format = format;
+        config.replay_threads = threads;
+        config.replay_start_sequence = start_seq;
+        config.replay_start_time_ns = start_ns;
+        MarketSimulator simulator(config);
+        MarketDataEvent md;
+        for (std::size_t i = first; i < events.size(); ++i) {
+            simulator.generate_event(md);
+            assert_event_equal(events[i], md);
+        }
+        bool exhausted = false;
+        try {
+            simulator.generate_event(md);
+        } catch (const std::out_of_range&) {
+            exhausted = true;
+        }
+        assert(exhausted);
+    };
+    auto replay_all_ways = [&](int64_t start_seq, int64_t start_ns, std::size_t first) {
+        replay_from(text_path, ReplayFormat::Text, 1, start_seq, start_ns, first);
+        replay_from(text_path, ReplayFormat::Text, 3, start_seq, start_ns, first);
+        replay_from(capture_path, ReplayFormat::Binary, 1, start_seq, start_ns, first);
+    };
+    for (std::size_t first : {std::size_t{0}, std::size_t{1}, std::size_t{15}, std::size_t{16}, std::size_t{41},
+                              events.size() - 1}) {
+        replay_all_ways(events[first].sequence_number, 0, first);
+    }
+    // A time between two events starts at the later one
+    const auto ns = [](std::chrono::system_clock::time_point ts) { return binary_capture::to_nanos(ts); };
+    std::size_t first = 100;
+    while (ns(events[first].timestamp) == ns(events[first - 1].timestamp)) {
+        --first;
+    }
+    replay_all_ways(0, ns(events[first].timestamp), first);
+    replay_all_ways(0, ns(events[first].timestamp) - 1, first);
+
+    auto open_error = [&](const std::string& path, ReplayFormat format, int64_t start_seq) {
+        try {
+            replay_from(path, format, 1, start_seq, 0, 0);
+        } catch (const std::runtime_error& e) {
+            return std::string(e.what());
+        }
+        return std::string();
+    };
+    const int64_t past_end = events.back().sequence_number + 1;
+    assert(open_error(text_path, ReplayFormat::Text, past_end).find("past the end") != std::string::npos);
+    assert(open_error(capture_path, ReplayFormat::Binary, past_end).find("past the end") != std::string::npos);
+
+    // An index that belongs to another file is caught, and without an index
+    // replay reads from the start
+    std::rename(sequence_index::path_for(text_path).c_str(), (text_path + ".saved").c_str());
+    {
+        std::ifstream in(sequence_index::path_for(capture_path), std::ios::binary);
+        std::ofstream(sequence_index::path_for(text_path), std::ios::binary) << in.rdbuf();
+    }
+    assert(open_error(text_path, ReplayFormat::Text, events[100].sequence_number).find("does not match") !=
+           std::string::npos);
+    std::remove(sequence_index::path_for(text_path).c_str());
+    replay_from(text_path, ReplayFormat::Text, 1, events[100].sequence_number, 0, 100);
+    std::rename((text_path + ".saved").c_str(), sequence_index::path_for(capture_path).c_str());
+    assert(open_error(capture_path, ReplayFormat::Binary, events[100].sequence_number).find("does not match") !=
+           std::string::npos);
+
+    for (const std::string& path : {text_path, capture_path}) {
+        std::remove(path.c_str());
+        std::remove(sequence_index::path_for(path).c_str());
+    }
+}
+// Replay parses lazily: a bad line only fails when it is reached, blank
+// lines are skipped, and the last line needs no trailing newline
+void check_streaming_replay(const std::vector<MarketDataEvent>& generated, const std::string& log_path) {
+    {
+        std::ofstream out(log_path, std::ios::app);
+        out << "\n\nnot|an|event";
+    }
+    SimulationConfig replay;
+    replay.mode = SimulationMode::Replay;
+    replay.replay_log_path = log_path;
+    MarketSimulator simulator(replay);
+    MarketDataEvent md;
+    for (const auto& expected : generated) {
+        simulator.generate_event(md);
+        assert_event_equal(expected, md);
+    }
+    bool threw = false;
+    try {
+        simulator.generate_event(md);
+    } catch (const std::runtime_error& e) {
+        const std::string where = ":" + std::to_string(generated.size() + 3) + ":";
+        threw = std::string(e.what()).find(where) != std::string::npos;
+    }
+    assert(threw);
+
+    for (const char* contents : {"", "\n\n"}) {
+        std::ofstream(log_path, std::ios::trunc) << contents;
+        threw = false;
+        try {
+            MarketSimulator empty(replay);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    std::remove(log_path.c_str());
+    std::remove(sequence_index::path_for(log_path).c_str());
+}
+// Prices decode to exact ticks, and bad numbers or field counts are errors
+void check_log_parser() {
+    assert(EventLogParser::parse_ticks("101.2345") == 1012345);
+    assert(EventLogParser::parse_ticks("101.2") == 1012000);
+    assert(EventLogParser::parse_ticks("101") == 1010000);
+    assert(EventLogParser::parse_ticks("-0.0001") == -1);
+    assert(EventLogParser::parse_ticks(".5") == 5000);
+    assert(EventLogParser::parse_ticks("0.30000000000000004") == to_ticks(0.30000000000000004));
+    assert(EventLogParser::parse_ticks("100.00015") == to_ticks(100.00015));
+
+    for (const char* bad : {"", "-", ".", "1.2.3", "12a", "--1", "+1"}) {
+        bool threw = false;
+        try {
+            EventLogParser::parse_ticks(bad);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    EventLogParser parser;
+    MarketDataEvent md;
+    for (const char* bad : {"1|XYZ|1|2|3|4|5|||", "1|XYZ|1|2|3|4|5|||||", "x|XYZ|1|2|3|4|5||||",
+                            "1|XYZ|1|2|3|4|5|1,2,3||||", "1|XYZ|1|2|3|4|5|||BUY,1,2,3|"}) {
+        bool threw = false;
+        try {
+            parser.parse(bad, md);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    parser.parse("1|XYZ|1|2|3|4|5||||", md);
+    assert(md.sequence_number == 1 && md.bid_levels.empty() && md.best_ask_price == 20000);
+}
 } // namespace
 
+// With sub-millisecond ticks the text log keeps the remaining nanoseconds, so
+// replay and a start time reproduce the run's clock
+void check_sub_ms_log() {
+    using std::chrono::nanoseconds;
+    const auto at = [](int64_t ns) {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(nanoseconds(ns)));
+    };
+    for (int64_t ns : {int64_t{1700000000000000000}, int64_t{1700000000000010000}, int64_t{1700000000000000001},
+                       int64_t{-1500000}}) {
+        MarketDataEvent md;
+        md.timestamp = at(ns);
+        std::string line;
+        event_log::append_event(line, md, "XYZ");
+        line.pop_back();  // newline
+        EventLogParser parser;
+        MarketDataEvent parsed;
+        parser.parse(line, parsed);
+        assert(parsed.timestamp == md.timestamp);
+        // Whole milliseconds are written as before, without a fraction
+        std::size_t start = 0;
+        for (int field = 0; field < 6; ++field) {
+            start = line.find('|', start) + 1;
+        }
+        const std::string ts_field = line.substr(start, line.find('|', start) - start);
+        assert((ts_field.find('.') == std::string::npos) == (ns % 1000000 == 0));
+    }
+    EventLogParser parser;
+    MarketDataEvent md;
+    parser.parse("1|XYZ|1|2|3|4|5.25||||", md);
+    assert(md.timestamp == at(5250000));
+    for (const char* bad : {"1|XYZ|1|2|3|4|5.||||", "1|XYZ|1|2|3|4|5.1234567||||", "1|XYZ|1|2|3|4|5.-1||||",
+                            "1|XYZ|1|2|3|4|.5||||"}) {
+        bool threw = false;
+        try {
+            parser.parse(bad, md);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    const std::string path = "/tmp/market_sim_determinism_sub_ms.log";
+    SimulationConfig writer;
+    writer.latency_ms = 0;
+    writer.tick_interval_ns = 10000;  // 10 us
+    writer.event_log_path = path;
+    const RunCapture generated = run_capture(writer, 300);
+    SimulationConfig replay;
+    replay.mode = SimulationMode::Replay;
+    replay.replay_log_path = path;
+    const RunCapture replayed = run_capture(replay, 300);
+    assert(replayed.events.size() == generated.events.size());
+    for (std::size_t i = 0; i < generated.events.size(); ++i) {
+        assert_event_equal(generated.events[i], replayed.events[i]);
+        assert(replayed.events[i].timestamp == generated.events[i].timestamp);
+        assert(i == 0 || replayed.events[i].timestamp > replayed.events[i - 1].timestamp);
+    }
+
+    const MarketDataEvent& target = generated.events[123];
+    replay.replay_start_time_ns = std::chrono::duration_cast<nanoseconds>(target.timestamp.time_since_epoch()).count();
+    MarketSimulator from_time(replay);
+    from_time.generate_event(md);
+    assert(md.sequence_number == target.sequence_number);
+    std::remove(path.c_str());
+    std::remove(sequence_index::path_for(path).c_str());
+}
+
 int main() {
     SimulationConfig base;
     base.iterations = 200;
@@ -188,9 +721,16 @@ int main() {
         assert_event_equal(from_generation.events[i], from_replay.events[i]);
     }
 
-    std::remove(log_path.c_str());
+    check_async_event_log(from_generation.events);
+    check_binary_capture(from_generation.events, log_path);
+    check_parallel_replay(from_generation.events, log_path);
+    check_streaming_replay(from_generation.events, log_path);
+    check_replay_start(from_generation.events);
+    check_deep_book();
+    check_log_parser();
+    check_sub_ms_log();
 
     std::cout << "Determinism tests passed: "
-              << "same-seed stable, different-seed diverges, replay matches generation byte-for-byte.\n";
+              << "same-seed stable, different-seed diverges, async log is complete, binary capture round-trips, replay matches generation byte-for-byte, streams lazily and parses in parallel chunks, seeks to a start sequence or time, deep book stays sorted, sub-ms clocks survive the text log.\n";
     return 0;
 }
@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "MarketMaker.h"
+#include "MarketSimulator.h"
+#include "include/EventScheduler.h"
+#include "include/LatencyModel.h"
+#include "include/SimulationConfig.h"
+
+namespace {
+
+constexpr int64_t kMs = 1000000;
+
+SimulationConfig make_config(int md_latency_ms, int64_t order_latency_ns, int64_t fill_latency_ns) {
+    SimulationConfig config;
+    config.seed = 42;
+    config.quiet = true;
+    config.latency_ms = md_latency_ms;
+    config.order_latency = LatencyModel::constant(order_latency_ns);
+    config.cancel_latency = LatencyModel::constant(order_latency_ns);
+    config.ack_latency = LatencyModel::constant(fill_latency_ns);
+    return config;
+}
+
+// 1. Scheduler runs entries in time order, ties in scheduling order, and
+// only up to the requested time
+void test_scheduler_ordering() {
+    EventScheduler<int> scheduler;
+    scheduler.schedule(30, 1);
+    scheduler.schedule(10, 2);
+    scheduler.schedule(20, 3);
+    scheduler.schedule(10, 4);
+    assert(scheduler.size() == 4 && scheduler.next_time() == 10);
+
+    std::vector<int> order;
+    auto record = [&order](SimTime, int payload) { order.push_back(payload); };
+    assert(scheduler.run_until(19, record) == 2);
+    assert((order == std::vector<int>{2, 4}));
+
+    // Entries scheduled while running are picked up if they are also due
+    order.clear();
+    scheduler.run_until(30, [&](SimTime t, int payload) {
+        order.push_back(payload);
+        if (payload == 3) {
+            scheduler.schedule(t + 5, 5);
+            scheduler.schedule(t + 50, 6);
+        }
+    });
+    assert((order == std::vector<int>{3, 5, 1}));
+    assert(scheduler.size() == 1 && scheduler.next_time() == 70);
+
+    std::cout << "PASS: test_scheduler_ordering\n";
+}
+
+// 2. An order stays in flight until the exchange clock reaches its arrival time
+void test_order_pending_until_arrival() {
+    MarketSimulator simulator(make_config(0, 5 * kMs, 0));
+    MarketDataEvent md;
+    simulator.generate_event(md);
+
+    Order order(1ULL << 48 | 1, Side::BUY, to_ticks(50.0), 5, md.timestamp);
+    const SimTime arrival = simulator.mm_receive_time() + 5 * kMs;
+    OrderStatus status = simulator.submit_order(order);
+    assert(status == OrderStatus::NEW);
+    assert(simulator.pending_order_actions() == 1);
+    assert(simulator.get_matching_engine().resting_order_count() == 0);
+
+    while (simulator.exchange_time() < arrival) {
+        assert(simulator.get_matching_engine().resting_order_count() == 0);
+        simulator.generate_event(md);
+    }
+    simulator.generate_event(md);
+    assert(simulator.pending_order_actions() == 0);
+    assert(simulator.get_matching_engine().resting_order_count() == 1);
+
+    // Without latency the engine answers directly
+    MarketSimulator direct(make_config(0, 0, 0));
+    direct.generate_event(md);
+    status = direct.submit_order(order);
+    assert(status == OrderStatus::ACKNOWLEDGED);
+    assert(direct.get_matching_engine().resting_order_count() == 1);
+
+    std::cout << "PASS: test_order_pending_until_arrival\n";
+}
+
+// 3. A resting order keeps trading while its cancel is in flight
+void test_stale_order_picked_off_before_cancel() {
+    MarketSimulator simulator(make_config(0, 200 * kMs, 0));
+    MarketDataEvent md;
+    simulator.generate_event(md);
+
+    // Bids far through the market so any sell trade hits them
+    const uint64_t id = 1ULL << 48 | 7;
+    simulator.submit_order(Order(id, Side::BUY, to_ticks(200.0), 1000, md.timestamp));
+    while (simulator.pending_order_actions() > 0) {
+        simulator.generate_event(md);
+    }
+    assert(simulator.get_matching_engine().resting_order_count() == 1);
+
+    bool cancel_sent = simulator.cancel_order(id);
+    assert(cancel_sent);
+    int filled_in_flight = 0;
+    while (simulator.pending_order_actions() > 0) {
+        simulator.generate_event(md);
+        for (const auto& fill : md.mm_fills) {
+            assert(fill.order_id == id);
+            filled_in_flight += fill.fill_qty;
+        }
+    }
+    assert(filled_in_flight > 0);
+    assert(simulator.get_matching_engine().resting_order_count() == 0);
+    assert(simulator.rejected_on_arrival() == 0);
+
+    std::cout << "PASS: test_stale_order_picked_off_before_cancel (filled=" << filled_in_flight << ")\n";
+}
+
+// 4. Fill reports reach the MM no earlier than fill latency after the match,
+// in the first event the MM receives after that
+void test_fill_reports_delayed() {
+    const int md_latency_ms = 2;
+    const int64_t fill_latency = 20 * kMs;
+    MarketSimulator simulator(make_config(md_latency_ms, 0, fill_latency));
+    MarketDataEvent md;
+    simulator.generate_event(md);
+    simulator.submit_order(Order(1ULL << 48 | 9, Side::BUY, to_ticks(200.0), 100000, md.timestamp));
+
+    int reports = 0;
+    SimTime previous_receive = simulator.mm_receive_time();
+    for (int i = 0; i < 2000; ++i) {
+        simulator.generate_event(md);
+        const SimTime receive = simulator.mm_receive_time();
+        assert(receive == to_sim_time(md.timestamp) + md_latency_ms * kMs);
+        for (const auto& fill : md.mm_fills) {
+            const SimTime due = to_sim_time(fill.timestamp) + fill_latency;
+            assert(due <= receive && due > previous_receive);
+            ++reports;
+        }
+        previous_receive = receive;
+    }
+    assert(reports > 0);
+
+    std::cout << "PASS: test_fill_reports_delayed (reports=" << reports << ")\n";
+}
+
+// 5. Latency is virtual: the exchange clock only moves in whole ticks and a
+// 10 ms market data latency only shifts the MM's receive time, and the MM
+// still accounts every fill, including fills on orders it has cancelled
+void test_latency_is_simulated_time() {
+    SimulationConfig config = make_config(10, 250000, 100000);
+    config.iterations = 1000;
+    MarketSimulator simulator(config);
+    MarketMaker mm;
+    const SimTime tick = static_cast<SimTime>(config.tick_interval_ns);
+
+    std::cout.setstate(std::ios::failbit);
+    MarketDataEvent md;
+    SimTime previous = simulator.exchange_time();
+    int fill_qty = 0;
+    int signed_qty = 0;
+    for (int i = 0; i < config.iterations; ++i) {
+        simulator.generate_event(md);
+        const SimTime advanced = simulator.exchange_time() - previous;
+        assert(advanced >= tick && advanced % tick == 0);
+        assert(simulator.mm_receive_time() == to_sim_time(md.timestamp) + 10 * kMs);
+        previous = simulator.exchange_time();
+        for (const auto& fill : md.mm_fills) {
+            fill_qty += fill.fill_qty;
+            signed_qty += fill.side == Side::BUY ? fill.fill_qty : -fill.fill_qty;
+        }
+        mm.on_market_data(md, simulator);
+    }
+    std::cout.clear();
+
+    assert(fill_qty > 0);
+    assert(mm.get_inventory() == signed_qty);
+
+    std::cout << "PASS: test_latency_is_simulated_time (fills=" << mm.get_total_fills() << ")\n";
+}
+
+// 6. Each distribution stays in range, and specs parse to the same models
+void test_latency_distributions() {
+    std::mt19937_64 rng(7);
+    const int n = 20000;
+
+    LatencySampler uniform(parse_latency_model("uniform:5us:15us"));
+    int64_t lo = std::numeric_limits<int64_t>::max(), hi = 0;
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        int64_t v = uniform.sample(rng);
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+        sum += static_cast<double>(v);
+    }
+    assert(lo >= 5000 && hi <= 15000);
+    assert(sum / n > 9500.0 && sum / n < 10500.0);
+
+    // Half of a lognormal's mass lies below its median
+    LatencySampler lognormal(parse_latency_model("lognormal:20us:0.5"));
+    int below = 0;
+    for (int i = 0; i < n; ++i) {
+        int64_t v = lognormal.sample(rng);
+        assert(v > 0);
+        below += v < 20000 ? 1 : 0;
+    }
+    assert(below > n * 45 / 100 && below < n * 55 / 100);
+
+    LatencySampler empirical(parse_latency_model("empirical:0us-10us=0.9,100us-200us=0.1"));
+    int slow = 0;
+    for (int i = 0; i < n; ++i) {
+        int64_t v = empirical.sample(rng);
+        assert((v >= 0 && v < 10000) || (v >= 100000 && v < 200000));
+        slow += v >= 100000 ? 1 : 0;
+    }
+    assert(slow > n * 8 / 100 && slow < n * 12 / 100);
+
+    LatencySampler constant(parse_latency_model("2ms"));
+    assert(constant.sample(rng) == 2000000);
+    assert(parse_latency_model("const:250").value_ns == 250);
+    assert(LatencySampler().is_zero());
+
+    for (const char* bad : {"uniform:10us:5us", "lognormal:0us:0.5", "fast", "empirical:1us=1", "const:-1us"}) {
+        bool threw = false;
+        try {
+            parse_latency_model(bad);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    std::cout << "PASS: test_latency_distributions\n";
+}
+
+// 7. Sampled latencies are seeded, the feed stays in order, and a slow cancel
+// path leaves more time for trades to hit the order first
+void test_sampled_paths_deterministic_and_ordered() {
+    auto run = [](const LatencyModel& cancel, int64_t& filled) {
+        SimulationConfig config = make_config(0, 0, 0);
+        config.feed_latency = parse_latency_model("uniform:0us:3ms");
+        config.order_latency = parse_latency_model("lognormal:500us:1.0");
+        config.cancel_latency = cancel;
+        config.ack_latency = parse_latency_model("empirical:0us-100us=0.8,1ms-5ms=0.2");
+        MarketSimulator simulator(config);
+        MarketDataEvent md;
+        uint64_t checksum = 0;
+        SimTime last_receive = 0;
+        filled = 0;
+        for (int i = 0; i < 3000; ++i) {
+            simulator.generate_event(md);
+            assert(simulator.mm_receive_time() >= last_receive);
+            last_receive = simulator.mm_receive_time();
+            for (const auto& fill : md.mm_fills) {
+                filled += fill.fill_qty;
+            }
+            // Rest a crossing bid, then cancel it a few events later
+            const uint64_t id = 1ULL << 48 | static_cast<uint64_t>(i / 10 + 1);
+            if (i % 10 == 0) {
+                simulator.submit_order(Order(id, Side::BUY, to_ticks(200.0), 5, md.timestamp));
+            } else if (i % 10 == 5) {
+                simulator.cancel_order(id);
+            }
+            checksum = checksum * 31 + static_cast<uint64_t>(last_receive);
+        }
+        return checksum;
+    };
+
+    int64_t fast_fills = 0, fast_again = 0, slow_fills = 0;
+    const uint64_t fast = run(LatencyModel::constant(0), fast_fills);
+    assert(run(LatencyModel::constant(0), fast_again) == fast && fast_again == fast_fills);
+    run(parse_latency_model("const:20ms"), slow_fills);
+    assert(slow_fills > fast_fills);
+
+    std::cout << "PASS: test_sampled_paths_deterministic_and_ordered (fast=" << fast_fills
+              << " slow=" << slow_fills << ")\n";
+}
+
+} // namespace
+
+int main() {
+    test_scheduler_ordering();
+    test_order_pending_until_arrival();
+    test_stale_order_picked_off_before_cancel();
+    test_fill_reports_delayed();
+    test_latency_is_simulated_time();
+    test_latency_distributions();
+    test_sampled_paths_deterministic_and_ordered();
+
+    std::cout << "\nAll latency tests passed.\n";
+    return 0;
+}
@@ -1,9 +1,11 @@
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <random>
 #include <vector>
 #include "MatchingEngine.h"
 #include "Order.h"
+#include "include/LevelBitmap.h"
 
 namespace {
 
@@ -15,15 +17,15 @@ auto make_ts(int ms) {
 void test_price_priority() {
     MatchingEngine engine;
 
-    engine.add_order(Order(1, Side::BUY, 100.0, 5, make_ts(1)));
-    engine.add_order(Order(2, Side::BUY, 101.0, 5, make_ts(2)));
-    engine.add_order(Order(3, Side::BUY, 99.0, 5, make_ts(3)));
+    engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 5, make_ts(1)));
+    engine.add_order(Order(2, Side::BUY, to_ticks(101.0), 5, make_ts(2)));
+    engine.add_order(Order(3, Side::BUY, to_ticks(99.0), 5, make_ts(3)));
 
-    auto fills = engine.match_incoming_order(Side::SELL, 99.0, 3, 100, make_ts(10));
+    auto fills = engine.match_incoming_order(Side::SELL, to_ticks(99.0), 3, 100, make_ts(10));
     assert(fills.size() == 1);
     assert(fills[0].order_id == 2); // highest bid at 101
     assert(fills[0].fill_qty == 3);
-    assert(fills[0].price == 101.0);
+    assert(fills[0].price == to_ticks(101.0));
 
     std::cout << "PASS: test_price_priority\n";
 }
@@ -32,10 +34,10 @@ void test_price_priority() {
 void test_time_priority() {
     MatchingEngine engine;
 
-    engine.add_order(Order(1, Side::BUY, 100.0, 5, make_ts(1)));
-    engine.add_order(Order(2, Side::BUY, 100.0, 5, make_ts(2)));
+    engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 5, make_ts(1)));
+    engine.add_order(Order(2, Side::BUY, to_ticks(100.0), 5, make_ts(2)));
 
-    auto fills = engine.match_incoming_order(Side::SELL, 100.0, 3, 100, make_ts(10));
+    auto fills = engine.match_incoming_order(Side::SELL, to_ticks(100.0), 3, 100, make_ts(10));
     assert(fills.size() == 1);
     assert(fills[0].order_id == 1); // earlier order
     assert(fills[0].fill_qty == 3);
@@ -47,9 +49,9 @@ void test_time_priority() {
 void test_partial_fill() {
     MatchingEngine engine;
 
-    engine.add_order(Order(1, Side::BUY, 100.0, 10, make_ts(1)));
+    engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 10, make_ts(1)));
 
-    auto fills = engine.match_incoming_order(Side::SELL, 100.0, 3, 100, make_ts(10));
+    auto fills = engine.match_incoming_order(Side::SELL, to_ticks(100.0), 3, 100, make_ts(10));
     assert(fills.size() == 1);
     assert(fills[0].order_id == 1);
     assert(fills[0].fill_qty == 3);
@@ -67,9 +69,9 @@ void test_partial_fill() {
 void test_full_fill() {
     MatchingEngine engine;
 
-    engine.add_order(Order(1, Side::BUY, 100.0, 5, make_ts(1)));
+    engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 5, make_ts(1)));
 
-    auto fills = engine.match_incoming_order(Side::SELL, 100.0, 5, 100, make_ts(10));
+    auto fills = engine.match_incoming_order(Side::SELL, to_ticks(100.0), 5, 100, make_ts(10));
     assert(fills.size() == 1);
     assert(fills[0].order_id == 1);
     assert(fills[0].fill_qty == 5);
@@ -85,12 +87,12 @@ void test_full_fill() {
 void test_multi_level_sweep() {
     MatchingEngine engine;
 
-    engine.add_order(Order(1, Side::BUY, 101.0, 3, make_ts(1)));
-    engine.add_order(Order(2, Side::BUY, 100.0, 3, make_ts(2)));
-    engine.add_order(Order(3, Side::BUY, 99.0, 3, make_ts(3)));
+    engine.add_order(Order(1, Side::BUY, to_ticks(101.0), 3, make_ts(1)));
+    engine.add_order(Order(2, Side::BUY, to_ticks(100.0), 3, make_ts(2)));
+    engine.add_order(Order(3, Side::BUY, to_ticks(99.0), 3, make_ts(3)));
 
     // Sell 7 @ 99 -> fills B1(3) + B2(3) + B3(1)
-    auto fills = engine.match_incoming_order(Side::SELL, 99.0, 7, 100, make_ts(10));
+    auto fills = engine.match_incoming_order(Side::SELL, to_ticks(99.0), 7, 100, make_ts(10));
     assert(fills.size() == 3);
     assert(fills[0].order_id == 1);
     assert(fills[0].fill_qty == 3);
@@ -112,7 +114,7 @@ void test_multi_level_sweep() {
 void test_cancel() {
     MatchingEngine engine;
 
-    engine.add_order(Order(1, Side::BUY, 100.0, 5, make_ts(1)));
+    engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 5, make_ts(1)));
     assert(engine.get_bids().size() == 1);
 
     bool cancelled = engine.cancel_order(1);
@@ -130,15 +132,15 @@ void test_cancel() {
 void test_ask_sorting() {
     MatchingEngine engine;
 
-    engine.add_order(Order(3, Side::SELL, 103.0, 5, make_ts(3)));
-    engine.add_order(Order(1, Side::SELL, 101.0, 5, make_ts(1)));
-    engine.add_order(Order(2, Side::SELL, 102.0, 5, make_ts(2)));
+    engine.add_order(Order(3, Side::SELL, to_ticks(103.0), 5, make_ts(3)));
+    engine.add_order(Order(1, Side::SELL, to_ticks(101.0), 5, make_ts(1)));
+    engine.add_order(Order(2, Side::SELL, to_ticks(102.0), 5, make_ts(2)));
 
     const auto& asks = engine.get_asks();
     assert(asks.size() == 3);
-    assert(asks[0].price == 101.0);
-    assert(asks[1].price == 102.0);
-    assert(asks[2].price == 103.0);
+    assert(asks[0].price == to_ticks(101.0));
+    assert(asks[1].price == to_ticks(102.0));
+    assert(asks[2].price == to_ticks(103.0));
 
     std::cout << "PASS: test_ask_sorting\n";
 }
@@ -147,15 +149,15 @@ void test_ask_sorting() {
 void test_bid_sorting() {
     MatchingEngine engine;
 
-    engine.add_order(Order(1, Side::BUY, 99.0, 5, make_ts(1)));
-    engine.add_order(Order(3, Side::BUY, 101.0, 5, make_ts(3)));
-    engine.add_order(Order(2, Side::BUY, 100.0, 5, make_ts(2)));
+    engine.add_order(Order(1, Side::BUY, to_ticks(99.0), 5, make_ts(1)));
+    engine.add_order(Order(3, Side::BUY, to_ticks(101.0), 5, make_ts(3)));
+    engine.add_order(Order(2, Side::BUY, to_ticks(100.0), 5, make_ts(2)));
 
     const auto& bids = engine.get_bids();
     assert(bids.size() == 3);
-    assert(bids[0].price == 101.0);
-    assert(bids[1].price == 100.0);
-    assert(bids[2].price == 99.0);
+    assert(bids[0].price == to_ticks(101.0));
+    assert(bids[1].price == to_ticks(100.0));
+    assert(bids[2].price == to_ticks(99.0));
 
     std::cout << "PASS: test_bid_sorting\n";
 }
@@ -164,12 +166,12 @@ void test_bid_sorting() {
 void test_no_fill_empty_book() {
     MatchingEngine engine;
 
-    auto fills = engine.match_incoming_order(Side::SELL, 100.0, 5, 100, make_ts(10));
+    auto fills = engine.match_incoming_order(Side::SELL, to_ticks(100.0), 5, 100, make_ts(10));
     assert(fills.empty());
 
     // Also test price mismatch
-    engine.add_order(Order(1, Side::BUY, 99.0, 5, make_ts(1)));
-    fills = engine.match_incoming_order(Side::SELL, 100.0, 5, 200, make_ts(20));
+    engine.add_order(Order(1, Side::BUY, to_ticks(99.0), 5, make_ts(1)));
+    fills = engine.match_incoming_order(Side::SELL, to_ticks(100.0), 5, 200, make_ts(20));
     assert(fills.empty()); // sell at 100 doesn't match bid at 99
 
     std::cout << "PASS: test_no_fill_empty_book\n";
@@ -179,11 +181,11 @@ void test_no_fill_empty_book() {
 void test_inventory_consistency() {
     MatchingEngine engine;
 
-    engine.add_order(Order(1, Side::BUY, 100.0, 10, make_ts(1)));
-    engine.add_order(Order(2, Side::SELL, 100.0, 10, make_ts(2)));
+    engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 10, make_ts(1)));
+    engine.add_order(Order(2, Side::SELL, to_ticks(100.0), 10, make_ts(2)));
 
-    auto buy_fills = engine.match_incoming_order(Side::SELL, 100.0, 10, 100, make_ts(10));
-    auto sell_fills = engine.match_incoming_order(Side::BUY, 100.0, 10, 200, make_ts(20));
+    auto buy_fills = engine.match_incoming_order(Side::SELL, to_ticks(100.0), 10, 100, make_ts(10));
+    auto sell_fills = engine.match_incoming_order(Side::BUY, to_ticks(100.0), 10, 200, make_ts(20));
 
     int net = 0;
     for (const auto& f : buy_fills) {
@@ -199,6 +201,385 @@ void test_inventory_consistency() {
     std::cout << "PASS: test_inventory_consistency\n";
 }
 
+// 11. Cancel from the middle of a price level keeps FIFO order of the rest
+void test_cancel_preserves_fifo() {
+    MatchingEngine engine;
+
+    engine.add_order(Order(1, Side::SELL, to_ticks(101.0), 2, make_ts(1)));
+    engine.add_order(Order(2, Side::SELL, to_ticks(101.0), 2, make_ts(2)));
+    engine.add_order(Order(3, Side::SELL, to_ticks(101.0), 2, make_ts(3)));
+    assert(engine.ask_level_count() == 1);
+
+    bool cancelled = engine.cancel_order(2);
+    assert(cancelled);
+    assert(engine.resting_order_count() == 2);
+
+    auto fills = engine.match_incoming_order(Side::BUY, to_ticks(101.0), 4, 100, make_ts(10));
+    assert(fills.size() == 2);
+    assert(fills[0].order_id == 1);
+    assert(fills[1].order_id == 3);
+    assert(engine.get_asks().empty());
+    assert(engine.ask_level_count() == 0);
+
+    std::cout << "PASS: test_cancel_preserves_fifo\n";
+}
+
+// 12. Duplicate order id is rejected while the original rests
+void test_duplicate_order_id_rejected() {
+    MatchingEngine engine;
+
+    OrderStatus original = engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 5, make_ts(1)));
+    assert(original == OrderStatus::ACKNOWLEDGED);
+    OrderStatus duplicate = engine.add_order(Order(1, Side::BUY, to_ticks(99.0), 5, make_ts(2)));
+    assert(duplicate == OrderStatus::REJECTED);
+    assert(engine.resting_order_count() == 1);
+
+    // Once the original is gone the id may be reused
+    bool cancelled = engine.cancel_order(1);
+    assert(cancelled);
+    OrderStatus reused = engine.add_order(Order(1, Side::BUY, to_ticks(99.0), 5, make_ts(3)));
+    assert(reused == OrderStatus::ACKNOWLEDGED);
+    assert(engine.get_bids()[0].price == to_ticks(99.0));
+
+    std::cout << "PASS: test_duplicate_order_id_rejected\n";
+}
+
+// 13. Buffer and callback sinks see the same fills as the returning overload
+void test_fill_sinks_match_returned_fills() {
+    MatchingEngine engine;
+    engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 3, make_ts(1)));
+    engine.add_order(Order(2, Side::BUY, to_ticks(100.0), 4, make_ts(2)));
+    engine.add_order(Order(3, Side::BUY, to_ticks(99.0), 5, make_ts(3)));
+
+    // Buffer overload appends after existing contents
+    std::vector<FillEvent> buffer;
+    buffer.push_back(FillEvent{99, 0, Side::SELL, kNoInstrument, to_ticks(1.0), 1, 0, make_ts(0)});
+    std::size_t appended = engine.match_incoming_order(Side::SELL, to_ticks(100.0), 5, 7, make_ts(10), buffer);
+    assert(appended == 2);
+    assert(buffer.size() == 3);
+    assert(buffer[0].order_id == 99);
+    assert(buffer[1].order_id == 1 && buffer[1].fill_qty == 3 && buffer[1].leaves_qty == 0);
+    assert(buffer[2].order_id == 2 && buffer[2].fill_qty == 2 && buffer[2].leaves_qty == 2);
+    assert(buffer[2].trade_id == 7);
+
+    // Callback sees fills in priority order across levels
+    std::vector<uint64_t> ids;
+    engine.match_incoming_order_with(Side::SELL, to_ticks(99.0), 10, 8, make_ts(11),
+                                     [&ids](const FillEvent& f) { ids.push_back(f.order_id); });
+    assert((ids == std::vector<uint64_t>{2, 3}));
+    assert(engine.resting_order_count() == 0);
+
+    std::cout << "PASS: test_fill_sinks_match_returned_fills\n";
+}
+
+// 14. Replace with a smaller size at the same price keeps queue priority
+void test_replace_size_down_keeps_priority() {
+    MatchingEngine engine;
+    engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 10, make_ts(1)));
+    engine.add_order(Order(2, Side::BUY, to_ticks(100.0), 10, make_ts(2)));
+
+    OrderStatus replaced = engine.replace_order(1, to_ticks(100.0), 4);
+    assert(replaced == OrderStatus::ACKNOWLEDGED);
+    auto bids = engine.get_bids();
+    assert(bids[0].order_id == 1 && bids[0].leaves_qty == 4);
+
+    auto fills = engine.match_incoming_order(Side::SELL, to_ticks(100.0), 6, 1, make_ts(10));
+    assert(fills.size() == 2);
+    assert(fills[0].order_id == 1 && fills[0].fill_qty == 4 && fills[0].leaves_qty == 0);
+    assert(fills[1].order_id == 2 && fills[1].fill_qty == 2);
+
+    std::cout << "PASS: test_replace_size_down_keeps_priority\n";
+}
+
+// 15. Replace with a size increase or a new price loses priority
+void test_replace_requeues_on_increase_or_move() {
+    MatchingEngine engine;
+    engine.add_order(Order(1, Side::SELL, to_ticks(101.0), 5, make_ts(1)));
+    engine.add_order(Order(2, Side::SELL, to_ticks(101.0), 5, make_ts(2)));
+    engine.add_order(Order(3, Side::SELL, to_ticks(102.0), 5, make_ts(3)));
+
+    // Size up at the same price: moves behind order 2
+    OrderStatus replaced = engine.replace_order(1, to_ticks(101.0), 8);
+    assert(replaced == OrderStatus::ACKNOWLEDGED);
+    auto asks = engine.get_asks();
+    assert(asks[0].order_id == 2);
+    assert(asks[1].order_id == 1 && asks[1].leaves_qty == 8);
+
+    // Price move: leaves its old level and joins the tail of the new one
+    replaced = engine.replace_order(2, to_ticks(102.0), 5);
+    assert(replaced == OrderStatus::ACKNOWLEDGED);
+    asks = engine.get_asks();
+    assert(engine.ask_level_count() == 2);
+    assert(asks[0].order_id == 1);
+    assert(asks[1].order_id == 3);
+    assert(asks[2].order_id == 2 && asks[2].price == to_ticks(102.0));
+
+    // Emptying a level by moving its only order removes the level
+    replaced = engine.replace_order(1, to_ticks(103.0), 8);
+    assert(replaced == OrderStatus::ACKNOWLEDGED);
+    assert(engine.ask_level_count() == 2);
+    assert(engine.resting_order_count() == 3);
+
+    std::cout << "PASS: test_replace_requeues_on_increase_or_move\n";
+}
+
+// 16. Replace of unknown orders or with invalid values is rejected
+void test_replace_rejects_invalid() {
+    MatchingEngine engine;
+    engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 5, make_ts(1)));
+
+    OrderStatus unknown = engine.replace_order(42, to_ticks(100.0), 5);
+    assert(unknown == OrderStatus::REJECTED);
+    OrderStatus zero_qty = engine.replace_order(1, to_ticks(100.0), 0);
+    assert(zero_qty == OrderStatus::REJECTED);
+    OrderStatus zero_price = engine.replace_order(1, 0, 5);
+    assert(zero_price == OrderStatus::REJECTED);
+
+    // Rejected replaces leave the order untouched
+    auto bids = engine.get_bids();
+    assert(bids.size() == 1 && bids[0].leaves_qty == 5 && bids[0].price == to_ticks(100.0));
+
+    // A partially filled order keeps its filled quantity in original_qty
+    engine.match_incoming_order(Side::SELL, to_ticks(100.0), 2, 1, make_ts(2));
+    OrderStatus replaced = engine.replace_order(1, to_ticks(100.0), 1);
+    assert(replaced == OrderStatus::ACKNOWLEDGED);
+    bids = engine.get_bids();
+    assert(bids[0].leaves_qty == 1 && bids[0].original_qty == 3);
+    assert(bids[0].status == OrderStatus::PARTIALLY_FILLED);
+
+    std::cout << "PASS: test_replace_rejects_invalid\n";
+}
+
+// 17. Bitmap next/prev searches cross word and summary boundaries
+void test_level_bitmap_search() {
+    LevelBitmap bits(10000);
+    assert(bits.find_first() == LevelBitmap::npos);
+    assert(bits.find_last() == LevelBitmap::npos);
+
+    bits.set(3);
+    bits.set(63);
+    bits.set(64);
+    bits.set(4095);
+    bits.set(4096);
+    bits.set(9999);
+    bits.set(64);  // idempotent
+    assert(bits.count() == 6);
+
+    assert(bits.find_first() == 3);
+    assert(bits.find_last() == 9999);
+    assert(bits.next_set(4) == 63);
+    assert(bits.next_set(65) == 4095);
+    assert(bits.next_set(4097) == 9999);
+    assert(bits.prev_set(9998) == 4096);
+    assert(bits.prev_set(4095) == 4095);
+    assert(bits.prev_set(62) == 3);
+    assert(bits.prev_set(2) == LevelBitmap::npos);
+
+    bits.reset(4095);
+    bits.reset(4096);
+    assert(bits.next_set(65) == 9999);
+    assert(bits.prev_set(9998) == 64);
+    assert(bits.count() == 4);
+
+    std::cout << "PASS: test_level_bitmap_search\n";
+}
+
+// 18. Ladder mode rejects prices outside the preallocated range
+void test_ladder_rejects_out_of_range() {
+    MatchingEngine engine(64, TickLadderConfig{to_ticks(100.0), 100});
+    assert(engine.uses_ladder());
+
+    OrderStatus low_edge = engine.add_order(Order(1, Side::BUY, to_ticks(100.0) - 100, 5, make_ts(1)));
+    assert(low_edge == OrderStatus::ACKNOWLEDGED);
+    OrderStatus high_edge = engine.add_order(Order(2, Side::SELL, to_ticks(100.0) + 100, 5, make_ts(1)));
+    assert(high_edge == OrderStatus::ACKNOWLEDGED);
+    OrderStatus below = engine.add_order(Order(3, Side::BUY, to_ticks(100.0) - 101, 5, make_ts(1)));
+    assert(below == OrderStatus::REJECTED);
+    OrderStatus above = engine.add_order(Order(4, Side::SELL, to_ticks(100.0) + 101, 5, make_ts(1)));
+    assert(above == OrderStatus::REJECTED);
+    OrderStatus moved_out = engine.replace_order(1, to_ticks(100.0) - 101, 5);
+    assert(moved_out == OrderStatus::REJECTED);
+    assert(engine.resting_order_count() == 2);
+
+    std::cout << "PASS: test_ladder_rejects_out_of_range\n";
+}
+
+// 19. Ladder and map books produce identical fills and books for the same flow
+void test_ladder_matches_map_book() {
+    const Price mid = to_ticks(100.0);
+    MatchingEngine map_book(256);
+    MatchingEngine ladder_book(256, TickLadderConfig{mid, 5000});
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> op_dist(0, 9);
+    std::uniform_int_distribution<int> offset_dist(1, 4000);
+    std::uniform_int_distribution<int> qty_dist(1, 20);
+    std::vector<uint64_t> live;
+    uint64_t next_id = 1;
+
+    for (int step = 0; step < 5000; ++step) {
+        int op = op_dist(rng);
+        if (op < 5 || live.empty()) {
+            Side side = (step % 2 == 0) ? Side::BUY : Side::SELL;
+            Price price = side == Side::BUY ? mid - offset_dist(rng) : mid + offset_dist(rng);
+            int qty = qty_dist(rng);
+            OrderStatus map_status = map_book.add_order(Order(next_id, side, price, qty, make_ts(step)));
+            OrderStatus ladder_status = ladder_book.add_order(Order(next_id, side, price, qty, make_ts(step)));
+            assert(map_status == ladder_status);
+            live.push_back(next_id++);
+        } else if (op < 7) {
+            std::size_t victim = static_cast<std::size_t>(rng() % live.size());
+            bool map_cancelled = map_book.cancel_order(live[victim]);
+            bool ladder_cancelled = ladder_book.cancel_order(live[victim]);
+            assert(map_cancelled == ladder_cancelled);
+            live[victim] = live.back();
+            live.pop_back();
+        } else if (op < 8) {
+            std::size_t victim = static_cast<std::size_t>(rng() % live.size());
+            Price price = mid - offset_dist(rng);
+            int qty = qty_dist(rng);
+            OrderStatus map_status = map_book.replace_order(live[victim], price, qty);
+            OrderStatus ladder_status = ladder_book.replace_order(live[victim], price, qty);
+            assert(map_status == ladder_status);
+        } else {
+            Side aggressor = (op == 8) ? Side::BUY : Side::SELL;
+            Price limit = aggressor == Side::BUY ? mid + offset_dist(rng) : mid - offset_dist(rng);
+            int qty = qty_dist(rng) * 5;
+            auto a = map_book.match_incoming_order(aggressor, limit, qty, static_cast<uint64_t>(step), make_ts(step));
+            auto b = ladder_book.match_incoming_order(aggressor, limit, qty, static_cast<uint64_t>(step), make_ts(step));
+            assert(a.size() == b.size());
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                assert(a[i].order_id == b[i].order_id);
+                assert(a[i].price == b[i].price);
+                assert(a[i].fill_qty == b[i].fill_qty);
+            }
+        }
+    }
+
+    auto same_orders = [](const std::vector<Order>& x, const std::vector<Order>& y) {
+        if (x.size() != y.size()) return false;
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            if (x[i].order_id != y[i].order_id || x[i].price != y[i].price ||
+                x[i].leaves_qty != y[i].leaves_qty) {
+                return false;
+            }
+        }
+        return true;
+    };
+    assert(same_orders(map_book.get_bids(), ladder_book.get_bids()));
+    assert(same_orders(map_book.get_asks(), ladder_book.get_asks()));
+    assert(map_book.bid_level_count() == ladder_book.bid_level_count());
+    assert(map_book.ask_level_count() == ladder_book.ask_level_count());
+    assert(map_book.resting_order_count() == ladder_book.resting_order_count());
+
+    std::cout << "PASS: test_ladder_matches_map_book\n";
+}
+
+// 20. Batch add: per-order statuses, price priority, FIFO within a price
+void test_batch_add_orders() {
+    for (bool ladder : {false, true}) {
+        MatchingEngine engine(64, TickLadderConfig{to_ticks(100.0), ladder ? 50000u : 0u});
+        engine.add_order(Order(1, Side::BUY, to_ticks(99.0), 5, make_ts(1)));
+
+        std::vector<Order> batch = {
+            Order(10, Side::BUY, to_ticks(98.0), 5, make_ts(2)),
+            Order(11, Side::SELL, to_ticks(102.0), 5, make_ts(2)),
+            Order(12, Side::BUY, to_ticks(99.0), 5, make_ts(2)),   // joins behind order 1
+            Order(1, Side::BUY, to_ticks(97.0), 5, make_ts(2)),    // duplicate of resting id
+            Order(13, Side::SELL, to_ticks(101.0), 5, make_ts(2)),
+            Order(14, Side::BUY, to_ticks(99.0), 0, make_ts(2)),   // invalid qty
+            Order(15, Side::BUY, to_ticks(99.0), 5, make_ts(2)),
+            Order(15, Side::SELL, to_ticks(103.0), 5, make_ts(2)), // duplicate inside the batch
+        };
+        std::vector<OrderStatus> statuses(batch.size(), OrderStatus::NEW);
+        std::size_t accepted = engine.add_orders(batch, statuses);
+        assert(accepted == 5);
+
+        const OrderStatus A = OrderStatus::ACKNOWLEDGED;
+        const OrderStatus R = OrderStatus::REJECTED;
+        assert((statuses == std::vector<OrderStatus>{A, A, A, R, A, R, A, R}));
+
+        auto bids = engine.get_bids();
+        assert(bids.size() == 4);
+        assert(bids[0].order_id == 1 && bids[1].order_id == 12 && bids[2].order_id == 15);
+        assert(bids[3].order_id == 10);
+        assert(bids[1].status == OrderStatus::ACKNOWLEDGED);
+        auto asks = engine.get_asks();
+        assert(asks.size() == 2 && asks[0].order_id == 13 && asks[1].order_id == 11);
+        assert(engine.bid_level_count() == 2 && engine.ask_level_count() == 2);
+    }
+
+    std::cout << "PASS: test_batch_add_orders\n";
+}
+
+// 21. Batch cancel reports CANCELED or REJECTED per id
+void test_batch_cancel_orders() {
+    MatchingEngine engine;
+    engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 5, make_ts(1)));
+    engine.add_order(Order(2, Side::SELL, to_ticks(101.0), 5, make_ts(1)));
+
+    const uint64_t ids[] = {2, 99, 1, 2};
+    OrderStatus statuses[4];
+    std::size_t cancelled = engine.cancel_orders(ids, statuses);
+    assert(cancelled == 2);
+    assert(statuses[0] == OrderStatus::CANCELED);
+    assert(statuses[1] == OrderStatus::REJECTED);
+    assert(statuses[2] == OrderStatus::CANCELED);
+    assert(statuses[3] == OrderStatus::REJECTED);
+    assert(engine.resting_order_count() == 0);
+    assert(engine.bid_level_count() == 0 && engine.ask_level_count() == 0);
+
+    std::cout << "PASS: test_batch_cancel_orders\n";
+}
+
+// 22. Interned ids are stable, and fills carry the resting order's instrument
+void test_fills_carry_instrument_id() {
+    auto& registry = InstrumentRegistry::global();
+    InstrumentId abc = registry.intern("ENG_ABC");
+    InstrumentId xyz = registry.intern("ENG_XYZ");
+    assert(abc != kNoInstrument && xyz != kNoInstrument && abc != xyz);
+    assert(registry.intern("ENG_ABC") == abc);
+    assert(registry.find("ENG_ABC") == abc);
+    assert(registry.find("ENG_MISSING") == kNoInstrument);
+    assert(registry.name(xyz) == "ENG_XYZ");
+    assert(registry.name(kNoInstrument).empty());
+
+    MatchingEngine engine;
+    Order order(1, Side::SELL, to_ticks(100.0), 5, make_ts(0));
+    order.instrument_id = abc;
+    engine.add_order(order);
+    auto fills = engine.match_incoming_order(Side::BUY, to_ticks(100.0), 2, 7, make_ts(1));
+    assert(fills.size() == 1);
+    assert(fills[0].instrument_id == abc);
+    assert(registry.name(fills[0].instrument_id) == "ENG_ABC");
+
+    std::cout << "PASS: test_fills_carry_instrument_id\n";
+}
+
+// 23. Within a price, orders queue in arrival order, not by created_at
+void test_fifo_ignores_created_at() {
+    for (bool ladder : {false, true}) {
+        MatchingEngine engine(64, TickLadderConfig{to_ticks(100.0), ladder ? 50000u : 0u});
+        engine.add_order(Order(1, Side::BUY, to_ticks(100.0), 5, make_ts(20)));
+        engine.add_order(Order(2, Side::BUY, to_ticks(100.0), 5, make_ts(10)));
+
+        const std::vector<Order> batch = {Order(3, Side::BUY, to_ticks(100.0), 5, make_ts(5))};
+        std::vector<OrderStatus> statuses(batch.size());
+        engine.add_orders(batch, statuses);
+
+        auto bids = engine.get_bids();
+        assert(bids.size() == 3);
+        assert(bids[0].order_id == 1 && bids[1].order_id == 2 && bids[2].order_id == 3);
+
+        auto fills = engine.match_incoming_order(Side::SELL, to_ticks(100.0), 7, 1, make_ts(30));
+        assert(fills.size() == 2);
+        assert(fills[0].order_id == 1 && fills[0].fill_qty == 5);
+        assert(fills[1].order_id == 2 && fills[1].fill_qty == 2);
+    }
+
+    std::cout << "PASS: test_fifo_ignores_created_at\n";
+}
+
 } // namespace
 
 int main() {
@@ -212,6 +593,19 @@ int main() {
     test_bid_sorting();
     test_no_fill_empty_book();
     test_inventory_consistency();
+    test_cancel_preserves_fifo();
+    test_duplicate_order_id_rejected();
+    test_fill_sinks_match_returned_fills();
+    test_replace_size_down_keeps_priority();
+    test_replace_requeues_on_increase_or_move();
+    test_replace_rejects_invalid();
+    test_level_bitmap_search();
+    test_ladder_rejects_out_of_range();
+    test_ladder_matches_map_book();
+    test_batch_add_orders();
+    test_batch_cancel_orders();
+    test_fills_carry_instrument_id();
+    test_fifo_ignores_created_at();
 
     std::cout << "\nAll matching engine tests passed.\n";
     return 0;
@@ -0,0 +1,213 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "MarketSimulator.h"
+#include "include/Philox.h"
+#include "include/RandomBatch.h"
+#include "include/SimulationConfig.h"
+
+namespace {
+
+// 1. Philox4x32-10 matches the Random123 known-answer vectors
+void test_known_answers() {
+    using C = Philox4x32::Counter;
+    using K = Philox4x32::Key;
+    assert((Philox4x32::block(C{0, 0, 0, 0}, K{0, 0}) == C{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    assert((Philox4x32::block(C{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, K{0xffffffff, 0xffffffff}) ==
+            C{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    assert((Philox4x32::block(C{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, K{0xa4093822, 0x299f31d0}) ==
+            C{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+
+    // The stream hands out the block's words in order, then moves to the next block
+    PhiloxStream stream(0, 0, 0);
+    assert(stream() == 0x6627e8d5 && stream() == 0xe169c58d && stream() == 0xbc57ac4c && stream() == 0x9b00dbd8);
+    assert(stream() == Philox4x32::block(C{0, 0, 0, 1}, K{0, 0})[0]);
+
+    std::cout << "PASS: test_known_answers\n";
+}
+
+// 2. A substream is a pure function of (key, stream, index): resetting
+// replays it, and neighbouring streams, indices and keys differ
+void test_substreams_addressable() {
+    const uint64_t key = PhiloxStream::make_key(42, 7);
+    PhiloxStream a(key, 2, 1000);
+    std::vector<uint32_t> first;
+    for (int i = 0; i < 10; ++i) {
+        first.push_back(a());
+    }
+
+    // Draw from elsewhere, then come back
+    a.reset(3, 1000);
+    a();
+    a.reset(2, 1000);
+    for (uint32_t v : first) {
+        assert(a() == v);
+    }
+
+    PhiloxStream other_stream(key, 3, 1000);
+    PhiloxStream other_index(key, 2, 1001);
+    PhiloxStream other_instrument(PhiloxStream::make_key(42, 8), 2, 1000);
+    PhiloxStream other_seed(PhiloxStream::make_key(43, 7), 2, 1000);
+    assert(other_stream() != first[0]);
+    assert(other_index() != first[0]);
+    assert(other_instrument() != first[0]);
+    assert(other_seed() != first[0]);
+
+    // Indices above 2^32 use the high counter word
+    PhiloxStream low(key, 2, 5);
+    PhiloxStream high(key, 2, (1ULL << 32) | 5);
+    assert(low() != high());
+
+    std::cout << "PASS: test_substreams_addressable\n";
+}
+
+// 3. Per-event draws generated by any number of workers, each taking a
+// strided share of events, are bit-identical to one sequential pass
+void test_parallel_generation_matches_sequential() {
+    const uint64_t key = PhiloxStream::make_key(42, 1);
+    const std::size_t events = 20000;
+    const int draws_per_event = 12;
+
+    auto fill_event = [&](std::vector<double>& out, std::size_t event) {
+        PhiloxStream rng(key, 1, event);
+        std::normal_distribution<> noise(0.0, 1.0);
+        std::uniform_int_distribution<> size(-2, 2);
+        for (int d = 0; d < draws_per_event; ++d) {
+            out[event * draws_per_event + d] = d % 2 == 0 ? noise(rng) : static_cast<double>(size(rng));
+        }
+    };
+
+    std::vector<double> sequential(events * draws_per_event);
+    for (std::size_t e = 0; e < events; ++e) {
+        fill_event(sequential, e);
+    }
+
+    for (int threads : {2, 3, 8}) {
+        std::vector<double> parallel(events * draws_per_event);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (std::size_t e = static_cast<std::size_t>(t); e < events; e += static_cast<std::size_t>(threads)) {
+                    fill_event(parallel, e);
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        assert(parallel == sequential);
+    }
+
+    std::cout << "PASS: test_parallel_generation_matches_sequential\n";
+}
+
+// 4. Simulators are reproducible per (seed, instrument), and two instruments
+// sharing a seed follow different paths
+void test_simulator_streams() {
+    auto mids = [](const std::string& symbol, uint32_t seed) {
+        SimulationConfig config;
+        config.instrument = symbol;
+        config.seed = seed;
+        config.latency_ms = 0;
+        config.quiet = true;
+        config.ack_latency = LatencyModel::uniform(0, 1000000);
+        MarketSimulator simulator(config);
+        MarketDataEvent md;
+        std::vector<int64_t> out;
+        for (int i = 0; i < 2000; ++i) {
+            simulator.generate_event(md);
+            out.push_back(md.best_bid_price + md.best_ask_price);
+            out.push_back(static_cast<int64_t>(md.trades.size()));
+            out.push_back(simulator.mm_receive_time());
+        }
+        return out;
+    };
+
+    const auto a = mids("SIM", 42);
+    assert(mids("SIM", 42) == a);
+    assert(mids("SIM2", 42) != a);
+    assert(mids("SIM", 43) != a);
+
+    std::cout << "PASS: test_simulator_streams\n";
+}
+
+// 5. Block draws are word-for-word the PhiloxStream sequence, for every
+// length including partial blocks and multiple vector passes
+void test_batch_matches_stream() {
+    const uint64_t key = PhiloxStream::make_key(42, 3);
+    for (std::size_t n : {1, 2, 3, 4, 5, 7, 40, 127, 128, 129, 1000}) {
+        std::vector<uint32_t> batch(n + 1, 0xDEADBEEF);
+        random_batch::fill_bits(key, 2, 77, batch.data(), n);
+        PhiloxStream stream(key, 2, 77);
+        for (std::size_t i = 0; i < n; ++i) {
+            assert(batch[i] == stream());
+        }
+        assert(batch[n] == 0xDEADBEEF);  // nothing written past n
+    }
+
+    RandomBatch rb(key);
+    rb.draw(2, 77, 10);
+    PhiloxStream stream(key, 2, 77);
+    for (std::size_t i = 0; i < rb.size(); ++i) {
+        assert(rb.bits()[i] == stream());
+    }
+
+    std::cout << "PASS: test_batch_matches_stream\n";
+}
+
+// 6. Converted variates stay in range with the expected moments
+void test_batch_distributions() {
+    const std::size_t n = 200000;
+    RandomBatch rb(PhiloxStream::make_key(7, 0));
+    rb.draw(0, 0, n);
+
+    const double* u = rb.uniforms(0, n, -0.001, 0.001);
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(u[i] > -0.001 && u[i] < 0.001);
+        sum += u[i];
+    }
+    assert(std::fabs(sum / n) < 0.00002);
+
+    const int* k = rb.ints(0, n, -2, 2);
+    std::vector<int> counts(5, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(k[i] >= -2 && k[i] <= 2);
+        ++counts[static_cast<std::size_t>(k[i] + 2)];
+    }
+    for (int c : counts) {
+        assert(std::abs(c - static_cast<int>(n / 5)) < static_cast<int>(n / 100));
+    }
+
+    const double* z = rb.normals(0, n, 1.0, 2.0);
+    double mean = 0.0, sq = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(std::isfinite(z[i]));
+        mean += z[i];
+        sq += z[i] * z[i];
+    }
+    mean /= n;
+    const double var = sq / n - mean * mean;
+    assert(std::fabs(mean - 1.0) < 0.03);
+    assert(std::fabs(var - 4.0) < 0.1);
+
+    std::cout << "PASS: test_batch_distributions\n";
+}
+
+} // namespace
+
+int main() {
+    test_known_answers();
+    test_substreams_addressable();
+    test_parallel_generation_matches_sequential();
+    test_simulator_streams();
+    test_batch_matches_stream();
+    test_batch_distributions();
+
+    std::cout << "\nAll Philox tests passed.\n";
+    return 0;
+}
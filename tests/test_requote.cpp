@@ -0,0 +1,180 @@
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include "MarketMaker.h"
+#include "MarketSimulator.h"
+#include "include/HeuristicStrategy.h"
+#include "include/RequotePolicy.h"
+#include "include/SimulationConfig.h"
+
+namespace {
+
+auto make_ts(int ms) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
+}
+
+Order live_order(Price price, int qty, int placed_ms) {
+    return Order(1, Side::BUY, price, qty, make_ts(placed_ms));
+}
+
+// 1. No live order -> New
+void test_no_live_order_sends_new() {
+    RequoteConfig cfg;
+    assert(decide_requote(nullptr, to_ticks(100.0), 10, make_ts(0), cfg) == RequoteAction::New);
+    std::cout << "PASS: test_no_live_order_sends_new\n";
+}
+
+// 2. Unchanged quote -> None
+void test_unchanged_quote_sends_nothing() {
+    RequoteConfig cfg;
+    Order live = live_order(to_ticks(100.0), 10, 0);
+    assert(decide_requote(&live, to_ticks(100.0), 10, make_ts(5), cfg) == RequoteAction::None);
+    std::cout << "PASS: test_unchanged_quote_sends_nothing\n";
+}
+
+// 3. Changes inside tolerance -> None; outside -> Amend
+void test_tolerances() {
+    RequoteConfig cfg;
+    cfg.price_tolerance_ticks = 2;
+    cfg.size_tolerance = 3;
+    Order live = live_order(to_ticks(100.0), 10, 0);
+
+    assert(decide_requote(&live, to_ticks(100.0) + 2, 13, make_ts(5), cfg) == RequoteAction::None);
+    assert(decide_requote(&live, to_ticks(100.0) - 2, 7, make_ts(5), cfg) == RequoteAction::None);
+    assert(decide_requote(&live, to_ticks(100.0) + 3, 10, make_ts(5), cfg) == RequoteAction::Amend);
+    assert(decide_requote(&live, to_ticks(100.0), 14, make_ts(5), cfg) == RequoteAction::Amend);
+    std::cout << "PASS: test_tolerances\n";
+}
+
+// 4. Quotes younger than the minimum lifetime are not touched
+void test_min_quote_lifetime() {
+    RequoteConfig cfg;
+    cfg.min_quote_lifetime_ms = 50.0;
+    Order live = live_order(to_ticks(100.0), 10, 100);
+
+    assert(decide_requote(&live, to_ticks(101.0), 10, make_ts(149), cfg) == RequoteAction::None);
+    assert(decide_requote(&live, to_ticks(101.0), 10, make_ts(150), cfg) == RequoteAction::Amend);
+
+    // Lifetime restarts when the quote is amended
+    live.updated_at = make_ts(150);
+    assert(decide_requote(&live, to_ticks(102.0), 10, make_ts(160), cfg) == RequoteAction::None);
+    std::cout << "PASS: test_min_quote_lifetime\n";
+}
+
+// 5. Amend disabled -> CancelNew
+void test_amend_disabled() {
+    RequoteConfig cfg;
+    cfg.allow_amend = false;
+    Order live = live_order(to_ticks(100.0), 10, 0);
+    assert(decide_requote(&live, to_ticks(100.5), 10, make_ts(5), cfg) == RequoteAction::CancelNew);
+    assert(decide_requote(&live, to_ticks(100.0), 10, make_ts(5), cfg) == RequoteAction::None);
+    std::cout << "PASS: test_amend_disabled\n";
+}
+
+struct RunResult {
+    int64_t messages;
+    int64_t baseline;
+};
+
+RunResult run_market_maker(const RequoteConfig& requote_cfg, int events) {
+    SimulationConfig config;
+    config.seed = 7;
+    config.latency_ms = 0;
+    config.quiet = true;
+
+    RiskConfig risk_cfg;
+    risk_cfg.max_net_position = 1000000;
+    risk_cfg.max_notional_exposure = 1e12;
+    risk_cfg.max_drawdown = 1e12;
+
+    MarketSimulator simulator(config);
+    MarketMaker mm(risk_cfg, std::make_unique<HeuristicStrategy>(), requote_cfg);
+
+    std::cout.setstate(std::ios::failbit);
+    for (int i = 0; i < events; ++i) {
+        MarketDataEvent md = simulator.generate_event();
+        mm.on_market_data(md, simulator);
+    }
+    std::cout.clear();
+
+    assert(simulator.get_matching_engine().resting_order_count() <= 2);
+    return {mm.get_order_messages(), mm.get_baseline_order_messages()};
+}
+
+// 6. Diffing sends fewer messages than cancel-all; looser tolerances send fewer still
+void test_market_maker_message_reduction() {
+    const int events = 2000;
+
+    RequoteConfig no_amend;
+    no_amend.allow_amend = false;
+    RunResult cancel_new = run_market_maker(no_amend, events);
+
+    RequoteConfig exact;
+    RunResult amend = run_market_maker(exact, events);
+
+    RequoteConfig loose;
+    loose.price_tolerance_ticks = 50;
+    loose.size_tolerance = 5;
+    RunResult tolerant = run_market_maker(loose, events);
+
+    // Cancel-all would send at least two new orders per event
+    assert(amend.baseline >= 2 * events);
+    assert(cancel_new.messages <= cancel_new.baseline);
+    assert(amend.messages < cancel_new.messages);
+    assert(amend.messages < amend.baseline);
+    assert(tolerant.messages < amend.messages);
+
+    std::cout << "PASS: test_market_maker_message_reduction (cancel+new=" << cancel_new.messages
+              << " amend=" << amend.messages << " tolerant=" << tolerant.messages
+              << " baseline=" << amend.baseline << ")\n";
+}
+
+// 7. An amend the engine rejects (a price off the tick ladder) leaves the order
+// resting; the market maker must cancel it rather than forget it
+void test_rejected_amend_leaves_no_orphan() {
+    SimulationConfig config;
+    config.seed = 7;
+    config.latency_ms = 0;
+    config.quiet = true;
+    config.ladder_half_width_ticks = 20000;  // the mid walks off it within a few events
+
+    RiskConfig risk_cfg;
+    risk_cfg.max_net_position = 1000000;
+    risk_cfg.max_notional_exposure = 1e12;
+    risk_cfg.max_drawdown = 1e12;
+
+    MarketSimulator simulator(config);
+    MarketMaker mm(risk_cfg, std::make_unique<HeuristicStrategy>(), RequoteConfig{});
+
+    int quoted = 0;
+    int off_ladder = 0;
+    std::cout.setstate(std::ios::failbit);
+    for (int i = 0; i < 2000; ++i) {
+        MarketDataEvent md = simulator.generate_event();
+        mm.on_market_data(md, simulator);
+        const std::size_t tracked = mm.get_active_order_count();
+        assert(simulator.get_matching_engine().resting_order_count() == tracked);
+        quoted += tracked == 2;
+        off_ladder += tracked == 0;
+    }
+    std::cout.clear();
+
+    // Both sides rested first, then the quotes left the ladder
+    assert(quoted > 0 && off_ladder > 0);
+    std::cout << "PASS: test_rejected_amend_leaves_no_orphan (" << off_ladder << " events off the ladder)\n";
+}
+
+} // namespace
+
+int main() {
+    test_no_live_order_sends_new();
+    test_unchanged_quote_sends_nothing();
+    test_tolerances();
+    test_min_quote_lifetime();
+    test_amend_disabled();
+    test_market_maker_message_reduction();
+    test_rejected_amend_leaves_no_orphan();
+
+    std::cout << "\nAll requote tests passed.\n";
+    return 0;
+}
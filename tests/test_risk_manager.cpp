@@ -24,13 +24,13 @@ time_point offset_ms(int ms) {
 
 MarketDataEvent make_md(double bid, double ask, time_point ts, int64_t seq = 1) {
     MarketDataEvent md;
-    md.instrument = "TEST";
-    md.best_bid_price = bid;
-    md.best_ask_price = ask;
+    md.instrument_id = InstrumentRegistry::global().intern("TEST");
+    md.best_bid_price = to_ticks(bid);
+    md.best_ask_price = to_ticks(ask);
     md.best_bid_size = 100;
     md.best_ask_size = 100;
-    md.bid_levels.emplace_back(bid, 100, 1ULL, ts);
-    md.ask_levels.emplace_back(ask, 100, 2ULL, ts);
+    md.bid_levels.emplace_back(to_ticks(bid), 100, 1ULL, ts);
+    md.ask_levels.emplace_back(to_ticks(ask), 100, 2ULL, ts);
     md.timestamp = ts;
     md.sequence_number = seq;
     return md;
@@ -416,6 +416,60 @@ void test_is_quoting_allowed_integration() {
     std::cout << "PASS: test_is_quoting_allowed_integration\n";
 }
 
+// ============================================================
+// Message accounting (2)
+// ============================================================
+
+// 22. A replace counts once against the quote rate and not as a cancel
+void test_replace_counts_as_one_message() {
+    RiskConfig cfg;
+    cfg.max_quotes_per_second = 10.0;
+    cfg.max_cancels_per_second = 1.0;
+    cfg.rate_window_seconds = 1.0;
+    RiskManager rm(cfg);
+    Accounting acct(100000.0);
+    auto ts = base_time();
+    // 5 replaces -> quote rate 5/10 = 0.5, cancel rate 0 -> Normal
+    for (int i = 0; i < 5; ++i)
+        rm.record_replace(ts);
+    auto md = make_md(100.0, 100.10, ts);
+    assert(rm.evaluate(acct, md, 100.05) == RiskState::Normal);
+    for (const auto& r : rm.last_results()) {
+        if (r.rule_id == RiskRuleId::MaxQuoteRate) assert(near(r.current_value, 5.0));
+        if (r.rule_id == RiskRuleId::MaxCancelRate) assert(near(r.current_value, 0.0));
+    }
+    std::cout << "PASS: test_replace_counts_as_one_message\n";
+}
+
+// 23. Batched counts weigh the same as individual records and expire together
+void test_batched_quote_counts() {
+    RiskConfig cfg;
+    cfg.max_quotes_per_second = 5.0;
+    cfg.max_cancels_per_second = 5.0;
+    cfg.rate_window_seconds = 1.0;
+    RiskManager rm(cfg);
+    Accounting acct(100000.0);
+
+    rm.record_quote(base_time(), 3);
+    rm.record_quote(base_time(), 2);
+    rm.record_cancel(base_time(), 4);
+    auto md = make_md(100.0, 100.10, base_time());
+    assert(rm.evaluate(acct, md, 100.05) == RiskState::Breached);
+    for (const auto& r : rm.last_results()) {
+        if (r.rule_id == RiskRuleId::MaxQuoteRate) assert(near(r.current_value, 5.0));
+        if (r.rule_id == RiskRuleId::MaxCancelRate) assert(near(r.current_value, 4.0));
+    }
+
+    // After the window passes the whole batch expires at once
+    auto md2 = make_md(100.0, 100.10, offset_ms(1500), 2);
+    rm.evaluate(acct, md2, 100.05);
+    for (const auto& r : rm.last_results()) {
+        if (r.rule_id == RiskRuleId::MaxQuoteRate) assert(near(r.current_value, 0.0));
+        if (r.rule_id == RiskRuleId::MaxCancelRate) assert(near(r.current_value, 0.0));
+    }
+    std::cout << "PASS: test_batched_quote_counts\n";
+}
+
 } // namespace
 
 int main() {
@@ -450,6 +504,10 @@ int main() {
     // Integration (1)
     test_is_quoting_allowed_integration();
 
-    std::cout << "\nAll 21 risk manager tests passed!\n";
+    // Message accounting (2)
+    test_replace_counts_as_one_message();
+    test_batched_quote_counts();
+
+    std::cout << "\nAll 23 risk manager tests passed!\n";
     return 0;
 }
@@ -27,8 +27,8 @@ StrategySnapshot make_snap(double mid, int position = 0, int max_pos = 1000) {
     snap.best_bid = mid - 0.05;
     snap.best_ask = mid + 0.05;
     snap.mid_price = mid;
-    snap.bid_levels.emplace_back(mid - 0.05, 100, 1ULL, base_time());
-    snap.ask_levels.emplace_back(mid + 0.05, 100, 2ULL, base_time());
+    snap.bid_levels.emplace_back(to_ticks(mid - 0.05), 100, 1ULL, base_time());
+    snap.ask_levels.emplace_back(to_ticks(mid + 0.05), 100, 2ULL, base_time());
     snap.position = position;
     snap.max_position = max_pos;
     snap.timestamp = base_time();
@@ -39,7 +39,7 @@ StrategySnapshot make_snap(double mid, int position = 0, int max_pos = 1000) {
 Trade make_trade(Side side, double price, int size) {
     Trade t;
     t.aggressor_side = side;
-    t.price = price;
+    t.price = to_ticks(price);
     t.size = size;
     t.trade_id = 100;
     t.timestamp = base_time();